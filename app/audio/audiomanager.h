@@ -57,6 +57,14 @@ public:
 
   void PushToOutput(const QByteArray& samples);
 
+  /**
+   * @brief Audio that has been pulled from a device by the output, for use in meters
+   */
+  const AudioRingBuffer* GetMeterBuffer() const
+  {
+    return output_manager_->meter_buffer();
+  }
+
   /**
    * @brief Start playing audio from AudioPlaybackCache
    */
@@ -0,0 +1,106 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "audioringbuffer.h"
+
+#include <atomic>
+#include <QtMath>
+
+namespace olive {
+
+AudioRingBuffer::AudioRingBuffer(int capacity) :
+  write_pos_(0),
+  reserve_pos_(0)
+{
+  buffer_.resize(qNextPowerOfTwo(quint32(capacity - 1)));
+  buffer_.fill(0);
+  mask_ = buffer_.size() - 1;
+}
+
+void AudioRingBuffer::Write(const char *data, qint64 length)
+{
+  qint64 capacity = buffer_.size();
+  qint64 pos = write_pos_.load();
+
+  if (length > capacity) {
+    // Only the end of this data would survive anyway
+    data += length - capacity;
+    pos += length - capacity;
+    length = capacity;
+  }
+
+  // Let readers know which bytes are about to change before we touch any of them
+  reserve_pos_.store(pos + length);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  qint64 start = pos & mask_;
+  qint64 first_length = qMin(length, capacity - start);
+
+  memcpy(buffer_.data() + start, data, first_length);
+  memcpy(buffer_.data(), data + first_length, length - first_length);
+
+  write_pos_.storeRelease(pos + length);
+}
+
+QByteArray AudioRingBuffer::Read(qint64 *read_pos, int alignment) const
+{
+  alignment = qMax(1, alignment);
+
+  qint64 capacity = buffer_.size();
+  qint64 end = write_pos_.loadAcquire();
+  qint64 start = *read_pos;
+
+  if (start > end) {
+    // Reader is ahead of us (shouldn't happen), resynchronize
+    start = end;
+  }
+
+  if (end - start > capacity) {
+    // Reader was overrun, skip to the oldest aligned data we still have
+    qint64 available = capacity - capacity % alignment;
+    start = end - available;
+  }
+
+  qint64 length = end - start;
+  QByteArray data(length, Qt::Uninitialized);
+
+  qint64 offset = start & mask_;
+  qint64 first_length = qMin(length, capacity - offset);
+
+  memcpy(data.data(), buffer_.constData() + offset, first_length);
+  memcpy(data.data() + first_length, buffer_.constData(), length - first_length);
+
+  // The writer may have lapped us while we were copying, discard anything it wrote over or was
+  // in the middle of writing over. The writer publishes its range before copying, so checking the
+  // reservation after our copy covers writes that hadn't finished yet.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  qint64 end_after_copy = reserve_pos_.load();
+  qint64 overwritten = end_after_copy - capacity - start;
+  if (overwritten > 0) {
+    overwritten += (alignment - overwritten % alignment) % alignment;
+    data.remove(0, qMin(length, overwritten));
+  }
+
+  *read_pos = end;
+
+  return data;
+}
+
+}
@@ -0,0 +1,91 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef AUDIORINGBUFFER_H
+#define AUDIORINGBUFFER_H
+
+#include <QAtomicInteger>
+#include <QByteArray>
+
+namespace olive {
+
+/**
+ * @brief Lock-free ring buffer with a single writer and any number of readers
+ *
+ * Used to share the audio that was actually sent to the output device with other parts of the
+ * application (e.g. meters) without them having to read it from the cache a second time.
+ *
+ * The writer never waits for readers. Each reader keeps its own read position, and a reader that
+ * falls more than one buffer behind simply loses the oldest data, which is acceptable for
+ * visualization.
+ */
+class AudioRingBuffer
+{
+public:
+  /**
+   * @brief Construct a ring buffer
+   *
+   * @param capacity
+   *
+   * Size of the buffer in bytes, rounded up to a power of two.
+   */
+  AudioRingBuffer(int capacity);
+
+  /**
+   * @brief Append data to the buffer
+   *
+   * Must only be called from one thread at a time.
+   */
+  void Write(const char* data, qint64 length);
+
+  /**
+   * @brief Total amount of bytes ever written to this buffer
+   *
+   * Readers can store this to start reading from "now".
+   */
+  qint64 GetWritePosition() const
+  {
+    return write_pos_.loadAcquire();
+  }
+
+  /**
+   * @brief Read everything written since `read_pos` and advance it
+   *
+   * This function is thread safe. If the reader has been overrun, only the newest data still in the
+   * buffer is returned. The returned data always starts at a multiple of `alignment` bytes from the
+   * write position so that reads stay sample aligned.
+   */
+  QByteArray Read(qint64* read_pos, int alignment) const;
+
+private:
+  QByteArray buffer_;
+
+  qint64 mask_;
+
+  QAtomicInteger<qint64> write_pos_;
+
+  /// Where the write currently in progress will end, published before its data is copied in
+  QAtomicInteger<qint64> reserve_pos_;
+
+};
+
+}
+
+#endif // AUDIORINGBUFFER_H
@@ -28,9 +28,22 @@ namespace olive {
 
 const int AudioVisualWaveform::kSumSampleRate = 200;
 
+rational AudioVisualWaveform::length() const
+{
+  if (!channels_) {
+    return 0;
+  }
+
+  return rational(data_.size() / channels_, kSumSampleRate);
+}
+
 void AudioVisualWaveform::AddSum(const float *samples, int nb_samples, int nb_channels)
 {
+  int old_size = data_.size();
+
   data_.append(SumSamples(samples, nb_samples, nb_channels));
+
+  UpdateMipmaps(old_size, data_.size());
 }
 
 void AudioVisualWaveform::OverwriteSamples(SampleBufferPtr samples, int sample_rate, const rational &start)
@@ -44,6 +57,7 @@ void AudioVisualWaveform::OverwriteSamples(SampleBufferPtr samples, int sample_r
   int samples_length = time_to_samples(static_cast<double>(samples->sample_count()) / static_cast<double>(sample_rate));
 
   int end_index = start_index + samples_length;
+  int old_size = data_.size();
   if (data_.size() < end_index) {
     data_.resize(end_index);
   }
@@ -61,6 +75,8 @@ void AudioVisualWaveform::OverwriteSamples(SampleBufferPtr samples, int sample_r
         summary.constData(),
         summary.size() * sizeof(SamplePerChannel));
   }
+
+  UpdateMipmaps(qMin(old_size, start_index), end_index);
 }
 
 void AudioVisualWaveform::OverwriteSums(const AudioVisualWaveform &sums, const rational &dest, const rational& offset, const rational& length)
@@ -78,6 +94,7 @@ void AudioVisualWaveform::OverwriteSums(const AudioVisualWaveform &sums, const r
   }
 
   int end_index = start_index + copy_len;
+  int old_size = data_.size();
 
   if (data_.size() < end_index) {
     data_.resize(end_index);
@@ -86,6 +103,25 @@ void AudioVisualWaveform::OverwriteSums(const AudioVisualWaveform &sums, const r
   memcpy(reinterpret_cast<char*>(data_.data()) + start_index * sizeof(SamplePerChannel),
          reinterpret_cast<const char*>(sums.data_.constData()) + time_to_samples(offset) * sizeof(SamplePerChannel),
          copy_len * sizeof(SamplePerChannel));
+
+  UpdateMipmaps(qMin(old_size, start_index), end_index);
+}
+
+void AudioVisualWaveform::OverwriteSilence(const rational &start, const rational &length)
+{
+  int start_index = time_to_samples(start);
+  int end_index = start_index + time_to_samples(length);
+  int old_size = data_.size();
+
+  if (data_.size() < end_index) {
+    data_.resize(end_index);
+  }
+
+  memset(reinterpret_cast<char*>(data_.data()) + start_index * sizeof(SamplePerChannel),
+         0,
+         (end_index - start_index) * sizeof(SamplePerChannel));
+
+  UpdateMipmaps(qMin(old_size, start_index), end_index);
 }
 
 AudioVisualWaveform AudioVisualWaveform::Mid(const rational &time) const
@@ -95,23 +131,32 @@ AudioVisualWaveform AudioVisualWaveform::Mid(const rational &time) const
   // Create a copy of this waveform chop the early section off
   AudioVisualWaveform copy = *this;
   copy.data_ = data_.mid(sample_index);
+  copy.RegenerateMipmaps();
 
   return copy;
 }
 
 void AudioVisualWaveform::Append(const AudioVisualWaveform &waveform)
 {
+  int old_size = data_.size();
+
   data_.append(waveform.data_);
+
+  UpdateMipmaps(old_size, data_.size());
 }
 
 void AudioVisualWaveform::TrimIn(const rational &time)
 {
   data_ = data_.mid(time_to_samples(time));
+
+  RegenerateMipmaps();
 }
 
 void AudioVisualWaveform::TrimOut(const rational &time)
 {
   data_.resize(data_.size() - time_to_samples(time));
+
+  UpdateMipmaps(data_.size(), data_.size());
 }
 
 void AudioVisualWaveform::PrependSilence(const rational &time)
@@ -128,6 +173,8 @@ void AudioVisualWaveform::PrependSilence(const rational &time)
 
   // Fill remainder with silence
   memset(reinterpret_cast<char*>(data_.data()), 0, added_samples * sizeof(SamplePerChannel));
+
+  RegenerateMipmaps();
 }
 
 void AudioVisualWaveform::AppendSilence(const rational &time)
@@ -140,6 +187,8 @@ void AudioVisualWaveform::AppendSilence(const rational &time)
 
   // Fill remainder with silence
   memset(reinterpret_cast<char*>(&data_[old_size]), 0, (data_.size() - old_size) * sizeof(SamplePerChannel));
+
+  UpdateMipmaps(old_size, data_.size());
 }
 
 void AudioVisualWaveform::Shift(const rational &from, const rational &to)
@@ -180,6 +229,9 @@ void AudioVisualWaveform::Shift(const rational &from, const rational &to)
 
     memset(reinterpret_cast<char*>(&data_[from_index]), 0, distance * sizeof(SamplePerChannel));
   }
+
+  // Everything after the earliest point has moved
+  UpdateMipmaps(qMin(from_index, to_index), data_.size());
 }
 
 QVector<AudioVisualWaveform::SamplePerChannel> AudioVisualWaveform::SumSamples(const float *samples, int nb_samples, int nb_channels)
@@ -261,9 +313,25 @@ void AudioVisualWaveform::DrawSample(QPainter *painter, const QVector<SamplePerC
 
 void AudioVisualWaveform::DrawWaveform(QPainter *painter, const QRect& rect, const double& scale, const AudioVisualWaveform &samples, const rational& start_time)
 {
-  int start_sample_index = samples.time_to_samples(start_time);
+  int nb_channels = samples.channel_count();
 
-  if (start_sample_index >= samples.nb_samples()) {
+  if (!nb_channels) {
+    return;
+  }
+
+  // Pick the coarsest level that still has at least one summary per pixel
+  double summaries_per_pixel = static_cast<double>(kSumSampleRate) / scale;
+  int level = 0;
+  while (level < samples.mipmaps_.size() && (1 << (level + 1)) <= summaries_per_pixel) {
+    level++;
+  }
+
+  const QVector<SamplePerChannel>& data = (level == 0) ? samples.data_ : samples.mipmaps_.at(level - 1);
+  double level_rate = static_cast<double>(kSumSampleRate) / static_cast<double>(1 << level);
+
+  int start_sample_index = qFloor(start_time.toDouble() * level_rate) * nb_channels;
+
+  if (start_sample_index >= data.size()) {
     return;
   }
 
@@ -282,17 +350,17 @@ void AudioVisualWaveform::DrawWaveform(QPainter *painter, const QRect& rect, con
   for (int i=start;i<end;i++) {
     sample_index = next_sample_index;
 
-    if (sample_index == samples.nb_samples()) {
+    if (sample_index == data.size()) {
       break;
     }
 
-    next_sample_index = qMin(samples.nb_samples(),
-                             start_sample_index + qFloor(static_cast<double>(kSumSampleRate) * static_cast<double>(i - rect.x() + 1) / scale) * samples.channel_count());
+    next_sample_index = qMin(data.size(),
+                             start_sample_index + qFloor(level_rate * static_cast<double>(i - rect.x() + 1) / scale) * nb_channels);
 
     if (summary_index != sample_index) {
-      summary = AudioVisualWaveform::ReSumSamples(&samples.data_.at(sample_index),
-                                                  qMax(samples.channel_count(), next_sample_index - sample_index),
-                                                  samples.channel_count());
+      summary = AudioVisualWaveform::ReSumSamples(&data.at(sample_index),
+                                                  qMax(nb_channels, next_sample_index - sample_index),
+                                                  nb_channels);
       summary_index = sample_index;
     }
 
@@ -310,6 +378,71 @@ int AudioVisualWaveform::time_to_samples(const double &time) const
   return qFloor(time * kSumSampleRate) * channels_;
 }
 
+void AudioVisualWaveform::UpdateMipmaps(int start, int end)
+{
+  if (!channels_) {
+    return;
+  }
+
+  const SamplePerChannel* src = data_.constData();
+  int src_frames = data_.size() / channels_;
+  int start_frame = start / channels_;
+  int end_frame = (end + channels_ - 1) / channels_;
+
+  int level = 0;
+
+  while (src_frames > 1) {
+    int dst_frames = (src_frames + 1) / 2;
+
+    if (level == mipmaps_.size()) {
+      mipmaps_.append(QVector<SamplePerChannel>());
+    }
+
+    QVector<SamplePerChannel>& dst = mipmaps_[level];
+    dst.resize(dst_frames * channels_);
+
+    // Each summary in this level covers two in the level below
+    start_frame /= 2;
+    end_frame = qMin(dst_frames, (end_frame + 1) / 2);
+
+    ReduceLevel(src, src_frames, dst.data(), start_frame, end_frame, channels_);
+
+    src = dst.constData();
+    src_frames = dst_frames;
+    level++;
+  }
+
+  // Remove any levels that are no longer necessary
+  mipmaps_.resize(level);
+}
+
+void AudioVisualWaveform::RegenerateMipmaps()
+{
+  mipmaps_.clear();
+
+  UpdateMipmaps(0, data_.size());
+}
+
+void AudioVisualWaveform::ReduceLevel(const SamplePerChannel *src, int src_frames, SamplePerChannel *dst, int start_frame, int end_frame, int nb_channels)
+{
+  for (int i=start_frame; i<end_frame; i++) {
+    const SamplePerChannel* a = src + 2 * i * nb_channels;
+    SamplePerChannel* d = dst + i * nb_channels;
+
+    if (2 * i + 1 < src_frames) {
+      const SamplePerChannel* b = a + nb_channels;
+
+      for (int j=0; j<nb_channels; j++) {
+        d[j].min = qMin(a[j].min, b[j].min);
+        d[j].max = qMax(a[j].max, b[j].max);
+      }
+    } else {
+      // Odd frame out at the end of the level
+      memcpy(d, a, nb_channels * sizeof(SamplePerChannel));
+    }
+  }
+}
+
 template<typename T>
 QVector<AudioVisualWaveform::SamplePerChannel> AudioVisualWaveform::SumSamplesInternal(const T *samples, int nb_samples, int nb_channels)
 {
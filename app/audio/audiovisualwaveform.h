@@ -34,6 +34,11 @@ namespace olive {
  *
  * This differs from a SampleBuffer as the data in an AudioVisualWaveform has been reduced
  * significantly and optimized for visual display.
+ *
+ * Alongside the base summary at kSumSampleRate, a pyramid of mipmaps is kept where each level
+ * halves the rate of the one before it. Drawing picks whichever level is closest to one summary
+ * per pixel so the amount of work is proportional to the width drawn rather than the length of
+ * the audio.
  */
 class AudioVisualWaveform {
 public:
@@ -66,10 +71,24 @@ public:
     return data_.constData();
   }
 
+  /**
+   * @brief Number of mipmap levels above the base summary
+   */
+  int mipmap_count() const
+  {
+    return mipmaps_.size();
+  }
+
+  /**
+   * @brief Length of the audio this waveform represents
+   */
+  rational length() const;
+
   void AddSum(const float* samples, int nb_samples, int nb_channels);
 
   void OverwriteSamples(SampleBufferPtr samples, int sample_rate, const rational& start = rational());
   void OverwriteSums(const AudioVisualWaveform& sums, const rational& dest, const rational& offset = rational(), const rational &length = rational());
+  void OverwriteSilence(const rational& start, const rational& length);
 
   AudioVisualWaveform Mid(const rational& time) const;
   void Append(const AudioVisualWaveform& waveform);
@@ -102,10 +121,24 @@ private:
   int time_to_samples(const rational& time) const;
   int time_to_samples(const double& time) const;
 
+  /**
+   * @brief Re-sum mipmaps covering a range of the base summary
+   *
+   * `start` and `end` are indices into `data_`. All levels are also resized to match the base, so
+   * this must be called after anything changes the size of `data_`.
+   */
+  void UpdateMipmaps(int start, int end);
+
+  void RegenerateMipmaps();
+
+  static void ReduceLevel(const SamplePerChannel* src, int src_frames, SamplePerChannel* dst, int start_frame, int end_frame, int nb_channels);
+
   int channels_ = 0;
 
   QVector<SamplePerChannel> data_;
 
+  QVector< QVector<SamplePerChannel> > mipmaps_;
+
 };
 
 }
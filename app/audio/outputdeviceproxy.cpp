@@ -24,9 +24,13 @@
 
 namespace olive {
 
+// Enough for a couple of seconds of stereo float audio, meters read it far more often than that
+const int kMeterBufferSize = 1048576;
+
 AudioOutputDeviceProxy::AudioOutputDeviceProxy(QObject *parent) :
   QIODevice(parent),
-  device_(nullptr)
+  device_(nullptr),
+  meter_buffer_(kMeterBufferSize)
 {
 }
 
@@ -97,6 +101,11 @@ qint64 AudioOutputDeviceProxy::readData(char *data, qint64 maxlen)
     read_count = ReverseAwareRead(data, maxlen);
   }
 
+  if (read_count > 0) {
+    // Share exactly what we're about to play with the meters
+    meter_buffer_.Write(data, read_count);
+  }
+
   return read_count;
 }
 
@@ -23,6 +23,7 @@
 
 #include <QFile>
 
+#include "audioringbuffer.h"
 #include "common/define.h"
 #include "tempoprocessor.h"
 
@@ -43,6 +44,16 @@ public:
 
   virtual void close() override;
 
+  /**
+   * @brief Buffer containing all audio that has been sent to the output
+   *
+   * Readable from any thread.
+   */
+  const AudioRingBuffer* meter_buffer() const
+  {
+    return &meter_buffer_;
+  }
+
 protected:
   virtual qint64 readData(char *data, qint64 maxlen) override;
 
@@ -59,6 +70,8 @@ private:
 
   int playback_speed_;
 
+  AudioRingBuffer meter_buffer_;
+
 };
 
 }
@@ -43,6 +43,12 @@ public:
   // Thread-safe
   void Push(const QByteArray &samples);
 
+  // Thread-safe
+  const AudioRingBuffer* meter_buffer() const
+  {
+    return device_proxy_.meter_buffer();
+  }
+
 public slots:
   // Queued
   void SetOutputDevice(QAudioDeviceInfo info, QAudioFormat format);
@@ -209,7 +209,7 @@ int TempoProcessor::Pull(char *data, int max_length)
     if (ret < 0) {
       // We couldn't pull for some reason, if the error was EAGAIN, we just need to send more samples. Otherwise the
       // error might be fatal...
-      if (ret != AVERROR(EAGAIN)) {
+      if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
         qCritical() << "Failed to pull from buffersink" << ret;
       }
 
@@ -34,17 +34,21 @@
 #ifdef USE_OTIO
 #include "task/project/loadotio/loadotio.h"
 #endif
+#include "task/conform/conform.h"
 #include "task/taskmanager.h"
 #include "project/project.h"
 
 namespace olive {
 
 QMutex Decoder::currently_conforming_mutex_;
-QWaitCondition Decoder::currently_conforming_wait_cond_;
 QVector<Decoder::CurrentlyConforming> Decoder::currently_conforming_;
+QVector<Decoder::CurrentlyConforming> Decoder::failed_conforms_;
+QHash<QString, qint64> Decoder::conform_progress_;
+QAtomicInt Decoder::proxy_revision_;
 
 Decoder::Decoder() :
-  stream_(nullptr)
+  stream_(nullptr),
+  conform_data_(nullptr)
 {
 }
 
@@ -133,46 +137,175 @@ SampleBufferPtr Decoder::RetrieveAudio(const TimeRange &range, const AudioParams
   QString conform_filename = GetConformedFilename(params);
   CurrentlyConforming want_conform = {stream_, params};
 
-  currently_conforming_mutex_.lock();
+  // See if we have the conform
+  SampleBufferPtr buffer = RetrieveAudioFromConform(conform_filename, range);
 
-  // Wait for conform to complete
-  while (currently_conforming_.contains(want_conform)) {
-    currently_conforming_wait_cond_.wait(&currently_conforming_mutex_);
-  }
+  if (!buffer) {
+    // Only hold the lock long enough to check on running conforms, reading happens outside it
+    currently_conforming_mutex_.lock();
+    qint64 conform_progress = conform_progress_.value(conform_filename, -1);
+    currently_conforming_mutex_.unlock();
 
-  // See if we got the conform
-  SampleBufferPtr buffer = RetrieveAudioFromConform(conform_filename, range);
+    if (conform_progress > 0) {
+      // See if a running conform has already reached this range
+      buffer = RetrieveAudioFromPartialConform(conform_filename, conform_progress, range, params);
+    }
+  }
 
   if (!buffer) {
-    // We'll need to conform this ourselves
-    currently_conforming_.append(want_conform);
+    currently_conforming_mutex_.lock();
+
+    if (!currently_conforming_.contains(want_conform)
+        && !failed_conforms_.contains(want_conform)
+        && !QFileInfo::exists(conform_filename)) {
+      // Nothing is conforming this yet, start it in the background
+      currently_conforming_.append(want_conform);
+      StartConformTask(params);
+    }
+
     currently_conforming_mutex_.unlock();
 
-    // We conform to a different filename until it's done to make it clear even across sessions
-    // whether this conform is ready or not
-    QString working_fn = conform_filename;
-    working_fn.append(QStringLiteral(".working"));
+    // Rather than wait for the conform, decode just the audio we need right now
+    buffer = DecodeAudioRangeInternal(range, params, cancelled);
+  }
+
+  return buffer;
+}
+
+bool Decoder::ConformAudio(const AudioParams &params, const QAtomicInt *cancelled)
+{
+  QMutexLocker locker(&mutex_);
+
+  if (!stream_) {
+    qCritical() << "Can't conform audio on a closed decoder";
+    return false;
+  }
+
+  if (!SupportsAudio()) {
+    qCritical() << "Decoder doesn't support audio";
+    return false;
+  }
+
+  if (stream_->type() != Stream::kAudio) {
+    qCritical() << "Tried to conform audio from a non-audio stream";
+    return false;
+  }
+
+  QString conform_filename = GetConformedFilename(params);
+  CurrentlyConforming want_conform = {stream_, params};
+
+  if (QFileInfo::exists(conform_filename)) {
+    // Already conformed
+    QMutexLocker conform_locker(&currently_conforming_mutex_);
+    currently_conforming_.removeOne(want_conform);
+    return true;
+  }
+
+  // We conform to a different filename until it's done to make it clear even across sessions
+  // whether this conform is ready or not
+  QString working_fn = GetWorkingFilename(conform_filename);
+  QString progress_fn = GetProgressFilename(conform_filename);
+
+  // See if we can pick up from a previous attempt
+  qint64 resume_from = 0;
+
+  if (QFileInfo::exists(working_fn)) {
+    QFile progress_file(progress_fn);
 
-    if (ConformAudioInternal(working_fn, params, cancelled)) {
-      // Move file to standard conform name, making it clear this conform is ready for use
-      QFile::remove(conform_filename);
-      QFile::rename(working_fn, conform_filename);
+    if (progress_file.open(QFile::ReadOnly)) {
+      resume_from = qMax(qint64(0), progress_file.readAll().trimmed().toLongLong());
 
-      // Return audio as planned
-      buffer = RetrieveAudioFromConform(conform_filename, range);
+      // Only resume on whole samples
+      resume_from -= resume_from % params.samples_to_bytes(1);
+
+      progress_file.close();
+    }
+  }
+
+  currently_conforming_mutex_.lock();
+  if (!currently_conforming_.contains(want_conform)) {
+    currently_conforming_.append(want_conform);
+  }
+  conform_progress_.insert(conform_filename, resume_from);
+  currently_conforming_mutex_.unlock();
+
+  conforming_filename_ = conform_filename;
+
+  bool success = ConformAudioInternal(working_fn, params, resume_from, cancelled);
+
+  conforming_filename_.clear();
+
+  currently_conforming_mutex_.lock();
+
+  if (success) {
+    // Move file to standard conform name, making it clear this conform is ready for use
+    QFile::remove(conform_filename);
+    QFile::rename(working_fn, conform_filename);
+    QFile::remove(progress_fn);
+  } else {
+    if (cancelled && *cancelled) {
+      // The working file and its progress are kept, so the next RetrieveAudio() starts the conform
+      // again and it resumes from there
     } else {
-      // Failed
       qCritical() << "Failed to conform audio";
-    }
 
-    currently_conforming_mutex_.lock();
-    currently_conforming_.removeOne(want_conform);
-    currently_conforming_wait_cond_.wakeAll();
+      // Don't keep restarting a conform that failed, RetrieveAudio() will keep decoding directly
+      // instead
+      failed_conforms_.append(want_conform);
+    }
   }
 
+  conform_progress_.remove(conform_filename);
+  currently_conforming_.removeOne(want_conform);
+
   currently_conforming_mutex_.unlock();
 
-  return buffer;
+  return success;
+}
+
+bool Decoder::GenerateProxy(int divider, const QAtomicInt *cancelled)
+{
+  QMutexLocker locker(&mutex_);
+
+  if (!stream_) {
+    qCritical() << "Can't generate proxy on a closed decoder";
+    return false;
+  }
+
+  if (!SupportsVideo()) {
+    qCritical() << "Decoder doesn't support video";
+    return false;
+  }
+
+  if (stream_->type() != Stream::kVideo) {
+    qCritical() << "Tried to generate proxy from a non-video stream";
+    return false;
+  }
+
+  if (divider <= 1) {
+    qCritical() << "Tried to generate proxy with an invalid divider:" << divider;
+    return false;
+  }
+
+  // Like conforms, proxies are written to a different filename until they're complete so a
+  // partial proxy is never picked up by a decoder
+  QString proxy_filename = GetProxyFilename(divider);
+  QString working_fn = proxy_filename;
+  working_fn.append(QStringLiteral(".working"));
+
+  if (GenerateProxyInternal(working_fn, divider, cancelled)) {
+    QFile::remove(proxy_filename);
+    QFile::rename(working_fn, proxy_filename);
+
+    // Signal any open decoders that a new proxy is available
+    proxy_revision_.fetchAndAddOrdered(1);
+
+    return true;
+  } else {
+    QFile::remove(working_fn);
+
+    return false;
+  }
 }
 
 void Decoder::Close()
@@ -180,6 +313,7 @@ void Decoder::Close()
   QMutexLocker locker(&mutex_);
 
   if (stream_) {
+    CloseConform();
     CloseInternal();
     stream_ = nullptr;
   } else {
@@ -289,6 +423,35 @@ QString Decoder::GetIndexFilename()
   return QDir(stream_->footage()->project()->cache_path()).filePath(FileFunctions::GetUniqueFileIdentifier(stream()->footage()->filename()).append(QString::number(stream()->index())));
 }
 
+QString Decoder::GetProxyFilename(int divider)
+{
+  QString index_fn = GetIndexFilename();
+
+  index_fn.append(QStringLiteral(".proxy."));
+  index_fn.append(QString::number(divider));
+
+  return index_fn;
+}
+
+int Decoder::FindProxy(int divider, QString *filename)
+{
+  // Prefer the smallest proxy we can, since it'll be the fastest to decode
+  for (int i=VideoParams::kSupportedDividers.size()-1; i>=0; i--) {
+    int proxy_divider = VideoParams::kSupportedDividers.at(i);
+
+    if (proxy_divider > 1 && proxy_divider <= divider) {
+      QString proxy_fn = GetProxyFilename(proxy_divider);
+
+      if (QFileInfo::exists(proxy_fn)) {
+        *filename = proxy_fn;
+        return proxy_divider;
+      }
+    }
+  }
+
+  return 0;
+}
+
 void Decoder::SignalProcessingProgress(const int64_t &ts)
 {
   if (stream()->duration() != AV_NOPTS_VALUE && stream()->duration() != 0) {
@@ -296,6 +459,24 @@ void Decoder::SignalProcessingProgress(const int64_t &ts)
   }
 }
 
+void Decoder::SignalConformChunk(qint64 bytes)
+{
+  if (conforming_filename_.isEmpty()) {
+    return;
+  }
+
+  // Record progress on disk first so a resumed conform never trusts more than was written
+  QFile progress_file(GetProgressFilename(conforming_filename_));
+
+  if (progress_file.open(QFile::WriteOnly | QFile::Truncate)) {
+    progress_file.write(QByteArray::number(bytes));
+    progress_file.close();
+  }
+
+  QMutexLocker locker(&currently_conforming_mutex_);
+  conform_progress_.insert(conforming_filename_, bytes);
+}
+
 QString Decoder::TransformImageSequenceFileName(const QString &filename, const int64_t& number)
 {
   int digit_count = GetImageSequenceDigitCount(filename);
@@ -348,33 +529,130 @@ FramePtr Decoder::RetrieveVideoInternal(const rational &timecode, const int &div
   return nullptr;
 }
 
-bool Decoder::ConformAudioInternal(const QString& filename, const AudioParams &params, const QAtomicInt* cancelled)
+bool Decoder::ConformAudioInternal(const QString& filename, const AudioParams &params, qint64 resume_from, const QAtomicInt* cancelled)
 {
   Q_UNUSED(filename)
   Q_UNUSED(cancelled)
+  Q_UNUSED(resume_from)
+  Q_UNUSED(params)
+  return false;
+}
+
+SampleBufferPtr Decoder::DecodeAudioRangeInternal(const TimeRange &range, const AudioParams &params, const QAtomicInt *cancelled)
+{
+  Q_UNUSED(range)
   Q_UNUSED(params)
+  Q_UNUSED(cancelled)
+  return nullptr;
+}
+
+bool Decoder::GenerateProxyInternal(const QString &filename, int divider, const QAtomicInt *cancelled)
+{
+  Q_UNUSED(filename)
+  Q_UNUSED(divider)
+  Q_UNUSED(cancelled)
   return false;
 }
 
 SampleBufferPtr Decoder::RetrieveAudioFromConform(const QString &conform_filename, const TimeRange& range)
 {
-  WaveInput input(conform_filename);
+  if (conform_input_filename_ != conform_filename) {
+    CloseConform();
+
+    std::unique_ptr<WaveInput> input(new WaveInput(conform_filename));
+
+    if (!input->open()) {
+      return nullptr;
+    }
 
-  if (input.open()) {
-    const AudioParams& input_params = input.params();
+    // If mapping fails, we'll fall back to reading from the file
+    conform_data_ = input->map();
+    conform_input_ = std::move(input);
+    conform_input_filename_ = conform_filename;
+  }
+
+  const AudioParams& input_params = conform_input_->params();
+  qint64 data_length = conform_input_->data_length();
+
+  qint64 offset = qBound(qint64(0), input_params.time_to_bytes(range.in()), data_length);
+  qint64 length = qBound(qint64(0), input_params.time_to_bytes(range.length()), data_length - offset);
 
+  if (conform_data_) {
+    // Create sample buffer straight from the mapped file
+    return SampleBuffer::CreateFromPackedData(input_params,
+                                              conform_data_ + offset,
+                                              input_params.bytes_to_samples(length));
+  } else {
     // Read bytes from wav
-    QByteArray packed_data = input.read(input_params.time_to_bytes(range.in()),
-                                        input_params.time_to_bytes(range.length()));
-    input.close();
+    QByteArray packed_data = conform_input_->read(offset, length);
 
     // Create sample buffer
-    SampleBufferPtr sample_buffer = SampleBuffer::CreateFromPackedData(input_params, packed_data);
+    return SampleBuffer::CreateFromPackedData(input_params, packed_data);
+  }
+}
+
+SampleBufferPtr Decoder::RetrieveAudioFromPartialConform(const QString &conform_filename, qint64 conform_progress, const TimeRange &range, const AudioParams &params)
+{
+  qint64 offset = params.time_to_bytes(range.in());
+  qint64 length = params.time_to_bytes(range.length());
 
-    return sample_buffer;
+  if (offset < 0 || offset + length > conform_progress) {
+    // Conform hasn't reached this range yet
+    return nullptr;
   }
 
-  return nullptr;
+  QFile working_file(GetWorkingFilename(conform_filename));
+
+  if (!working_file.open(QFile::ReadOnly)) {
+    return nullptr;
+  }
+
+  working_file.seek(WaveOutput::kHeaderSize + offset);
+  QByteArray packed_data = working_file.read(length);
+  working_file.close();
+
+  if (packed_data.size() != length) {
+    return nullptr;
+  }
+
+  return SampleBuffer::CreateFromPackedData(params, packed_data);
+}
+
+void Decoder::StartConformTask(const AudioParams &params)
+{
+  TaskManager* manager = TaskManager::instance();
+
+  if (!manager) {
+    return;
+  }
+
+  ConformTask* conform_task = new ConformTask(static_cast<AudioStream*>(stream_), params);
+
+  // TaskManager lives on the main thread and will be the one deleting this task
+  conform_task->moveToThread(manager->thread());
+
+  QMetaObject::invokeMethod(manager,
+                            "AddTask",
+                            Qt::QueuedConnection,
+                            Q_ARG(Task*, conform_task));
+}
+
+QString Decoder::GetWorkingFilename(const QString &filename)
+{
+  return QStringLiteral("%1.working").arg(filename);
+}
+
+QString Decoder::GetProgressFilename(const QString &filename)
+{
+  return QStringLiteral("%1.progress").arg(filename);
+}
+
+void Decoder::CloseConform()
+{
+  // Closing the input also unmaps it
+  conform_input_.reset();
+  conform_input_filename_.clear();
+  conform_data_ = nullptr;
 }
 
 }
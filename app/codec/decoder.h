@@ -25,13 +25,14 @@ extern "C" {
 #include <libswresample/swresample.h>
 }
 
+#include <QHash>
 #include <QMutex>
 #include <QObject>
-#include <QWaitCondition>
 #include <stdint.h>
 
 #include "codec/frame.h"
 #include "codec/samplebuffer.h"
+#include "codec/waveinput.h"
 #include "codec/waveoutput.h"
 #include "common/rational.h"
 #include "project/item/footage/footage.h"
@@ -106,10 +107,37 @@ public:
    * This function will always return a sample buffer unless a fatal error occurs (in such case,
    * nullptr will return). The SampleBuffer should always have enough audio for the range provided.
    *
+   * Audio is read from a conform matching `params` if one exists. If not, a ConformTask is started
+   * in the background and this range is decoded directly from the media in the meantime, so the
+   * caller never has to wait for the whole stream to conform. Ranges that the running conform has
+   * already covered are read straight from it.
+   *
    * This function is thread safe and can only run while the decoder is open. \see Open()
    */
   SampleBufferPtr RetrieveAudio(const TimeRange& range, const AudioParams& params, const QAtomicInt *cancelled);
 
+  /**
+   * @brief Conform the open audio stream to a set of parameters in the project cache
+   *
+   * Conforms are written progressively. If a previous conform was interrupted (e.g. by cancelling
+   * or closing Olive), it's resumed from the last point known to have been written rather than
+   * started over.
+   *
+   * This function is thread safe and can only run while the decoder is open. \see Open()
+   */
+  bool ConformAudio(const AudioParams& params, const QAtomicInt* cancelled);
+
+  /**
+   * @brief Transcode the open video stream into a reduced resolution proxy in the project cache
+   *
+   * Proxies are intra-frame and stored at 1/divider of the stream's resolution. Once a proxy
+   * exists, decoders that support them will transparently decode from the proxy instead of the
+   * original media whenever the divider requested in RetrieveVideo() is equal or higher.
+   *
+   * This function is thread safe and can only run while the decoder is open. \see Open()
+   */
+  bool GenerateProxy(int divider, const QAtomicInt* cancelled);
+
   /**
    * @brief Try to probe a Footage file by passing it through all available Decoders
    *
@@ -197,10 +225,45 @@ protected:
    */
   virtual FramePtr RetrieveVideoInternal(const rational& timecode, const int& divider);
 
-  virtual bool ConformAudioInternal(const QString& filename, const AudioParams &params, const QAtomicInt* cancelled);
+  /**
+   * @brief Internal audio conform function
+   *
+   * Sub-classes must override this function IF they support audio. Function is already mutexed
+   * so sub-classes don't need to worry about thread safety.
+   *
+   * If `resume_from` is non-zero, `filename` already contains that many bytes of valid conformed
+   * audio and conforming should continue from there (\see WaveOutput::resume()). Sub-classes
+   * should call SignalConformChunk() periodically so the conform can be read before it's complete.
+   */
+  virtual bool ConformAudioInternal(const QString& filename, const AudioParams &params, qint64 resume_from, const QAtomicInt* cancelled);
+
+  /**
+   * @brief Internal direct audio decoding function
+   *
+   * Used while a conform isn't available yet. Sub-classes should decode and resample only the
+   * audio in `range`. Function is already mutexed so sub-classes don't need to worry about thread
+   * safety.
+   */
+  virtual SampleBufferPtr DecodeAudioRangeInternal(const TimeRange& range, const AudioParams& params, const QAtomicInt* cancelled);
+
+  /**
+   * @brief Internal proxy generation function
+   *
+   * Sub-classes must override this function IF they support proxies. Function is already mutexed
+   * so sub-classes don't need to worry about thread safety.
+   */
+  virtual bool GenerateProxyInternal(const QString& filename, int divider, const QAtomicInt* cancelled);
 
   void SignalProcessingProgress(const int64_t& ts);
 
+  /**
+   * @brief Signal that the conform in progress has flushed `bytes` of audio data to disk
+   *
+   * Audio up to this point can be read by other decoders and the conform can be resumed from
+   * here if it's interrupted.
+   */
+  void SignalConformChunk(qint64 bytes);
+
   /**
    * @brief Get the destination filename of an audio stream conformed to a set of parameters
    */
@@ -208,6 +271,32 @@ protected:
 
   QString GetIndexFilename();
 
+  /**
+   * @brief Get the destination filename of a proxy of this stream at a given divider
+   */
+  QString GetProxyFilename(int divider);
+
+  /**
+   * @brief Find the smallest existing proxy that still satisfies a divider
+   *
+   * @return
+   *
+   * The divider of the proxy found (with its filename placed in `filename`), or 0 if no usable
+   * proxy exists and the original media should be used.
+   */
+  int FindProxy(int divider, QString* filename);
+
+  /**
+   * @brief Incremented every time a proxy is generated
+   *
+   * Open decoders can compare this against the value they last saw to know when it's worth
+   * checking the disk for new proxies.
+   */
+  static int GetProxyRevision()
+  {
+    return proxy_revision_.loadAcquire();
+  }
+
   struct CurrentlyConforming {
     Stream* stream;
     AudioParams params;
@@ -228,10 +317,31 @@ protected:
     return stream_;
   }
 
+  /**
+   * @brief Lock held by every thread safe function of this decoder
+   *
+   * Derivatives that do work in the background must hold it while touching any decoding state.
+   */
+  QMutex* mutex()
+  {
+    return &mutex_;
+  }
+
   static QMutex currently_conforming_mutex_;
-  static QWaitCondition currently_conforming_wait_cond_;
   static QVector<CurrentlyConforming> currently_conforming_;
 
+  /**
+   * @brief Conforms that failed this session, which won't be started again automatically
+   */
+  static QVector<CurrentlyConforming> failed_conforms_;
+
+  /**
+   * @brief Number of bytes of audio written so far by each running conform, keyed by filename
+   */
+  static QHash<QString, qint64> conform_progress_;
+
+  static QAtomicInt proxy_revision_;
+
 signals:
   /**
    * @brief While indexing, this signal will provide progress as a percentage (0-100 inclusive) if
@@ -242,8 +352,32 @@ signals:
 private:
   SampleBufferPtr RetrieveAudioFromConform(const QString& conform_filename, const TimeRange &range);
 
+  static SampleBufferPtr RetrieveAudioFromPartialConform(const QString& conform_filename, qint64 conform_progress, const TimeRange &range, const AudioParams &params);
+
+  void StartConformTask(const AudioParams& params);
+
+  static QString GetWorkingFilename(const QString& filename);
+
+  static QString GetProgressFilename(const QString& filename);
+
+  void CloseConform();
+
   Stream* stream_;
 
+  /**
+   * @brief The last conform read from, kept open and memory-mapped
+   *
+   * Audio is rendered in short chunks, so the same conform is read over and over again.
+   */
+  std::unique_ptr<WaveInput> conform_input_;
+  QString conform_input_filename_;
+  const char* conform_data_;
+
+  /**
+   * @brief Filename of the conform currently being written by ConformAudio()
+   */
+  QString conforming_filename_;
+
   QMutex mutex_;
 
 };
@@ -23,6 +23,7 @@
 #include <QFile>
 
 #include "ffmpeg/ffmpegencoder.h"
+#include "oiio/oiioencoder.h"
 
 namespace olive {
 
@@ -72,6 +73,16 @@ void EncodingParams::EnableAudio(const AudioParams &audio_params, const ExportCo
   audio_codec_ = acodec;
 }
 
+void EncodingParams::DisableVideo()
+{
+  video_enabled_ = false;
+}
+
+void EncodingParams::DisableAudio()
+{
+  audio_enabled_ = false;
+}
+
 void EncodingParams::set_video_option(const QString &key, const QString &value)
 {
   video_opts_.insert(key, value);
@@ -232,7 +243,9 @@ void EncodingParams::Save(QXmlStreamWriter *writer) const
 
 Encoder* Encoder::CreateFromID(const QString &id, const EncodingParams& params)
 {
-  Q_UNUSED(id)
+  if (id == QStringLiteral("oiio")) {
+    return new OIIOEncoder(params);
+  }
 
   return new FFmpegEncoder(params);
 }
@@ -23,6 +23,7 @@
 
 #include <memory>
 #include <QString>
+#include <QStringList>
 #include <QXmlStreamWriter>
 
 #include "codec/exportcodec.h"
@@ -45,6 +46,8 @@ public:
 
   void EnableVideo(const VideoParams& video_params, const ExportCodec::Codec& vcodec);
   void EnableAudio(const AudioParams& audio_params, const ExportCodec::Codec &acodec);
+  void DisableVideo();
+  void DisableAudio();
 
   void set_video_option(const QString& key, const QString& value);
   void set_video_bit_rate(const int64_t& rate);
@@ -133,11 +136,82 @@ public:
 
   virtual void Close() = 0;
 
+  /**
+   * @brief Returns whether anything failed to be written since the encoder was opened
+   *
+   * Some encoders write in the background, so this is only final once Close() has returned.
+   */
+  virtual bool HasError() const
+  {
+    return false;
+  }
+
   virtual VideoParams::Format GetDesiredPixelFormat() const
   {
     return VideoParams::kFormatInvalid;
   }
 
+  /**
+   * @brief Returns every file written since the encoder was opened
+   *
+   * Most encoders only write params().filename(), but ones that write a file per frame return each
+   * of them. They're returned as they would be named if the encoder had been given `filename`
+   * instead, so a file written under a temporary name can be matched to its final name.
+   */
+  virtual QStringList GetWrittenFilenames(const QString& filename) const
+  {
+    return QStringList(filename);
+  }
+
+  /**
+   * @brief Returns whether WriteFrame() must be called in chronological order
+   */
+  virtual bool RequiresOrderedFrames() const
+  {
+    return true;
+  }
+
+  /**
+   * @brief Returns whether files made by separate instances of this encoder can be joined
+   *
+   * If so, the video can be split into segments that are encoded at the same time and then
+   * joined with JoinSegments().
+   */
+  virtual bool CanJoinSegments() const
+  {
+    return false;
+  }
+
+  /**
+   * @brief Join separately encoded files into this encoder's file without re-encoding them
+   *
+   * This should be called instead of Open() rather than after it.
+   *
+   * @param segments
+   *
+   * Video-only files to join in order. Each should start at time 0.
+   *
+   * @param frame_counts
+   *
+   * The amount of frames each segment is meant to contain, used to ensure every join is frame
+   * accurate.
+   *
+   * @param audio_filename
+   *
+   * An audio-only file to add to the result, or an empty string for none.
+   *
+   * @return
+   *
+   * TRUE if the segments were joined and verified successfully.
+   */
+  virtual bool JoinSegments(const QStringList& segments, const QVector<int64_t>& frame_counts, const QString& audio_filename)
+  {
+    Q_UNUSED(segments)
+    Q_UNUSED(frame_counts)
+    Q_UNUSED(audio_filename)
+    return false;
+  }
+
 private:
   EncodingParams params_;
 
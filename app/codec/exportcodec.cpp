@@ -82,6 +82,29 @@ bool ExportCodec::IsCodecAStillImage(ExportCodec::Codec c)
   return false;
 }
 
+bool ExportCodec::IsCodecIntraOnly(ExportCodec::Codec c)
+{
+  switch (c) {
+  case kCodecDNxHD:
+  case kCodecOpenEXR:
+  case kCodecPNG:
+  case kCodecProRes:
+  case kCodecTIFF:
+    return true;
+  case kCodecH264:
+  case kCodecH265:
+  case kCodecMP2:
+  case kCodecMP3:
+  case kCodecAAC:
+  case kCodecPCM:
+    return false;
+  case kCodecCount:
+    break;
+  }
+
+  return false;
+}
+
 QStringList ExportCodec::GetPixelFormatsForCodec(ExportCodec::Codec c)
 {
   QStringList pix_fmts;
@@ -53,6 +53,13 @@ public:
 
   static bool IsCodecAStillImage(Codec c);
 
+  /**
+   * @brief Returns whether every frame this codec encodes can be decoded on its own
+   *
+   * Files in these codecs can be cut or joined on any frame without re-encoding.
+   */
+  static bool IsCodecIntraOnly(Codec c);
+
   static QStringList GetPixelFormatsForCodec(Codec c);
 
 };
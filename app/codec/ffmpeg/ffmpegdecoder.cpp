@@ -35,6 +35,7 @@ extern "C" {
 #include <QtMath>
 #include <QThread>
 #include <QtConcurrent/QtConcurrent>
+#include <utility>
 
 #include "codec/waveinput.h"
 #include "common/define.h"
@@ -47,13 +48,26 @@ extern "C" {
 
 namespace olive {
 
+QSet<QString> FFmpegDecoder::keyframe_indexes_building_;
+QHash<QString, KeyframeIndex> FFmpegDecoder::unsaved_keyframe_indexes_;
+QMutex FFmpegDecoder::keyframe_indexes_building_lock_;
+
 FFmpegDecoder::FFmpegDecoder() :
   scale_ctx_(nullptr),
   scale_divider_(0),
   pool_(QThread::idealThreadCount()*2),
   is_working_(false),
   cache_at_zero_(false),
-  cache_at_eof_(false)
+  cache_at_eof_(false),
+  proxy_divider_(0),
+  proxy_lookup_divider_(0),
+  proxy_lookup_revision_(-1),
+  standby_proxy_divider_(-1),
+  keyframe_index_loaded_(false),
+  last_requested_ts_(AV_NOPTS_VALUE),
+  playback_direction_(0),
+  sequential_requests_(0),
+  decoder_at_cache_end_(true)
 {
 }
 
@@ -84,6 +98,10 @@ bool FFmpegDecoder::OpenInternal()
         qDebug() << "Failed to find valid native pixel format for" << ideal_pix_fmt_;
         return false;
       }
+
+      if (static_cast<VideoStream*>(stream())->video_type() == VideoStream::kVideoTypeVideo) {
+        UpdateKeyframeIndex();
+      }
     }
 
     return true;
@@ -152,6 +170,11 @@ FramePtr FFmpegDecoder::RetrieveVideoInternal(const rational &timecode, const in
 {
   VideoStream* vs = static_cast<VideoStream*>(stream());
 
+  if (vs->video_type() == VideoStream::kVideoTypeVideo
+      && !UpdateProxy(divider)) {
+    return nullptr;
+  }
+
   if (scale_divider_ != divider) {
     FreeScaler();
     InitScaler(divider);
@@ -166,6 +189,11 @@ FramePtr FFmpegDecoder::RetrieveVideoInternal(const rational &timecode, const in
 
     int64_t target_ts = vs->get_time_in_timebase_units(timecode);
 
+    if (proxy_divider_) {
+      // Proxies carry the original timestamps, but the muxer may have changed the timebase
+      target_ts = av_rescale_q(target_ts, vs->timebase().toAVRational(), instance_.avstream()->time_base);
+    }
+
     int divided_width = VideoParams::GetScaledDimension(vs->width(), divider);
     int divided_height = VideoParams::GetScaledDimension(vs->height(), divider);
 
@@ -177,9 +205,15 @@ FramePtr FFmpegDecoder::RetrieveVideoInternal(const rational &timecode, const in
       pool_.SetParameters(divided_width, divided_height, native_pix_fmt_, native_channel_count_);
     }
 
+    UpdatePlaybackDirection(target_ts);
+
     // Retrieve frame
     FFmpegFramePool::ElementPtr return_frame = RetrieveFrame(target_ts, divider);
 
+    if (IsPlaying()) {
+      StartDecodeAhead();
+    }
+
     // We found the frame, we'll return a copy
     if (return_frame) {
       FramePtr copy = Frame::Create();
@@ -206,11 +240,26 @@ FramePtr FFmpegDecoder::RetrieveVideoInternal(const rational &timecode, const in
 
 void FFmpegDecoder::CloseInternal()
 {
+  StopDecodeAhead();
+
   ClearFrameCache();
 
   instance_.Close();
+  standby_instance_.Close();
 
   FreeScaler();
+
+  proxy_divider_ = 0;
+  proxy_lookup_divider_ = 0;
+  proxy_lookup_revision_ = -1;
+  standby_proxy_divider_ = -1;
+
+  keyframe_index_.clear();
+  keyframe_index_loaded_ = false;
+
+  last_requested_ts_ = AV_NOPTS_VALUE;
+  playback_direction_ = 0;
+  sequential_requests_ = 0;
 }
 
 QString FFmpegDecoder::id()
@@ -464,15 +513,64 @@ QString FFmpegDecoder::FFmpegError(int error_code)
   return QStringLiteral("%1 %2").arg(QString::number(error_code), err);
 }
 
-bool FFmpegDecoder::ConformAudioInternal(const QString &filename, const AudioParams &params, const QAtomicInt *cancelled)
+bool FFmpegDecoder::ConformAudioInternal(const QString &filename, const AudioParams &params, qint64 resume_from, const QAtomicInt *cancelled)
+{
+  WaveOutput wave_out(filename, params);
+
+  if (resume_from > 0 && !wave_out.resume(resume_from)) {
+    qWarning() << "Failed to resume conform, starting again";
+    resume_from = 0;
+  }
+
+  if (resume_from == 0 && !wave_out.open()) {
+    qWarning() << "Failed to open WAVE output for indexing";
+    return false;
+  }
+
+  bool success = DecodeAudio(params.bytes_to_samples(resume_from), -1, params, cancelled, &wave_out, nullptr);
+
+  wave_out.close();
+
+  return success;
+}
+
+SampleBufferPtr FFmpegDecoder::DecodeAudioRangeInternal(const TimeRange &range, const AudioParams &params, const QAtomicInt *cancelled)
+{
+  qint64 start = qMax(qint64(0), params.time_to_samples(range.in()));
+  qint64 length = params.time_to_samples(range.length());
+  int expected_size = params.samples_to_bytes(length);
+
+  QByteArray packed_data;
+  packed_data.reserve(expected_size);
+
+  if (!DecodeAudio(start, length, params, cancelled, nullptr, &packed_data)) {
+    return nullptr;
+  }
+
+  // Pad with silence if the range went past the end of the stream
+  if (packed_data.size() < expected_size) {
+    packed_data.append(QByteArray(expected_size - packed_data.size(), 0));
+  }
+
+  return SampleBuffer::CreateFromPackedData(params, packed_data);
+}
+
+bool FFmpegDecoder::DecodeAudio(qint64 start, qint64 length, const AudioParams &params, const QAtomicInt *cancelled, WaveOutput *wave_out, QByteArray *bytes)
 {
   // Iterate through each audio frame and extract the PCM data
+  AVStream* avstream = instance_.avstream();
+  AVRational sample_timebase = {1, params.sample_rate()};
+  int64_t start_time = (avstream->start_time == AV_NOPTS_VALUE) ? 0 : avstream->start_time;
 
   // Seek to starting point
-  instance_.Seek(0);
+  if (start > 0) {
+    instance_.Seek(av_rescale_q(start, sample_timebase, avstream->time_base) + start_time);
+  } else {
+    instance_.Seek(0);
+  }
 
   // Handle NULL channel layout
-  uint64_t channel_layout = ValidateChannelLayout(instance_.avstream());
+  uint64_t channel_layout = ValidateChannelLayout(avstream);
   if (!channel_layout) {
     qCritical() << "Failed to determine channel layout of audio file, could not conform";
     return false;
@@ -484,75 +582,132 @@ bool FFmpegDecoder::ConformAudioInternal(const QString &filename, const AudioPar
                                              FFmpegUtils::GetFFmpegSampleFormat(params.format()),
                                              params.sample_rate(),
                                              channel_layout,
-                                             static_cast<AVSampleFormat>(instance_.avstream()->codecpar->format),
-                                             instance_.avstream()->codecpar->sample_rate,
+                                             static_cast<AVSampleFormat>(avstream->codecpar->format),
+                                             avstream->codecpar->sample_rate,
                                              0,
                                              nullptr);
 
   swr_init(resampler);
 
-  WaveOutput wave_out(filename, params);
+  auto write = [wave_out, bytes](const char* data, int size) {
+    if (wave_out) {
+      wave_out->write(data, size);
+    } else {
+      bytes->append(data, size);
+    }
+  };
+
+  // Conforms make their progress available roughly every couple of seconds of audio
+  const int chunk_size = params.time_to_bytes(2.0);
+  qint64 last_chunk = wave_out ? wave_out->data_length() : 0;
 
   AVPacket* pkt = av_packet_alloc();
   AVFrame* frame = av_frame_alloc();
   int ret;
 
+  // Position (in samples) of the next sample out of the resampler, unknown until the first frame
+  qint64 position = -1;
+  qint64 written = 0;
+
   bool success = false;
 
-  if (wave_out.open()) {
-    while (true) {
-      // Check if we have a `cancelled` ptr and its value
-      if (cancelled && *cancelled) {
-        break;
+  while (true) {
+    // Check if we have a `cancelled` ptr and its value
+    if (cancelled && *cancelled) {
+      break;
+    }
+
+    ret = instance_.GetFrame(pkt, frame);
+
+    if (ret < 0) {
+
+      if (ret == AVERROR_EOF) {
+        success = true;
+      } else {
+        char err_str[50];
+        av_strerror(ret, err_str, 50);
+        qWarning() << "Failed to conform:" << ret << err_str;
       }
+      break;
 
-      ret = instance_.GetFrame(pkt, frame);
+    }
 
-      if (ret < 0) {
+    if (position == -1) {
+      if (start == 0) {
+        position = 0;
+      } else if (frame->pts == AV_NOPTS_VALUE) {
+        // No way of knowing where we landed, assume the seek was exact
+        position = start;
+      } else {
+        position = av_rescale_q(frame->pts - start_time, avstream->time_base, sample_timebase);
+      }
 
-        if (ret == AVERROR_EOF) {
-          success = true;
-        } else {
-          char err_str[50];
-          av_strerror(ret, err_str, 50);
-          qWarning() << "Failed to conform:" << ret << err_str;
+      if (position > start) {
+        // Seek landed after where we wanted to start, fill the gap with silence
+        qint64 gap = position - start;
+
+        if (length >= 0) {
+          gap = qMin(gap, length);
         }
-        break;
 
+        write(QByteArray(params.samples_to_bytes(gap), 0).constData(), params.samples_to_bytes(gap));
+        written += gap;
+        position = start + gap;
       }
+    }
 
-      // Allocate buffers
-      int nb_samples = swr_get_out_samples(resampler, frame->nb_samples);
-      char* data = new char[params.samples_to_bytes(nb_samples)];
+    // Allocate buffers
+    int nb_samples = swr_get_out_samples(resampler, frame->nb_samples);
+    char* data = new char[params.samples_to_bytes(nb_samples)];
+
+    // Resample audio to our destination parameters
+    nb_samples = swr_convert(resampler,
+                             reinterpret_cast<uint8_t**>(&data),
+                             nb_samples,
+                             const_cast<const uint8_t**>(frame->data),
+                             frame->nb_samples);
+
+    if (nb_samples < 0) {
+      char err_str[50];
+      av_strerror(nb_samples, err_str, 50);
+      qWarning() << "libswresample failed with error:" << nb_samples << err_str;
+      delete [] data;
+      break;
+    }
 
-      // Resample audio to our destination parameters
-      nb_samples = swr_convert(resampler,
-                               reinterpret_cast<uint8_t**>(&data),
-                               nb_samples,
-                               const_cast<const uint8_t**>(frame->data),
-                               frame->nb_samples);
+    // Drop any samples from before the start point (seeking is only accurate to the nearest packet)
+    qint64 skip = qBound(qint64(0), start - position, qint64(nb_samples));
+    qint64 write_samples = nb_samples - skip;
 
-      if (nb_samples < 0) {
-        char err_str[50];
-        av_strerror(nb_samples, err_str, 50);
-        qWarning() << "libswresample failed with error:" << nb_samples << err_str;
-        break;
-      }
+    if (length >= 0) {
+      write_samples = qMin(write_samples, length - written);
+    }
 
-      // Write packed WAV data to the disk cache
-      wave_out.write(data, params.samples_to_bytes(nb_samples));
+    position += nb_samples;
 
-      // If we allocated an output for the resampler, delete it here
-      if (data != reinterpret_cast<char*>(frame->data[0])) {
-        delete [] data;
-      }
+    if (write_samples > 0) {
+      // Write packed WAV data
+      write(data + params.samples_to_bytes(skip), params.samples_to_bytes(write_samples));
+      written += write_samples;
+    }
+
+    delete [] data;
 
+    if (wave_out) {
       SignalProcessingProgress(frame->pts);
+
+      if (wave_out->data_length() - last_chunk >= chunk_size) {
+        // Make this chunk visible to readers of the working file
+        wave_out->flush();
+        SignalConformChunk(wave_out->data_length());
+        last_chunk = wave_out->data_length();
+      }
     }
 
-    wave_out.close();
-  } else {
-    qWarning() << "Failed to open WAVE output for indexing";
+    if (length >= 0 && written >= length) {
+      success = true;
+      break;
+    }
   }
 
   swr_free(&resampler);
@@ -673,6 +828,7 @@ void FFmpegDecoder::ClearFrameCache()
   cached_frames_.clear();
   cache_at_eof_ = false;
   cache_at_zero_ = false;
+  decoder_at_cache_end_ = true;
 }
 
 FFmpegFramePool::ElementPtr FFmpegDecoder::RetrieveFrame(const int64_t& target_ts, int divider)
@@ -680,23 +836,50 @@ FFmpegFramePool::ElementPtr FFmpegDecoder::RetrieveFrame(const int64_t& target_t
   int64_t seek_ts = target_ts;
   bool still_seeking = false;
 
-  // If the frame wasn't in the frame cache, see if this frame cache is too old to use
-  if (cached_frames_.isEmpty()
-      || (target_ts < cached_frames_.first()->timestamp() || target_ts > cached_frames_.last()->timestamp() + 2*second_ts_)) {
-    ClearFrameCache();
+  // Proxies carry their own timestamps and seek cheaply anyway, so only the original is indexed
+  KeyframeIndex::Keyframe keyframe;
+  bool have_keyframe = !proxy_divider_
+      && UpdateKeyframeIndex()
+      && keyframe_index_.FindKeyframeBefore(target_ts, &keyframe);
 
-    instance_.Seek(seek_ts);
-    if (seek_ts == 0) {
-      cache_at_zero_ = true;
-    }
+  // If the frame wasn't in the frame cache, see if this frame cache is too old to use
+  bool cache_usable;
 
-    still_seeking = true;
+  if (cached_frames_.isEmpty() || target_ts < cached_frames_.first()->timestamp()) {
+    cache_usable = false;
+  } else if (have_keyframe) {
+    // Decoding on from the cache is only worth it if no keyframe lies between it and the target
+    cache_usable = (keyframe.pts <= cached_frames_.last()->timestamp());
   } else {
+    cache_usable = (target_ts <= cached_frames_.last()->timestamp() + 2*second_ts_);
+  }
+
+  if (cache_usable) {
     // Search cache for frame
     FFmpegFramePool::ElementPtr cached_frame = GetFrameFromCache(target_ts);
     if (cached_frame) {
       return cached_frame;
     }
+
+    // Reverse decode-ahead can leave the decoder somewhere other than the end of the cache
+    cache_usable = decoder_at_cache_end_;
+  }
+
+  if (!cache_usable) {
+    ClearFrameCache();
+
+    if (have_keyframe) {
+      seek_ts = keyframe.pts;
+      instance_.Seek(keyframe);
+    } else {
+      instance_.Seek(seek_ts);
+    }
+
+    if (seek_ts == 0) {
+      cache_at_zero_ = true;
+    }
+
+    still_seeking = true;
   }
 
   int ret;
@@ -753,25 +936,16 @@ FFmpegFramePool::ElementPtr FFmpegDecoder::RetrieveFrame(const int64_t& target_t
     } else {
 
       // Cut down to thread count - 1 before we acquire a new frame
-      if (cached_frames_.size() == QThread::idealThreadCount()) {
+      while (cached_frames_.size() >= QThread::idealThreadCount()) {
         RemoveFirstFrame();
       }
 
-      FFmpegFramePool::ElementPtr cached = pool_.Get();
+      FFmpegFramePool::ElementPtr cached = ConvertToPoolFrame(working_frame);
 
       if (!cached) {
-        qCritical() << "Frame pool failed to return a valid frame - out of memory?";
         break;
       }
 
-      // Store in queue, converting to native format
-      uint8_t* destination_data = cached->data();
-      int destination_linesize = Frame::generate_linesize_bytes(VideoParams::GetScaledDimension(instance_.avstream()->codecpar->width, divider), native_pix_fmt_, native_channel_count_);
-      FFmpegBufferToNativeBuffer(working_frame->data, working_frame->linesize, &destination_data, &destination_linesize);
-
-      // Set timestamp so this frame can be identified later
-      cached->set_timestamp(working_frame->pts);
-
       // Store frame before just in case
       FFmpegFramePool::ElementPtr previous;
       if (cached_frames_.isEmpty()) {
@@ -805,6 +979,318 @@ FFmpegFramePool::ElementPtr FFmpegDecoder::RetrieveFrame(const int64_t& target_t
   return return_frame;
 }
 
+FFmpegFramePool::ElementPtr FFmpegDecoder::ConvertToPoolFrame(AVFrame *frame)
+{
+  FFmpegFramePool::ElementPtr cached = pool_.Get();
+
+  if (!cached) {
+    qCritical() << "Frame pool failed to return a valid frame - out of memory?";
+    return nullptr;
+  }
+
+  // Store in queue, converting to native format
+  uint8_t* destination_data = cached->data();
+  int destination_linesize = Frame::generate_linesize_bytes(pool_.width(), native_pix_fmt_, native_channel_count_);
+  FFmpegBufferToNativeBuffer(frame->data, frame->linesize, &destination_data, &destination_linesize);
+
+  // Set timestamp so this frame can be identified later
+  cached->set_timestamp(frame->pts);
+
+  return cached;
+}
+
+void FFmpegDecoder::UpdatePlaybackDirection(int64_t target_ts)
+{
+  int direction = 0;
+
+  // Anything within a second counts as a step of playback, even fast playback of slow footage
+  if (last_requested_ts_ != AV_NOPTS_VALUE && qAbs(target_ts - last_requested_ts_) <= second_ts_) {
+    if (target_ts > last_requested_ts_) {
+      direction = 1;
+    } else if (target_ts < last_requested_ts_) {
+      direction = -1;
+    }
+  }
+
+  if (direction != 0 && direction == playback_direction_) {
+    sequential_requests_++;
+  } else {
+    sequential_requests_ = (direction != 0) ? 1 : 0;
+  }
+
+  playback_direction_ = direction;
+  last_requested_ts_ = target_ts;
+}
+
+void FFmpegDecoder::StartDecodeAhead()
+{
+  if (decode_ahead_future_.isRunning()) {
+    return;
+  }
+
+  decode_ahead_cancelled_ = 0;
+  decode_ahead_future_ = QtConcurrent::run(this, &FFmpegDecoder::DecodeAhead);
+}
+
+void FFmpegDecoder::StopDecodeAhead()
+{
+  decode_ahead_cancelled_ = 1;
+  decode_ahead_future_.waitForFinished();
+}
+
+void FFmpegDecoder::DecodeAhead()
+{
+  AVPacket* pkt = av_packet_alloc();
+  AVFrame* frame = av_frame_alloc();
+
+  while (!decode_ahead_cancelled_) {
+    // Never block, so that closing (which holds the lock while waiting for us) can't deadlock
+    if (!mutex()->tryLock(10)) {
+      continue;
+    }
+
+    // Decode one frame (or one GOP in reverse) per lock so render requests can interleave
+    bool keep_going;
+
+    if (!IsPlaying()) {
+      keep_going = false;
+    } else if (playback_direction_ > 0) {
+      keep_going = DecodeAheadForward(pkt, frame);
+    } else {
+      keep_going = DecodeAheadReverse(pkt, frame);
+    }
+
+    mutex()->unlock();
+
+    if (!keep_going) {
+      break;
+    }
+  }
+
+  av_frame_free(&frame);
+  av_packet_free(&pkt);
+}
+
+bool FFmpegDecoder::DecodeAheadForward(AVPacket *pkt, AVFrame *frame)
+{
+  if (cached_frames_.isEmpty() || !decoder_at_cache_end_ || cache_at_eof_) {
+    return false;
+  }
+
+  int ready = 0;
+  foreach (const FFmpegFramePool::ElementPtr& f, cached_frames_) {
+    if (f->timestamp() > last_requested_ts_) {
+      ready++;
+    }
+  }
+
+  if (ready >= GetDecodeAheadCount()) {
+    return false;
+  }
+
+  int ret = instance_.GetFrame(pkt, frame);
+
+  if (ret == AVERROR_EOF) {
+    cache_at_eof_ = true;
+    return false;
+  } else if (ret < 0) {
+    return false;
+  }
+
+  while (cached_frames_.size() >= QThread::idealThreadCount()) {
+    RemoveFirstFrame();
+  }
+
+  FFmpegFramePool::ElementPtr cached = ConvertToPoolFrame(frame);
+
+  if (!cached) {
+    return false;
+  }
+
+  cached_frames_.append(cached);
+
+  return true;
+}
+
+bool FFmpegDecoder::DecodeAheadReverse(AVPacket *pkt, AVFrame *frame)
+{
+  if (cached_frames_.isEmpty() || cache_at_zero_) {
+    return false;
+  }
+
+  int ready = 0;
+  foreach (const FFmpegFramePool::ElementPtr& f, cached_frames_) {
+    if (f->timestamp() < last_requested_ts_) {
+      ready++;
+    }
+  }
+
+  if (ready >= GetDecodeAheadCount()) {
+    return false;
+  }
+
+  int64_t cache_start = cached_frames_.first()->timestamp();
+
+  // Seek to the start of the GOP before the cache. Proxies are intra-frame, so any frame will do.
+  if (proxy_divider_) {
+    instance_.Seek(cache_start - 1);
+  } else {
+    KeyframeIndex::Keyframe keyframe;
+
+    if (!UpdateKeyframeIndex() || !keyframe_index_.FindKeyframeBefore(cache_start - 1, &keyframe)) {
+      return false;
+    }
+
+    instance_.Seek(keyframe);
+  }
+
+  decoder_at_cache_end_ = false;
+
+  // Decode forward up to the cache, keeping the frames closest to it
+  QList<FFmpegFramePool::ElementPtr> gop;
+  bool reached_cache = false;
+
+  while (!decode_ahead_cancelled_) {
+    int ret = instance_.GetFrame(pkt, frame);
+
+    if (ret < 0 || frame->pts >= cache_start) {
+      reached_cache = true;
+      break;
+    }
+
+    FFmpegFramePool::ElementPtr cached = ConvertToPoolFrame(frame);
+
+    if (!cached) {
+      break;
+    }
+
+    gop.append(cached);
+
+    if (gop.size() > QThread::idealThreadCount()) {
+      gop.removeFirst();
+    }
+  }
+
+  if (!reached_cache || gop.isEmpty()) {
+    // Without the whole GOP these frames might not be contiguous with the cache
+    return false;
+  }
+
+  // Frames behind the playhead are the ones that won't be needed again
+  while (!cached_frames_.isEmpty()
+         && cached_frames_.size() + gop.size() > 2 * QThread::idealThreadCount()
+         && cached_frames_.last()->timestamp() > last_requested_ts_) {
+    cached_frames_.removeLast();
+    cache_at_eof_ = false;
+  }
+
+  cached_frames_ = gop + cached_frames_;
+
+  return true;
+}
+
+int FFmpegDecoder::GetDecodeAheadCount()
+{
+  // Leave room in the cache for the frames currently being rendered
+  return qMax(1, QThread::idealThreadCount() / 2);
+}
+
+bool FFmpegDecoder::UpdateKeyframeIndex()
+{
+  if (keyframe_index_loaded_) {
+    return !keyframe_index_.isEmpty();
+  }
+
+  QString index_fn = GetKeyframeIndexFilename();
+
+  QMutexLocker locker(&keyframe_indexes_building_lock_);
+
+  if (keyframe_indexes_building_.contains(index_fn)) {
+    // Still being built, seek the old way until it's done
+    return false;
+  }
+
+  if (unsaved_keyframe_indexes_.contains(index_fn)) {
+    keyframe_index_ = unsaved_keyframe_indexes_.value(index_fn);
+    keyframe_index_loaded_ = true;
+    return !keyframe_index_.isEmpty();
+  }
+
+  if (keyframe_index_.Load(index_fn)) {
+    // An index that failed to build is saved empty so it isn't attempted again
+    keyframe_index_loaded_ = true;
+    return !keyframe_index_.isEmpty();
+  }
+
+  keyframe_indexes_building_.insert(index_fn);
+
+  QtConcurrent::run(&FFmpegDecoder::BuildKeyframeIndex,
+                    stream()->footage()->filename(),
+                    stream()->index(),
+                    index_fn);
+
+  return false;
+}
+
+void FFmpegDecoder::BuildKeyframeIndex(const QString &filename, int stream_index, const QString &index_filename)
+{
+  KeyframeIndex index;
+  AVFormatContext* fmt_ctx = nullptr;
+
+  if (avformat_open_input(&fmt_ctx, filename.toUtf8(), nullptr, nullptr) == 0) {
+    if (avformat_find_stream_info(fmt_ctx, nullptr) >= 0
+        && stream_index < static_cast<int>(fmt_ctx->nb_streams)) {
+      // Only packets from this stream are of any interest
+      for (unsigned int i=0; i<fmt_ctx->nb_streams; i++) {
+        if (static_cast<int>(i) != stream_index) {
+          fmt_ctx->streams[i]->discard = AVDISCARD_ALL;
+        }
+      }
+
+      AVPacket* pkt = av_packet_alloc();
+
+      // Packets are only demuxed, never decoded, so this is mostly bound by disk speed
+      while (av_read_frame(fmt_ctx, pkt) >= 0) {
+        if (pkt->stream_index == stream_index && (pkt->flags & AV_PKT_FLAG_KEY)) {
+          int64_t pts = (pkt->pts == AV_NOPTS_VALUE) ? pkt->dts : pkt->pts;
+
+          if (pts != AV_NOPTS_VALUE) {
+            index.Append(pts, pkt->pos);
+          }
+        }
+
+        av_packet_unref(pkt);
+      }
+
+      av_packet_free(&pkt);
+    }
+
+    avformat_close_input(&fmt_ctx);
+  }
+
+  index.Finalize();
+
+  bool saved = index.Save(index_filename);
+
+  if (!saved) {
+    qWarning() << "Failed to save keyframe index" << index_filename;
+  }
+
+  QMutexLocker locker(&keyframe_indexes_building_lock_);
+
+  if (!saved) {
+    // Keep it for the rest of this session rather than building it again every time it's needed
+    unsaved_keyframe_indexes_.insert(index_filename, index);
+  }
+
+  keyframe_indexes_building_.remove(index_filename);
+}
+
+QString FFmpegDecoder::GetKeyframeIndexFilename()
+{
+  return GetIndexFilename().append(QStringLiteral(".keyframes"));
+}
+
 void FFmpegDecoder::InitScaler(int divider)
 {
   VideoStream* vs = static_cast<VideoStream*>(stream());
@@ -812,8 +1298,10 @@ void FFmpegDecoder::InitScaler(int divider)
   int scaled_width = VideoParams::GetScaledDimension(vs->width(), divider);
   int scaled_height = VideoParams::GetScaledDimension(vs->height(), divider);
 
-  scale_ctx_ = sws_getContext(vs->width(),
-                              vs->height(),
+  // Scale from whatever `instance_` is decoding, which will be smaller than the stream if it's a
+  // proxy
+  scale_ctx_ = sws_getContext(instance_.avstream()->codecpar->width,
+                              instance_.avstream()->codecpar->height,
                               static_cast<AVPixelFormat>(instance_.avstream()->codecpar->format),
                               scaled_width,
                               scaled_height,
@@ -830,6 +1318,277 @@ void FFmpegDecoder::InitScaler(int divider)
   }
 }
 
+bool FFmpegDecoder::UpdateProxy(int divider)
+{
+  int revision = GetProxyRevision();
+
+  if (divider == proxy_lookup_divider_ && revision == proxy_lookup_revision_) {
+    // Nothing has changed since we last looked
+    return true;
+  }
+
+  proxy_lookup_divider_ = divider;
+  proxy_lookup_revision_ = revision;
+
+  QString proxy_filename;
+  int proxy_divider = FindProxy(divider, &proxy_filename);
+
+  if (proxy_divider == proxy_divider_) {
+    return true;
+  }
+
+  // Anything cached belongs to the previous file
+  ClearFrameCache();
+  FreeScaler();
+
+  // Park the current file rather than closing it, and take whatever was parked before
+  instance_.Swap(standby_instance_);
+  std::swap(proxy_divider_, standby_proxy_divider_);
+
+  if (proxy_divider_ != proxy_divider) {
+    instance_.Close();
+
+    if (proxy_divider) {
+      // Proxies only ever contain one stream
+      if (instance_.Open(proxy_filename.toUtf8(), 0)) {
+        proxy_divider_ = proxy_divider;
+      } else {
+        qWarning() << "Failed to open proxy, falling back to original media:" << proxy_filename;
+        instance_.Close();
+        proxy_divider = 0;
+      }
+    }
+
+    if (!proxy_divider) {
+      if (standby_proxy_divider_ == 0) {
+        // The original media is what we just parked, take it back
+        instance_.Swap(standby_instance_);
+        standby_proxy_divider_ = -1;
+      } else if (!instance_.Open(stream()->footage()->filename().toUtf8(), stream()->index())) {
+        proxy_divider_ = 0;
+        return false;
+      }
+
+      proxy_divider_ = 0;
+    }
+  }
+
+  second_ts_ = qRound64(av_q2d(av_inv_q(instance_.avstream()->time_base)));
+
+  return true;
+}
+
+bool FFmpegDecoder::GenerateProxyInternal(const QString &filename, int divider, const QAtomicInt *cancelled)
+{
+  // Use our own instance so we don't disturb `instance_`, which may be a proxy itself
+  Instance source;
+  if (!source.Open(stream()->footage()->filename().toUtf8(), stream()->index())) {
+    return false;
+  }
+
+  AVCodecParameters* src_par = source.avstream()->codecpar;
+  AVPixelFormat src_pix_fmt = static_cast<AVPixelFormat>(src_par->format);
+
+  // MJPEG has no alpha channel, so we can't proxy anything that needs one
+  const AVPixFmtDescriptor* src_desc = av_pix_fmt_desc_get(src_pix_fmt);
+  if (!src_desc || (src_desc->flags & AV_PIX_FMT_FLAG_ALPHA)) {
+    qWarning() << "Proxies are not supported for media with an alpha channel";
+    return false;
+  }
+
+  const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+  if (!codec) {
+    qCritical() << "Failed to find MJPEG encoder for proxy";
+    return false;
+  }
+
+  // MJPEG is intra-frame only, so proxies are cheap to seek and decode in any direction
+  AVPixelFormat proxy_pix_fmt = AV_PIX_FMT_YUVJ422P;
+  int proxy_width = VideoParams::GetScaledDimension(src_par->width, divider);
+  int proxy_height = VideoParams::GetScaledDimension(src_par->height, divider);
+
+  AVFormatContext* fmt_ctx = nullptr;
+  AVCodecContext* codec_ctx = nullptr;
+  SwsContext* scaler = nullptr;
+  AVPacket* pkt = av_packet_alloc();
+  AVFrame* frame = av_frame_alloc();
+  AVFrame* proxy_frame = av_frame_alloc();
+  AVStream* proxy_stream = nullptr;
+
+  bool success = false;
+  bool header_written = false;
+  int ret;
+
+  do {
+    ret = avformat_alloc_output_context2(&fmt_ctx, nullptr, "mov", filename.toUtf8());
+    if (ret < 0) {
+      qCritical() << "Failed to create proxy format context:" << FFmpegError(ret);
+      break;
+    }
+
+    proxy_stream = avformat_new_stream(fmt_ctx, nullptr);
+    codec_ctx = avcodec_alloc_context3(codec);
+    if (!proxy_stream || !codec_ctx) {
+      qCritical() << "Failed to allocate proxy stream";
+      break;
+    }
+
+    codec_ctx->width = proxy_width;
+    codec_ctx->height = proxy_height;
+    codec_ctx->pix_fmt = proxy_pix_fmt;
+    codec_ctx->sample_aspect_ratio = src_par->sample_aspect_ratio;
+    codec_ctx->time_base = source.avstream()->time_base;
+    codec_ctx->flags |= AV_CODEC_FLAG_QSCALE;
+    codec_ctx->global_quality = FF_QP2LAMBDA * 3;
+
+    if (fmt_ctx->oformat->flags & AVFMT_GLOBALHEADER) {
+      codec_ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+
+    ret = avcodec_open2(codec_ctx, codec, nullptr);
+    if (ret < 0) {
+      qCritical() << "Failed to open proxy encoder:" << FFmpegError(ret);
+      break;
+    }
+
+    avcodec_parameters_from_context(proxy_stream->codecpar, codec_ctx);
+    proxy_stream->time_base = codec_ctx->time_base;
+
+    ret = avio_open(&fmt_ctx->pb, filename.toUtf8(), AVIO_FLAG_WRITE);
+    if (ret < 0) {
+      qCritical() << "Failed to open proxy file for writing:" << FFmpegError(ret);
+      break;
+    }
+
+    ret = avformat_write_header(fmt_ctx, nullptr);
+    if (ret < 0) {
+      qCritical() << "Failed to write proxy header:" << FFmpegError(ret);
+      break;
+    }
+    header_written = true;
+
+    scaler = sws_getContext(src_par->width,
+                            src_par->height,
+                            src_pix_fmt,
+                            proxy_width,
+                            proxy_height,
+                            proxy_pix_fmt,
+                            SWS_BICUBIC,
+                            nullptr,
+                            nullptr,
+                            nullptr);
+
+    proxy_frame->width = proxy_width;
+    proxy_frame->height = proxy_height;
+    proxy_frame->format = proxy_pix_fmt;
+
+    if (!scaler || av_frame_get_buffer(proxy_frame, 0) < 0) {
+      qCritical() << "Failed to allocate proxy scaler";
+      break;
+    }
+
+    bool eof = false;
+
+    while (!eof) {
+      if (cancelled && *cancelled) {
+        break;
+      }
+
+      ret = source.GetFrame(pkt, frame);
+
+      if (ret == AVERROR_EOF) {
+        // Flush encoder
+        eof = true;
+        ret = avcodec_send_frame(codec_ctx, nullptr);
+      } else if (ret < 0) {
+        qCritical() << "Failed to decode frame for proxy:" << FFmpegError(ret);
+        break;
+      } else if (frame->pts == AV_NOPTS_VALUE) {
+        // The decoder finds frames by timestamp, a frame without one could never be retrieved
+        qWarning() << "Skipping proxy frame with no timestamp";
+        continue;
+      } else {
+        av_frame_make_writable(proxy_frame);
+
+        sws_scale(scaler,
+                  frame->data,
+                  frame->linesize,
+                  0,
+                  src_par->height,
+                  proxy_frame->data,
+                  proxy_frame->linesize);
+
+        // Keep the original timestamps so the decoder can find frames the same way it always does
+        proxy_frame->pts = frame->pts;
+
+        ret = avcodec_send_frame(codec_ctx, proxy_frame);
+
+        SignalProcessingProgress(proxy_frame->pts);
+      }
+
+      if (ret < 0) {
+        qCritical() << "Failed to encode proxy frame:" << FFmpegError(ret);
+        break;
+      }
+
+      bool write_failed = false;
+
+      while ((ret = avcodec_receive_packet(codec_ctx, pkt)) >= 0) {
+        av_packet_rescale_ts(pkt, codec_ctx->time_base, proxy_stream->time_base);
+        pkt->stream_index = proxy_stream->index;
+
+        // Takes ownership of the packet's data whether or not it succeeds
+        int write_ret = av_interleaved_write_frame(fmt_ctx, pkt);
+        if (write_ret < 0) {
+          qCritical() << "Failed to write proxy packet:" << FFmpegError(write_ret);
+          write_failed = true;
+          break;
+        }
+      }
+
+      if (write_failed) {
+        break;
+      } else if (ret == AVERROR_EOF) {
+        success = true;
+      } else if (ret != AVERROR(EAGAIN)) {
+        qCritical() << "Failed to receive proxy packet:" << FFmpegError(ret);
+        break;
+      }
+    }
+  } while (false);
+
+  if (header_written) {
+    ret = av_write_trailer(fmt_ctx);
+    if (ret < 0) {
+      qCritical() << "Failed to write proxy trailer:" << FFmpegError(ret);
+      success = false;
+    }
+  }
+
+  if (fmt_ctx) {
+    if (fmt_ctx->pb) {
+      avio_closep(&fmt_ctx->pb);
+    }
+    avformat_free_context(fmt_ctx);
+  }
+
+  if (codec_ctx) {
+    avcodec_free_context(&codec_ctx);
+  }
+
+  if (scaler) {
+    sws_freeContext(scaler);
+  }
+
+  av_frame_free(&proxy_frame);
+  av_frame_free(&frame);
+  av_packet_free(&pkt);
+
+  source.Close();
+
+  return success;
+}
+
 void FFmpegDecoder::FreeScaler()
 {
   if (scale_ctx_) {
@@ -956,6 +1715,7 @@ void FFmpegDecoder::RemoveFirstFrame()
 FFmpegDecoder::Instance::Instance() :
   fmt_ctx_(nullptr),
   codec_ctx_(nullptr),
+  avstream_(nullptr),
   opts_(nullptr)
 {
 }
@@ -1049,6 +1809,14 @@ void FFmpegDecoder::Instance::Close()
   }
 }
 
+void FFmpegDecoder::Instance::Swap(FFmpegDecoder::Instance &other)
+{
+  std::swap(fmt_ctx_, other.fmt_ctx_);
+  std::swap(codec_ctx_, other.codec_ctx_);
+  std::swap(avstream_, other.avstream_);
+  std::swap(opts_, other.opts_);
+}
+
 int FFmpegDecoder::Instance::GetFrame(AVPacket *pkt, AVFrame *frame)
 {
   bool eof = false;
@@ -1100,4 +1868,19 @@ void FFmpegDecoder::Instance::Seek(int64_t timestamp)
   av_seek_frame(fmt_ctx_, avstream_->index, timestamp, AVSEEK_FLAG_BACKWARD);
 }
 
+void FFmpegDecoder::Instance::Seek(const KeyframeIndex::Keyframe &keyframe)
+{
+  avcodec_flush_buffers(codec_ctx_);
+
+  // Formats with discontinuous timestamps (e.g. MPEG-TS) seek more reliably by byte
+  if (keyframe.pos >= 0
+      && (fmt_ctx_->iformat->flags & AVFMT_TS_DISCONT)
+      && !(fmt_ctx_->iformat->flags & AVFMT_NO_BYTE_SEEK)
+      && av_seek_frame(fmt_ctx_, avstream_->index, keyframe.pos, AVSEEK_FLAG_BYTE) >= 0) {
+    return;
+  }
+
+  av_seek_frame(fmt_ctx_, avstream_->index, keyframe.pts, AVSEEK_FLAG_BACKWARD);
+}
+
 }
@@ -28,11 +28,16 @@ extern "C" {
 }
 
 #include <QAtomicInt>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
 #include <QTimer>
 #include <QVector>
 #include <QWaitCondition>
 
 #include "codec/decoder.h"
+#include "codec/keyframeindex.h"
 #include "codec/waveoutput.h"
 #include "ffmpegframepool.h"
 #include "project/item/footage/videostream.h"
@@ -62,7 +67,9 @@ public:
 protected:
   virtual bool OpenInternal() override;
   virtual FramePtr RetrieveVideoInternal(const rational &timecode, const int& divider) override;
-  virtual bool ConformAudioInternal(const QString& filename, const AudioParams &params, const QAtomicInt* cancelled) override;
+  virtual bool ConformAudioInternal(const QString& filename, const AudioParams &params, qint64 resume_from, const QAtomicInt* cancelled) override;
+  virtual SampleBufferPtr DecodeAudioRangeInternal(const TimeRange& range, const AudioParams& params, const QAtomicInt* cancelled) override;
+  virtual bool GenerateProxyInternal(const QString& filename, int divider, const QAtomicInt* cancelled) override;
   virtual void CloseInternal() override;
 
 private:
@@ -80,6 +87,11 @@ private:
 
     void Close();
 
+    /**
+     * @brief Exchange open files with `other` without closing either
+     */
+    void Swap(Instance& other);
+
     /**
      * @brief Uses the FFmpeg API to retrieve a packet (stored in pkt_) and decode it (stored in frame_)
      *
@@ -91,6 +103,11 @@ private:
 
     void Seek(int64_t timestamp);
 
+    /**
+     * @brief Seek directly to a known keyframe
+     */
+    void Seek(const KeyframeIndex::Keyframe& keyframe);
+
     AVFormatContext* fmt_ctx() const
     {
       return fmt_ctx_;
@@ -122,8 +139,47 @@ private:
   void InitScaler(int divider);
   void FreeScaler();
 
+  /**
+   * @brief Switch the decoding instance between the original media and its proxies
+   *
+   * Re-opens `instance_` on the smallest proxy that satisfies `divider`, or on the original media
+   * if there is none. Disk is only checked when the divider or the proxy revision changes.
+   *
+   * @return
+   *
+   * FALSE if neither a proxy nor the original media could be opened.
+   */
+  bool UpdateProxy(int divider);
+
   FramePtr RetrieveStillImage(const rational& timecode, const int& divider);
 
+  /**
+   * @brief Load the keyframe index of the original media, or start building it if there isn't one
+   *
+   * @return
+   *
+   * TRUE if a usable index is loaded.
+   */
+  bool UpdateKeyframeIndex();
+
+  /**
+   * @brief Demux (without decoding) an entire stream and save the position of every keyframe
+   *
+   * Runs in the background, \see UpdateKeyframeIndex()
+   */
+  static void BuildKeyframeIndex(const QString& filename, int stream_index, const QString& index_filename);
+
+  QString GetKeyframeIndexFilename();
+
+  /**
+   * @brief Decode and resample audio starting at sample `start` (in `params` sample rate)
+   *
+   * Audio is written to `wave_out` if it's set, or appended to `bytes` otherwise. Decoding stops at
+   * the end of the stream, or once `length` samples have been written if `length` isn't negative.
+   * When writing to `wave_out`, SignalConformChunk() is called regularly.
+   */
+  bool DecodeAudio(qint64 start, qint64 length, const AudioParams& params, const QAtomicInt* cancelled, WaveOutput* wave_out, QByteArray* bytes);
+
   static VideoParams::Format GetNativePixelFormat(AVPixelFormat pix_fmt);
   static int GetNativeChannelCount(AVPixelFormat pix_fmt);
 
@@ -137,6 +193,45 @@ private:
 
   FFmpegFramePool::ElementPtr RetrieveFrame(const int64_t &target_ts, int divider);
 
+  /**
+   * @brief Copy a decoded frame into a frame from the pool, converting to the native format
+   */
+  FFmpegFramePool::ElementPtr ConvertToPoolFrame(AVFrame* frame);
+
+  /**
+   * @brief Track the direction frames are being requested in to detect playback
+   *
+   * A run of requests each a short step after the last in the same direction is treated as
+   * playback (forwards or in reverse).
+   */
+  void UpdatePlaybackDirection(int64_t target_ts);
+
+  bool IsPlaying() const
+  {
+    // A couple of requests in the same direction is enough to start reading ahead
+    return sequential_requests_ >= 2;
+  }
+
+  /**
+   * @brief Decode frames ahead of the playhead in the background
+   *
+   * While playing, the frame cache is filled ahead of the last requested frame in the direction
+   * of playback, so render threads find frames already decoded rather than decoding and rendering
+   * one after the other. Reverse playback decodes a GOP at a time from the keyframe before the
+   * start of the cache.
+   */
+  void StartDecodeAhead();
+
+  void StopDecodeAhead();
+
+  void DecodeAhead();
+
+  bool DecodeAheadForward(AVPacket* pkt, AVFrame* frame);
+
+  bool DecodeAheadReverse(AVPacket* pkt, AVFrame* frame);
+
+  static int GetDecodeAheadCount();
+
   void RemoveFirstFrame();
 
   SwsContext* scale_ctx_;
@@ -157,8 +252,43 @@ private:
   bool cache_at_zero_;
   bool cache_at_eof_;
 
+  int proxy_divider_;
+  int proxy_lookup_divider_;
+  int proxy_lookup_revision_;
+
   Instance instance_;
 
+  /**
+   * @brief The file `instance_` had open before the last proxy change
+   *
+   * Kept open so switching back (e.g. when the divider changes back and forth while scrubbing)
+   * doesn't have to reopen it. `standby_proxy_divider_` is its divider, 0 for the original media
+   * or -1 if nothing is open.
+   */
+  Instance standby_instance_;
+  int standby_proxy_divider_;
+
+  KeyframeIndex keyframe_index_;
+  bool keyframe_index_loaded_;
+
+  int64_t last_requested_ts_;
+  int playback_direction_;
+  int sequential_requests_;
+
+  // FALSE if the decoder isn't positioned right after the last cached frame, in which case the
+  // cache can't be decoded on from
+  bool decoder_at_cache_end_;
+
+  QFuture<void> decode_ahead_future_;
+  QAtomicInt decode_ahead_cancelled_;
+
+  static QSet<QString> keyframe_indexes_building_;
+
+  /// Indexes that were built but couldn't be saved (e.g. a read-only cache), so they aren't rebuilt
+  static QHash<QString, KeyframeIndex> unsaved_keyframe_indexes_;
+
+  static QMutex keyframe_indexes_building_lock_;
+
 };
 
 }
@@ -40,7 +40,8 @@ FFmpegEncoder::FFmpegEncoder(const EncodingParams &params) :
   audio_stream_(nullptr),
   audio_codec_ctx_(nullptr),
   audio_resample_ctx_(nullptr),
-  open_(false)
+  open_(false),
+  error_(false)
 {
 }
 
@@ -50,6 +51,8 @@ bool FFmpegEncoder::Open()
     return true;
   }
 
+  error_ = false;
+
   int error_code;
 
   // Convert QString to C string that FFmpeg expects
@@ -310,6 +313,187 @@ void FFmpegEncoder::WriteAudio(AudioParams pcm_info, QIODevice* file)
   }
 }
 
+bool FFmpegEncoder::CanJoinSegments() const
+{
+  // Still image codecs are written as image sequences rather than one file we can join
+  return params().video_enabled()
+      && ExportCodec::IsCodecIntraOnly(params().video_codec())
+      && !ExportCodec::IsCodecAStillImage(params().video_codec());
+}
+
+bool FFmpegEncoder::JoinSegments(const QStringList &segments, const QVector<int64_t> &frame_counts, const QString &audio_filename)
+{
+  if (segments.isEmpty() || segments.size() != frame_counts.size()) {
+    return false;
+  }
+
+  bool success = false;
+  int error_code;
+
+  // Packet timestamps are checked and rewritten in frames
+  AVRational frame_base = params().video_params().time_base().toAVRational();
+
+  QByteArray filename_bytes = params().filename().toUtf8();
+  const char* filename_c_str = filename_bytes.constData();
+
+  AVFormatContext* video_in = nullptr;
+  AVFormatContext* audio_in = nullptr;
+  int video_index = -1;
+  int audio_index = -1;
+  AVStream* video_out = nullptr;
+  AVStream* audio_out = nullptr;
+  AVPacket* video_pkt = av_packet_alloc();
+  AVPacket* audio_pkt = av_packet_alloc();
+  bool video_ready = false;
+  bool audio_ready = false;
+  int segment = 0;
+  int64_t segment_start = 0;
+  int64_t segment_frame = 0;
+
+  if (!OpenJoinInput(segments.first(), AVMEDIA_TYPE_VIDEO, &video_in, &video_index)) {
+    goto fail;
+  }
+
+  if (!audio_filename.isEmpty()
+      && !OpenJoinInput(audio_filename, AVMEDIA_TYPE_AUDIO, &audio_in, &audio_index)) {
+    goto fail;
+  }
+
+  error_code = avformat_alloc_output_context2(&fmt_ctx_, nullptr, nullptr, filename_c_str);
+  if (error_code < 0) {
+    FFmpegError("Failed to allocate output context", error_code);
+    goto fail;
+  }
+
+  video_out = CreateJoinStream(video_in->streams[video_index]);
+
+  if (audio_in) {
+    audio_out = CreateJoinStream(audio_in->streams[audio_index]);
+  }
+
+  error_code = avio_open(&fmt_ctx_->pb, filename_c_str, AVIO_FLAG_WRITE);
+  if (error_code < 0) {
+    FFmpegError("Failed to open IO context", error_code);
+    goto fail;
+  }
+
+  error_code = avformat_write_header(fmt_ctx_, nullptr);
+  if (error_code < 0) {
+    FFmpegError("Failed to write format header", error_code);
+    goto fail;
+  }
+
+  open_ = true;
+
+  forever {
+    while (!video_ready && video_in) {
+      if (ReadJoinPacket(video_in, video_index, video_pkt)) {
+        AVStream* in_stream = video_in->streams[video_index];
+
+        // Every packet must be the next frame and decodable on its own, otherwise the join won't
+        // be frame accurate
+        if (video_pkt->pts == AV_NOPTS_VALUE
+            || av_rescale_q(video_pkt->pts, in_stream->time_base, frame_base) != segment_frame
+            || !(video_pkt->flags & AV_PKT_FLAG_KEY)) {
+          Error(QStringLiteral("Segment %1 is not frame accurate at frame %2").arg(QString::number(segment),
+                                                                                    QString::number(segment_frame)));
+          goto fail;
+        }
+
+        video_pkt->pts = av_rescale_q(segment_start + segment_frame, frame_base, video_out->time_base);
+        video_pkt->dts = video_pkt->pts;
+        video_pkt->duration = av_rescale_q(video_pkt->duration, in_stream->time_base, video_out->time_base);
+        video_pkt->stream_index = video_out->index;
+        video_pkt->pos = -1;
+
+        segment_frame++;
+        video_ready = true;
+      } else {
+        // Reached the end of this segment, make sure it had every frame
+        if (segment_frame != frame_counts.at(segment)) {
+          Error(QStringLiteral("Segment %1 contains %2 frames, expected %3").arg(QString::number(segment),
+                                                                                 QString::number(segment_frame),
+                                                                                 QString::number(frame_counts.at(segment))));
+          goto fail;
+        }
+
+        avformat_close_input(&video_in);
+
+        segment_start += segment_frame;
+        segment_frame = 0;
+        segment++;
+
+        if (segment < segments.size()) {
+          if (!OpenJoinInput(segments.at(segment), AVMEDIA_TYPE_VIDEO, &video_in, &video_index)) {
+            goto fail;
+          }
+
+          AVCodecParameters* a = video_out->codecpar;
+          AVCodecParameters* b = video_in->streams[video_index]->codecpar;
+          if (a->codec_id != b->codec_id
+              || a->width != b->width
+              || a->height != b->height
+              || a->format != b->format) {
+            Error(QStringLiteral("Segment %1 does not match the format of the others").arg(segment));
+            goto fail;
+          }
+        }
+      }
+    }
+
+    if (!audio_ready && audio_in) {
+      if (ReadJoinPacket(audio_in, audio_index, audio_pkt)) {
+        av_packet_rescale_ts(audio_pkt, audio_in->streams[audio_index]->time_base, audio_out->time_base);
+        audio_pkt->stream_index = audio_out->index;
+        audio_pkt->pos = -1;
+
+        audio_ready = true;
+      } else {
+        avformat_close_input(&audio_in);
+      }
+    }
+
+    // Write whichever packet comes first so the streams stay interleaved
+    AVPacket* next;
+
+    if (video_ready
+        && (!audio_ready || av_compare_ts(video_pkt->dts, video_out->time_base,
+                                          audio_pkt->dts, audio_out->time_base) <= 0)) {
+      next = video_pkt;
+      video_ready = false;
+    } else if (audio_ready) {
+      next = audio_pkt;
+      audio_ready = false;
+    } else {
+      break;
+    }
+
+    error_code = av_interleaved_write_frame(fmt_ctx_, next);
+    if (error_code < 0) {
+      FFmpegError("Failed to write packet", error_code);
+      goto fail;
+    }
+  }
+
+  success = true;
+
+fail:
+  av_packet_free(&video_pkt);
+  av_packet_free(&audio_pkt);
+
+  if (video_in) {
+    avformat_close_input(&video_in);
+  }
+
+  if (audio_in) {
+    avformat_close_input(&audio_in);
+  }
+
+  Close();
+
+  return success;
+}
+
 void FFmpegEncoder::Close()
 {
   if (open_) {
@@ -601,6 +785,57 @@ bool FFmpegEncoder::SetupCodecContext(AVStream* stream, AVCodecContext* codec_ct
   return true;
 }
 
+bool FFmpegEncoder::OpenJoinInput(const QString &filename, AVMediaType type, AVFormatContext **ctx, int *stream_index)
+{
+  QByteArray filename_bytes = filename.toUtf8();
+
+  int error_code = avformat_open_input(ctx, filename_bytes.constData(), nullptr, nullptr);
+  if (error_code < 0) {
+    FFmpegError("Failed to open segment", error_code);
+    return false;
+  }
+
+  error_code = avformat_find_stream_info(*ctx, nullptr);
+  if (error_code < 0) {
+    FFmpegError("Failed to find segment stream info", error_code);
+    avformat_close_input(ctx);
+    return false;
+  }
+
+  *stream_index = av_find_best_stream(*ctx, type, -1, -1, nullptr, 0);
+  if (*stream_index < 0) {
+    FFmpegError("Failed to find stream in segment", *stream_index);
+    avformat_close_input(ctx);
+    return false;
+  }
+
+  return true;
+}
+
+AVStream *FFmpegEncoder::CreateJoinStream(AVStream *input)
+{
+  AVStream* s = avformat_new_stream(fmt_ctx_, nullptr);
+
+  avcodec_parameters_copy(s->codecpar, input->codecpar);
+  s->codecpar->codec_tag = 0;
+  s->time_base = input->time_base;
+
+  return s;
+}
+
+bool FFmpegEncoder::ReadJoinPacket(AVFormatContext *ctx, int stream_index, AVPacket *pkt)
+{
+  while (av_read_frame(ctx, pkt) >= 0) {
+    if (pkt->stream_index == stream_index) {
+      return true;
+    }
+
+    av_packet_unref(pkt);
+  }
+
+  return false;
+}
+
 void FFmpegEncoder::FlushEncoders()
 {
   if (video_codec_ctx_) {
@@ -638,6 +873,8 @@ void FFmpegEncoder::Error(const QString &s)
 {
   qWarning() << s;
 
+  error_ = true;
+
   Close();
 }
 
@@ -47,11 +47,20 @@ public:
 
   virtual void Close() override;
 
+  virtual bool HasError() const override
+  {
+    return error_;
+  }
+
   virtual VideoParams::Format GetDesiredPixelFormat() const override
   {
     return video_conversion_fmt_;
   }
 
+  virtual bool CanJoinSegments() const override;
+
+  virtual bool JoinSegments(const QStringList& segments, const QVector<int64_t>& frame_counts, const QString& audio_filename) override;
+
 private:
   /**
    * @brief Handle an error
@@ -78,6 +87,10 @@ private:
   bool InitializeCodecContext(AVStream** stream, AVCodecContext** codec_ctx, AVCodec* codec);
   bool SetupCodecContext(AVStream *stream, AVCodecContext *codec_ctx, AVCodec *codec);
 
+  bool OpenJoinInput(const QString& filename, AVMediaType type, AVFormatContext** ctx, int* stream_index);
+  AVStream* CreateJoinStream(AVStream* input);
+  static bool ReadJoinPacket(AVFormatContext* ctx, int stream_index, AVPacket* pkt);
+
   void FlushEncoders();
   void FlushCodecCtx(AVCodecContext* codec_ctx, AVStream *stream);
 
@@ -95,6 +108,8 @@ private:
 
   bool open_;
 
+  bool error_;
+
 };
 
 }
@@ -0,0 +1,144 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "keyframeindex.h"
+
+#include <algorithm>
+#include <QDataStream>
+#include <QFile>
+
+#include "common/filefunctions.h"
+
+namespace olive {
+
+// Bump if the on-disk layout changes so old indexes are rebuilt
+const quint32 kKeyframeIndexVersion = 1;
+
+void KeyframeIndex::Append(int64_t pts, int64_t pos)
+{
+  keyframes_.append({pts, pos});
+}
+
+void KeyframeIndex::Finalize()
+{
+  std::sort(keyframes_.begin(), keyframes_.end(), [](const Keyframe& a, const Keyframe& b){
+    return a.pts < b.pts;
+  });
+
+  keyframes_.erase(std::unique(keyframes_.begin(), keyframes_.end(), [](const Keyframe& a, const Keyframe& b){
+    return a.pts == b.pts;
+  }), keyframes_.end());
+}
+
+bool KeyframeIndex::Load(const QString &filename)
+{
+  keyframes_.clear();
+
+  QFile file(filename);
+
+  if (!file.open(QFile::ReadOnly)) {
+    return false;
+  }
+
+  QDataStream ds(&file);
+  ds.setVersion(QDataStream::Qt_5_6);
+
+  quint32 version;
+  quint32 count;
+
+  ds >> version;
+
+  if (version != kKeyframeIndexVersion) {
+    return false;
+  }
+
+  ds >> count;
+
+  // Don't trust the count to allocate with, a damaged file could claim any amount
+  const qint64 kKeyframeSize = sizeof(qint64) * 2;
+  if (ds.status() != QDataStream::Ok || count > (file.size() - file.pos()) / kKeyframeSize) {
+    return false;
+  }
+
+  keyframes_.resize(count);
+
+  for (quint32 i=0; i<count; i++) {
+    qint64 pts, pos;
+
+    ds >> pts >> pos;
+
+    keyframes_[i] = {pts, pos};
+  }
+
+  if (ds.status() != QDataStream::Ok) {
+    keyframes_.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool KeyframeIndex::Save(const QString &filename) const
+{
+  QString temp_fn = FileFunctions::GetSafeTemporaryFilename(filename);
+
+  QFile file(temp_fn);
+
+  if (!file.open(QFile::WriteOnly)) {
+    return false;
+  }
+
+  QDataStream ds(&file);
+  ds.setVersion(QDataStream::Qt_5_6);
+
+  ds << kKeyframeIndexVersion;
+  ds << quint32(keyframes_.size());
+
+  foreach (const Keyframe& k, keyframes_) {
+    ds << qint64(k.pts) << qint64(k.pos);
+  }
+
+  file.close();
+
+  if (ds.status() != QDataStream::Ok || !FileFunctions::RenameFileAllowOverwrite(temp_fn, filename)) {
+    QFile::remove(temp_fn);
+    return false;
+  }
+
+  return true;
+}
+
+bool KeyframeIndex::FindKeyframeBefore(int64_t pts, Keyframe *keyframe) const
+{
+  // Find the first keyframe after `pts`, the one we want is just before it
+  auto it = std::upper_bound(keyframes_.cbegin(), keyframes_.cend(), pts, [](int64_t t, const Keyframe& k){
+    return t < k.pts;
+  });
+
+  if (it == keyframes_.cbegin()) {
+    return false;
+  }
+
+  *keyframe = *(it - 1);
+
+  return true;
+}
+
+}
@@ -0,0 +1,94 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef KEYFRAMEINDEX_H
+#define KEYFRAMEINDEX_H
+
+#include <QString>
+#include <QVector>
+
+#include "common/define.h"
+
+namespace olive {
+
+/**
+ * @brief A sorted list of a stream's keyframes, stored on disk next to the stream's other index
+ * files
+ *
+ * Decoders can look up the keyframe preceding any timestamp and seek straight to it, rather than
+ * seeking roughly and stepping backwards until they land before their target.
+ */
+class KeyframeIndex
+{
+public:
+  KeyframeIndex() = default;
+
+  struct Keyframe {
+    // Presentation timestamp in the stream's timebase
+    int64_t pts;
+
+    // Byte position in the file, or -1 if unknown
+    int64_t pos;
+  };
+
+  /**
+   * @brief Add a keyframe, keyframes can be appended in any order
+   */
+  void Append(int64_t pts, int64_t pos);
+
+  /**
+   * @brief Sort keyframes and remove duplicates, must be called before any lookups
+   */
+  void Finalize();
+
+  bool Load(const QString& filename);
+
+  /**
+   * @brief Atomically write this index to disk
+   */
+  bool Save(const QString& filename) const;
+
+  bool isEmpty() const
+  {
+    return keyframes_.isEmpty();
+  }
+
+  void clear()
+  {
+    keyframes_.clear();
+  }
+
+  /**
+   * @brief Find the last keyframe at or before `pts`
+   *
+   * @return
+   *
+   * FALSE if `pts` comes before the first keyframe.
+   */
+  bool FindKeyframeBefore(int64_t pts, Keyframe* keyframe) const;
+
+private:
+  QVector<Keyframe> keyframes_;
+
+};
+
+}
+
+#endif // KEYFRAMEINDEX_H
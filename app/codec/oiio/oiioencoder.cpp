@@ -0,0 +1,239 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "oiioencoder.h"
+
+#include <OpenImageIO/imageio.h>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+
+#include "codec/decoder.h"
+#include "common/oiioutils.h"
+#include "common/timecodefunctions.h"
+
+namespace olive {
+
+OIIOEncoder::OIIOEncoder(const EncodingParams &params) :
+  Encoder(params),
+  image_sequence_(false),
+  first_index_(0),
+  max_pending_writes_(QThread::idealThreadCount()),
+  pending_writes_(0),
+  write_failed_(false)
+{
+}
+
+OIIOEncoder::~OIIOEncoder()
+{
+  Close();
+}
+
+bool OIIOEncoder::Open()
+{
+  if (!params().video_enabled()) {
+    qWarning() << "OIIOEncoder can only encode video";
+    return false;
+  }
+
+  std::unique_ptr<OIIO::ImageOutput> test = OIIO::ImageOutput::create(params().filename().toStdString());
+  if (!test) {
+    qWarning() << "Failed to find OIIO plugin for" << params().filename();
+    return false;
+  }
+
+  image_sequence_ = (params().video_opts().value(QStringLiteral("image_sequence"), QStringLiteral("1")) != QStringLiteral("0"));
+
+  if (image_sequence_) {
+    sequence_filename_ = GetSequenceFilename(params().filename());
+    first_index_ = Decoder::GetImageSequenceIndex(sequence_filename_);
+  }
+
+  compression_ = params().video_opts().value(QStringLiteral("compression"));
+
+  pending_writes_ = 0;
+  write_failed_ = false;
+  written_indexes_.clear();
+
+  return true;
+}
+
+bool OIIOEncoder::WriteFrame(FramePtr frame, rational time)
+{
+  int64_t index = Timecode::time_to_timestamp(time, params().video_params().time_base());
+  QString filename = GetFrameFilename(index);
+
+  pending_lock_.lock();
+
+  if (write_failed_) {
+    pending_lock_.unlock();
+    return false;
+  }
+
+  // Recorded before writing so a partially written file is still found and cleaned up
+  written_indexes_.append(index);
+
+  if (pending_writes_ >= max_pending_writes_) {
+    // Every writer is busy, write this one ourselves rather than holding even more frames in memory
+    pending_lock_.unlock();
+    return WriteImage(frame, filename);
+  }
+
+  pending_writes_++;
+
+  pending_lock_.unlock();
+
+  writers_.Run([this, frame, filename]{
+    bool success = WriteImage(frame, filename);
+
+    pending_lock_.lock();
+    pending_writes_--;
+    write_failed_ |= !success;
+    pending_lock_.unlock();
+  });
+
+  return true;
+}
+
+void OIIOEncoder::WriteAudio(AudioParams pcm_info, QIODevice *file)
+{
+  Q_UNUSED(pcm_info)
+  Q_UNUSED(file)
+
+  qWarning() << "OIIOEncoder cannot encode audio";
+}
+
+void OIIOEncoder::Close()
+{
+  // Finish writing any frames still in the background
+  writers_.Wait();
+
+  if (write_failed_) {
+    qWarning() << "Failed to write one or more images for" << params().filename();
+  }
+}
+
+bool OIIOEncoder::HasError() const
+{
+  QMutexLocker locker(&pending_lock_);
+
+  return write_failed_;
+}
+
+QString OIIOEncoder::GetFrameFilename(int64_t index) const
+{
+  if (!image_sequence_) {
+    return params().filename();
+  }
+
+  return Decoder::TransformImageSequenceFileName(sequence_filename_, first_index_ + index);
+}
+
+QStringList OIIOEncoder::GetWrittenFilenames(const QString &filename) const
+{
+  if (!image_sequence_) {
+    return QStringList(filename);
+  }
+
+  QString sequence_filename = GetSequenceFilename(filename);
+  int64_t first_index = Decoder::GetImageSequenceIndex(sequence_filename);
+
+  QMutexLocker locker(&pending_lock_);
+
+  QStringList filenames;
+  filenames.reserve(written_indexes_.size());
+
+  foreach (int64_t index, written_indexes_) {
+    filenames.append(Decoder::TransformImageSequenceFileName(sequence_filename, first_index + index));
+  }
+
+  return filenames;
+}
+
+QString OIIOEncoder::GetSequenceFilename(const QString &filename) const
+{
+  if (Decoder::GetImageSequenceDigitCount(filename) > 0) {
+    // Filename already has a number in it, continue from there
+    return filename;
+  }
+
+  // Add a number to the filename with enough digits that the whole sequence sorts correctly
+  int64_t frame_count = Timecode::time_to_timestamp(params().GetExportLength(),
+                                                    params().video_params().time_base());
+
+  int digit_count = qMax(4, QString::number(frame_count).size());
+
+  QFileInfo info(filename);
+  QString suffix = info.completeSuffix();
+  if (!suffix.isEmpty()) {
+    suffix.prepend('.');
+  }
+
+  return info.dir().filePath(QStringLiteral("%1_%2%3").arg(info.baseName(),
+                                                           QString(digit_count, '0'),
+                                                           suffix));
+}
+
+bool OIIOEncoder::WriteImage(FramePtr frame, const QString &filename)
+{
+  std::string filename_std = filename.toStdString();
+
+  std::unique_ptr<OIIO::ImageOutput> out = OIIO::ImageOutput::create(filename_std);
+  if (!out) {
+    return false;
+  }
+
+  OIIO::TypeDesc type = OIIOUtils::GetOIIOBaseTypeFromFormat(frame->format());
+
+  // Plugins that don't support this format will pick the closest one they do
+  OIIO::ImageSpec spec(frame->width(), frame->height(), frame->channel_count(), type);
+
+  spec.attribute("PixelAspectRatio", static_cast<float>(params().video_params().pixel_aspect_ratio().toDouble()));
+
+  if (!compression_.isEmpty()) {
+    spec.attribute("compression", compression_.toStdString());
+
+    // Older versions of OIIO only take PNG's level from its own attribute
+    if (compression_.startsWith(QStringLiteral("zip:"))) {
+      spec.attribute("png:compressionLevel", compression_.mid(4).toInt());
+    }
+  }
+
+  if (!out->open(filename_std, spec)) {
+    qWarning() << "Failed to open" << filename << "for writing:" << out->geterror().c_str();
+    return false;
+  }
+
+  bool success = out->write_image(type,
+                                  frame->const_data(),
+                                  OIIO::AutoStride,
+                                  frame->linesize_bytes());
+
+  if (!success) {
+    qWarning() << "Failed to write" << filename << "-" << out->geterror().c_str();
+  }
+
+  out->close();
+
+  return success;
+}
+
+}
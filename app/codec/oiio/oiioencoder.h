@@ -0,0 +1,108 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef OIIOENCODER_H
+#define OIIOENCODER_H
+
+#include <QMutex>
+#include <QVector>
+
+#include "codec/encoder.h"
+#include "threading/workstealingexecutor.h"
+
+namespace olive {
+
+/**
+ * @brief An Encoder that writes still images and image sequences through OpenImageIO
+ *
+ * Every frame of an image sequence is its own file, so frames are written in the background as
+ * soon as they're received, in any order, several at a time. Compressing images (particularly
+ * OpenEXR) is slow enough that this is usually where an image sequence export spends its time.
+ */
+class OIIOEncoder : public Encoder
+{
+  Q_OBJECT
+public:
+  OIIOEncoder(const EncodingParams &params);
+
+  virtual ~OIIOEncoder() override;
+
+  virtual bool Open() override;
+
+  virtual bool WriteFrame(olive::FramePtr frame, olive::rational time) override;
+
+  virtual void WriteAudio(olive::AudioParams pcm_info,
+                          QIODevice *file) override;
+
+  virtual void Close() override;
+
+  virtual bool HasError() const override;
+
+  virtual VideoParams::Format GetDesiredPixelFormat() const override
+  {
+    return params().video_params().format();
+  }
+
+  virtual bool RequiresOrderedFrames() const override
+  {
+    return false;
+  }
+
+  /**
+   * @brief Get the filename the frame at `index` (in the video's timebase) is written to
+   *
+   * If the filename already ends with a number, it's used as the first frame's number and its
+   * amount of digits. Otherwise, a number with enough digits for the whole export is added to the
+   * end of the name.
+   */
+  QString GetFrameFilename(int64_t index) const;
+
+  virtual QStringList GetWrittenFilenames(const QString& filename) const override;
+
+private:
+  QString GetSequenceFilename(const QString& filename) const;
+
+  bool WriteImage(FramePtr frame, const QString& filename);
+
+  bool image_sequence_;
+
+  QString sequence_filename_;
+
+  QVector<int64_t> written_indexes_;
+
+  int64_t first_index_;
+
+  QString compression_;
+
+  TaskGroup writers_;
+
+  int max_pending_writes_;
+
+  int pending_writes_;
+
+  bool write_failed_;
+
+  mutable QMutex pending_lock_;
+
+};
+
+}
+
+#endif // OIIOENCODER_H
@@ -20,8 +20,50 @@
 
 #include "samplebuffer.h"
 
+#include <QtMath>
+
 namespace olive {
 
+namespace {
+
+// Zero crossings on each side of the sinc kernel
+const int kSincZeroCrossings = 16;
+
+// Table entries per zero crossing, values between entries are linearly interpolated
+const int kSincResolution = 512;
+
+// Past this rate we stop widening the kernel and accept some aliasing to bound the cost per sample
+const double kMaxKernelRate = 8.0;
+
+const QVector<float>& GetSincTable()
+{
+  // One half of a Blackman-windowed sinc, built the first time it's needed
+  static const QVector<float> table = [](){
+    QVector<float> t(kSincZeroCrossings * kSincResolution + 1);
+
+    t[0] = 1.0f;
+
+    for (int i=1;i<t.size();i++) {
+      double x = static_cast<double>(i) / kSincResolution;
+      double sinc = qSin(M_PI * x) / (M_PI * x);
+      double window = 0.42
+          + 0.5 * qCos(M_PI * x / kSincZeroCrossings)
+          + 0.08 * qCos(2.0 * M_PI * x / kSincZeroCrossings);
+
+      t[i] = static_cast<float>(sinc * window);
+    }
+
+    // Last entry is the edge of the window
+    t[t.size() - 1] = 0.0f;
+
+    return t;
+  }();
+
+  return table;
+}
+
+}
+
 SampleBuffer::SampleBuffer() :
   sample_count_per_channel_(0),
   data_(nullptr)
@@ -61,18 +103,50 @@ SampleBufferPtr SampleBuffer::CreateFromPackedData(const AudioParams &audio_para
     return nullptr;
   }
 
-  int samples_per_channel = audio_params.bytes_to_samples(bytes.size());
-  SampleBufferPtr buffer = CreateAllocated(audio_params, samples_per_channel);
+  return CreateFromPackedData(audio_params, bytes.constData(), audio_params.bytes_to_samples(bytes.size()));
+}
 
-  int total_samples = samples_per_channel * audio_params.channel_count();
+SampleBufferPtr SampleBuffer::CreateFromPackedData(const AudioParams &audio_params, const char *data, int samples_per_channel)
+{
+  if (!audio_params.is_valid()) {
+    qWarning() << "Tried to create from packed data with invalid parameters";
+    return nullptr;
+  }
 
-  const float* packed_data = reinterpret_cast<const float*>(bytes.constData());
+  SampleBufferPtr buffer = CreateAllocated(audio_params, samples_per_channel);
 
-  for (int i=0;i<total_samples;i++) {
-    int channel = i % audio_params.channel_count();
-    int index = i / audio_params.channel_count();
+  int nb_channels = audio_params.channel_count();
+
+  const float* packed_data = reinterpret_cast<const float*>(data);
+
+  // De-interleave one channel at a time so each destination is written contiguously, which the
+  // compiler can vectorize. Mono and stereo are by far the most common, so they get their own
+  // loops.
+  switch (nb_channels) {
+  case 1:
+    memcpy(buffer->data_[0], packed_data, samples_per_channel * sizeof(float));
+    break;
+  case 2:
+  {
+    float* left = buffer->data_[0];
+    float* right = buffer->data_[1];
+
+    for (int i=0;i<samples_per_channel;i++) {
+      left[i] = packed_data[i*2];
+      right[i] = packed_data[i*2 + 1];
+    }
+    break;
+  }
+  default:
+    for (int channel=0;channel<nb_channels;channel++) {
+      float* dst = buffer->data_[channel];
+      const float* src = packed_data + channel;
 
-    buffer->data_[channel][index] = packed_data[i];
+      for (int i=0;i<samples_per_channel;i++) {
+        dst[i] = src[i*nb_channels];
+      }
+    }
+    break;
   }
 
   return buffer;
@@ -178,23 +252,108 @@ void SampleBuffer::speed(double speed)
     return;
   }
 
-  sample_count_per_channel_ = qRound(static_cast<double>(sample_count_per_channel_) / speed);
+  QVector<double> positions(qRound(static_cast<double>(sample_count_per_channel_) / speed));
+
+  for (int i=0;i<positions.size();i++) {
+    positions[i] = static_cast<double>(i) * speed;
+  }
+
+  resample(positions);
+}
+
+void SampleBuffer::resample(const QVector<double> &positions)
+{
+  if (!is_allocated()) {
+    qWarning() << "Tried to resample an unallocated sample buffer";
+    return;
+  }
+
+  if (positions.isEmpty()) {
+    destroy();
+    sample_count_per_channel_ = 0;
+    return;
+  }
+
+  const QVector<float>& table = GetSincTable();
+  const int table_max = table.size() - 1;
+
+  int input_count = sample_count_per_channel_;
+  int output_count = positions.size();
 
   float** input_data = data_;
   float** output_data;
 
-  allocate_sample_buffer(&output_data, audio_params_.channel_count(), sample_count_per_channel_);
+  allocate_sample_buffer(&output_data, audio_params_.channel_count(), output_count);
 
-  for (int i=0;i<sample_count_per_channel_;i++) {
-    int input_index = qFloor(static_cast<double>(i) * speed);
+  // Weights are calculated once per output sample and shared between channels
+  QVector<float> weights(2 * qCeil(kSincZeroCrossings * kMaxKernelRate) + 2);
+
+  for (int i=0;i<output_count;i++) {
+    double center = positions.at(i);
+
+    // The local rate determines how far we need to lower the cutoff to avoid aliasing
+    double rate;
+    if (output_count == 1) {
+      rate = 1.0;
+    } else if (i < output_count - 1) {
+      rate = qAbs(positions.at(i + 1) - center);
+    } else {
+      rate = qAbs(center - positions.at(i - 1));
+    }
+
+    double scale = 1.0 / qBound(1.0, rate, kMaxKernelRate);
+    double radius = kSincZeroCrossings / scale;
+
+    int first = qMax(0, qCeil(center - radius));
+    int last = qMin(input_count - 1, qFloor(center + radius));
+
+    float weight_sum = 0.0f;
+
+    for (int k=first;k<=last;k++) {
+      double table_pos = qAbs(center - k) * scale * kSincResolution;
+      int index = static_cast<int>(table_pos);
+      float w;
+
+      if (index >= table_max) {
+        w = 0.0f;
+      } else {
+        float frac = static_cast<float>(table_pos - index);
+        w = table.at(index) + (table.at(index + 1) - table.at(index)) * frac;
+      }
+
+      weights[k - first] = w;
+      weight_sum += w;
+    }
+
+    if (first > last || qFuzzyIsNull(weight_sum)) {
+      // Entirely outside of the input
+      for (int j=0;j<audio_params_.channel_count();j++) {
+        output_data[j][i] = 0.0f;
+      }
+      continue;
+    }
+
+    // Normalizing keeps the gain at unity regardless of the phase, or where the kernel has been
+    // cut off by the edges of the buffer
+    float normalize = 1.0f / weight_sum;
+    int tap_count = last - first + 1;
+    const float* w = weights.constData();
 
     for (int j=0;j<audio_params_.channel_count();j++) {
-      output_data[j][i] = input_data[j][input_index];
+      const float* in = input_data[j] + first;
+      float sum = 0.0f;
+
+      for (int k=0;k<tap_count;k++) {
+        sum += in[k] * w[k];
+      }
+
+      output_data[j][i] = sum * normalize;
     }
   }
 
   destroy_sample_buffer(&input_data, audio_params_.channel_count());
 
+  sample_count_per_channel_ = output_count;
   data_ = output_data;
 }
 
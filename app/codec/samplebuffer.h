@@ -49,6 +49,7 @@ public:
   static SampleBufferPtr CreateAllocated(const AudioParams& audio_params, const rational& length);
   static SampleBufferPtr CreateAllocated(const AudioParams& audio_params, int samples_per_channel);
   static SampleBufferPtr CreateFromPackedData(const AudioParams& audio_params, const QByteArray& bytes);
+  static SampleBufferPtr CreateFromPackedData(const AudioParams& audio_params, const char* data, int samples_per_channel);
 
   DISABLE_COPY_MOVE(SampleBuffer)
 
@@ -68,6 +69,18 @@ public:
 
   void reverse();
   void speed(double speed);
+
+  /**
+   * @brief Resample this buffer to an arbitrary set of sample positions
+   *
+   * Each entry in `positions` is the (fractional) sample index of the current buffer that the
+   * corresponding output sample should be taken from, so the buffer's new sample count is
+   * `positions.size()`. This allows speeds that change over time.
+   *
+   * Samples are interpolated with a windowed sinc whose cutoff follows the local rate, so speeding
+   * up audio doesn't alias.
+   */
+  void resample(const QVector<double>& positions);
   void transform_volume(float f);
   void transform_volume_for_channel(int channel, float volume);
   void transform_volume_for_sample(int sample_index, float volume);
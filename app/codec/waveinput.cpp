@@ -187,6 +187,15 @@ qint64 WaveInput::read(int offset, char *buffer, int length)
   return file_.read(buffer, qMin(calculate_max_read(), static_cast<qint64>(length)));
 }
 
+const char *WaveInput::map()
+{
+  if (!is_open() || !data_size_) {
+    return nullptr;
+  }
+
+  return reinterpret_cast<const char*>(file_.map(data_position_, data_size_));
+}
+
 bool WaveInput::seek(qint64 pos)
 {
   return file_.seek(data_position_ + qMin(pos, static_cast<qint64>(data_size_)));
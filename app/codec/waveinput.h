@@ -44,6 +44,14 @@ public:
   QByteArray read(int offset, int length);
   qint64 read(int offset, char *buffer, int length);
 
+  /**
+   * @brief Memory-map the data section of the file
+   *
+   * Returns a pointer to the first byte of audio data (data_length() bytes long), or nullptr if
+   * the file couldn't be mapped. The mapping is valid until close() is called.
+   */
+  const char* map();
+
   bool seek(qint64 pos);
 
   bool at_end() const;
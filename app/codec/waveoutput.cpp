@@ -27,6 +27,8 @@ namespace olive {
 const int16_t kWAVIntegerFormat = 1;
 const int16_t kWAVFloatFormat = 3;
 
+const int WaveOutput::kHeaderSize = 44;
+
 WaveOutput::WaveOutput(const QString &f,
                        const AudioParams& params) :
   file_(f),
@@ -106,6 +108,27 @@ bool WaveOutput::open()
   return false;
 }
 
+bool WaveOutput::resume(qint64 data_length)
+{
+  if (file_.open(QFile::ReadWrite)) {
+    qint64 valid_size = kHeaderSize + data_length;
+
+    if (file_.size() >= valid_size) {
+      // Discard anything written after the last point we know was good
+      file_.resize(valid_size);
+      file_.seek(valid_size);
+
+      data_length_ = data_length;
+
+      return true;
+    }
+
+    file_.close();
+  }
+
+  return false;
+}
+
 void WaveOutput::write(const QByteArray &bytes)
 {
   if (file_.isOpen()) {
@@ -124,22 +147,29 @@ void WaveOutput::write(const char *bytes, int length)
   }
 }
 
+void WaveOutput::flush()
+{
+  if (file_.isOpen()) {
+    file_.flush();
+  }
+}
+
 void WaveOutput::close()
 {
   if (file_.isOpen()) {
 
     // Write file sizes
     file_.seek(4);
-    write_int<int32_t>(&file_, data_length_ + 36);
+    write_int<int32_t>(&file_, static_cast<int32_t>(data_length_ + 36));
 
     file_.seek(40);
-    write_int<int32_t>(&file_, data_length_);
+    write_int<int32_t>(&file_, static_cast<int32_t>(data_length_));
 
     file_.close();
   }
 }
 
-const int& WaveOutput::data_length() const
+const qint64& WaveOutput::data_length() const
 {
   return data_length_;
 }
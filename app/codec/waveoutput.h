@@ -40,15 +40,32 @@ public:
 
   bool open();
 
+  /**
+   * @brief Re-open a file previously written by WaveOutput and continue writing after `data_length` bytes
+   *
+   * Anything in the file past that point is discarded.
+   */
+  bool resume(qint64 data_length);
+
   void write(const QByteArray& bytes);
   void write(const char* bytes, int length);
 
+  /**
+   * @brief Flush written data to disk so other readers of the file can see it
+   */
+  void flush();
+
   void close();
 
-  const int& data_length() const;
+  const qint64& data_length() const;
 
   const AudioParams& params() const;
 
+  /**
+   * @brief Size of the header written by open(), i.e. the offset of the first byte of audio data
+   */
+  static const int kHeaderSize;
+
 private:
   template<typename T>
   void write_int(QFile* file, T integer);
@@ -59,7 +76,7 @@ private:
 
   AudioParams params_;
 
-  int data_length_;
+  qint64 data_length_;
 
 };
 
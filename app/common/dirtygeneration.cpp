@@ -0,0 +1,38 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "dirtygeneration.h"
+
+#include <QAtomicInteger>
+
+namespace olive {
+
+namespace {
+
+QAtomicInteger<quint64> dirty_generation_counter;
+
+}
+
+quint64 NextDirtyGeneration()
+{
+  return dirty_generation_counter.fetchAndAddOrdered(1) + 1;
+}
+
+}
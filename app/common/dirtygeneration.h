@@ -0,0 +1,41 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef DIRTYGENERATION_H
+#define DIRTYGENERATION_H
+
+#include <QtGlobal>
+
+namespace olive {
+
+/**
+ * @brief Get a new dirty generation
+ *
+ * Generations increase monotonically across the whole application. Objects record a new one every
+ * time they change, so comparing an object's generation against one recorded earlier tells
+ * whether it has changed since.
+ *
+ * This function is thread safe.
+ */
+quint64 NextDirtyGeneration();
+
+}
+
+#endif // DIRTYGENERATION_H
@@ -0,0 +1,100 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "tick.h"
+
+#include <cmath>
+
+namespace olive {
+
+// 2^9 * 3^2 * 5^5 * 7^2, divisible by 24000/1001, 25, 30000/1001, 48, 50, 60000/1001, 120, 44100,
+// 48000, 96000, 192000, etc.
+const int64_t Tick::kPerSecond = 705600000;
+
+int64_t Tick::from_time(const rational &time)
+{
+  if (time.isNull()) {
+    return 0;
+  }
+
+  int64_t numer = time.numerator();
+  int64_t denom = time.denominator();
+
+  // Divide first so the multiplication can't overflow on any sane time. Both round towards zero,
+  // so the remainder has the same sign as the time. The numerator isn't negated since
+  // RATIONAL_MIN's can't be.
+  int64_t whole = numer / denom;
+  int64_t remainder = numer % denom;
+
+  if (whole > (INT64_MAX - kPerSecond) / kPerSecond) {
+    return INT64_MAX;
+  } else if (whole < (INT64_MIN + kPerSecond) / kPerSecond) {
+    return INT64_MIN;
+  }
+
+  int64_t ticks = whole * kPerSecond;
+
+  if (remainder) {
+    // |remainder| < denom, so this only overflows for denominators beyond any real timebase.
+    // Halves round away from zero so negative times mirror positive ones.
+    int64_t scaled = remainder * kPerSecond;
+
+    ticks += (scaled > 0) ? (scaled + denom / 2) / denom : (scaled - denom / 2) / denom;
+  }
+
+  return ticks;
+}
+
+bool Tick::is_exact(const rational &time)
+{
+  return time.isNull() || kPerSecond % time.denominator() == 0;
+}
+
+rational Tick::to_time(const int64_t &ticks)
+{
+  if (ticks == INT64_MIN) {
+    return RATIONAL_MIN;
+  } else if (ticks == INT64_MAX) {
+    return RATIONAL_MAX;
+  }
+
+  return rational(ticks, kPerSecond);
+}
+
+int64_t Tick::from_seconds(const double &seconds)
+{
+  return std::llround(seconds * kPerSecond);
+}
+
+double Tick::to_seconds(const int64_t &ticks)
+{
+  return static_cast<double>(ticks) / static_cast<double>(kPerSecond);
+}
+
+int64_t Tick::per_timebase(const rational &timebase)
+{
+  if (timebase.isNull() || !is_exact(timebase)) {
+    return 0;
+  }
+
+  return from_time(timebase);
+}
+
+}
@@ -0,0 +1,71 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef TICK_H
+#define TICK_H
+
+#include "common/rational.h"
+
+namespace olive {
+
+/**
+ * @brief Functions for converting between rational times and integer ticks
+ *
+ * A tick is a fixed fraction of a second (1/705600000, otherwise known as a "flick") that evenly
+ * divides every common frame rate (including NTSC rates) and audio sample rate. Times on those
+ * timebases convert to ticks losslessly, and ticks compare and hash as plain integers without the
+ * cross-multiplication and GCD reduction of rational.
+ *
+ * Ticks are meant for hot paths such as cache maps and per-sample loops. Convert at the edges and
+ * keep rational everywhere else.
+ */
+class Tick {
+public:
+  static const int64_t kPerSecond;
+
+  /**
+   * @brief Convert a time to ticks, rounding to the nearest tick if it isn't exact
+   *
+   * Times too large to fit are clamped, so RATIONAL_MIN and RATIONAL_MAX map to INT64_MIN and
+   * INT64_MAX.
+   */
+  static int64_t from_time(const rational& time);
+
+  /**
+   * @brief Returns whether `time` converts to ticks without rounding
+   */
+  static bool is_exact(const rational& time);
+
+  static rational to_time(const int64_t& ticks);
+
+  static int64_t from_seconds(const double& seconds);
+
+  static double to_seconds(const int64_t& ticks);
+
+  /**
+   * @brief Ticks per unit of `timebase`, or 0 if timebase isn't a whole number of ticks
+   */
+  static int64_t per_timebase(const rational& timebase);
+
+};
+
+}
+
+#endif // TICK_H
@@ -20,6 +20,7 @@
 
 #include "timerange.h"
 
+#include <algorithm>
 #include <QtMath>
 #include <utility>
 
@@ -176,64 +177,113 @@ void TimeRange::normalize()
   length_ = out_ - in_;
 }
 
+TimeRangeList::TimeRangeList(std::initializer_list<TimeRange> r)
+{
+  foreach (const TimeRange& range, r) {
+    insert(range);
+  }
+}
+
 void TimeRangeList::insert(TimeRange range_to_add)
 {
-  // See if list contains this range
-  if (contains(range_to_add)) {
+  // Ranges that overlap or touch the new range are merged with it
+  int first = FirstEndingAfter(range_to_add.in(), true);
+  int last = FirstStartingAfter(range_to_add.out(), true);
+
+  if (first == last) {
+    // Touches nothing, just slot it in
+    array_.insert(first, range_to_add);
     return;
   }
 
-  // Does not contain range, so we'll almost certainly be adding it in some way
-  for (int i=0;i<size();i++) {
-    const TimeRange& compare = array_.at(i);
+  if (last - first == 1 && array_.at(first).Contains(range_to_add)) {
+    // Already in the list
+    return;
+  }
+
+  array_[first] = TimeRange(qMin(array_.at(first).in(), range_to_add.in()),
+                            qMax(array_.at(last - 1).out(), range_to_add.out()));
+
+  array_.remove(first + 1, last - first - 1);
+}
+
+void TimeRangeList::insert(const TimeRangeList &list_to_add)
+{
+  if (list_to_add.isEmpty()) {
+    return;
+  } else if (isEmpty()) {
+    array_ = list_to_add.array_;
+    return;
+  }
+
+  // Both lists are sorted, so they can be merged in a single pass
+  QVector<TimeRange> merged;
+  merged.reserve(array_.size() + list_to_add.size());
+
+  int i = 0, j = 0;
 
-    if (compare.OverlapsWith(range_to_add)) {
-      range_to_add = TimeRange::Combine(range_to_add, compare);
-      array_.removeAt(i);
-      i--;
+  while (i < array_.size() || j < list_to_add.size()) {
+    const TimeRange& next = (j == list_to_add.size() || (i < array_.size() && array_.at(i).in() < list_to_add.array_.at(j).in()))
+        ? array_.at(i++) : list_to_add.array_.at(j++);
+
+    if (!merged.isEmpty() && next.in() <= merged.last().out()) {
+      if (next.out() > merged.last().out()) {
+        merged.last().set_out(next.out());
+      }
+    } else {
+      merged.append(next);
     }
   }
 
-  array_.append(range_to_add);
+  array_ = merged;
 }
 
 void TimeRangeList::remove(const TimeRange &remove)
 {
-  int sz = this->size();
-
-  for (int i=0;i<sz;i++) {
-    TimeRange& compare = array_[i];
-
-    if (remove.Contains(compare)) {
-      // This element is entirely encompassed in this range, remove it
-      array_.removeAt(i);
-      i--;
-      sz--;
-    } else if (compare.Contains(remove, false, false)) {
-      // The remove range is within this element, only choice is to split the element into two
-      TimeRange new_range(remove.out(), compare.out());
-      compare.set_out(remove.in());
-      insert(new_range);
-      break;
-    } else if (compare.in() < remove.in() && compare.out() > remove.in()) {
-      // This element's out point overlaps the range's in, we'll trim it
-      compare.set_out(remove.in());
-    } else if (compare.in() < remove.out() && compare.out() > remove.out()) {
-      // This element's in point overlaps the range's out, we'll trim it
-      compare.set_in(remove.out());
-    }
+  if (remove.length().isNull()) {
+    // Nothing to remove, and splitting a range here would leave two that touch
+    return;
+  }
+
+  // Only ranges that overlap the removal (rather than just touch it) are affected
+  int first = FirstEndingAfter(remove.in(), false);
+  int last = FirstStartingAfter(remove.out(), false);
+
+  if (first >= last) {
+    return;
+  }
+
+  // Whatever's left either side of the removed range
+  QVector<TimeRange> remainder;
+
+  if (array_.at(first).in() < remove.in()) {
+    remainder.append(TimeRange(array_.at(first).in(), remove.in()));
+  }
+
+  if (array_.at(last - 1).out() > remove.out()) {
+    remainder.append(TimeRange(remove.out(), array_.at(last - 1).out()));
+  }
+
+  array_.remove(first, last - first);
+
+  for (int i=0; i<remainder.size(); i++) {
+    array_.insert(first + i, remainder.at(i));
   }
 }
 
-bool TimeRangeList::contains(const TimeRange &range, bool in_inclusive, bool out_inclusive) const
+void TimeRangeList::remove(const TimeRangeList &list_to_remove)
 {
-  for (int i=0;i<size();i++) {
-    if (array_.at(i).Contains(range, in_inclusive, out_inclusive)) {
-      return true;
-    }
+  foreach (const TimeRange& r, list_to_remove) {
+    remove(r);
   }
+}
 
-  return false;
+bool TimeRangeList::contains(const TimeRange &range, bool in_inclusive, bool out_inclusive) const
+{
+  // Ranges are coalesced, so only the last one starting at or before `range` can contain it
+  int index = FirstStartingAfter(range.in(), true) - 1;
+
+  return index >= 0 && array_.at(index).Contains(range, in_inclusive, out_inclusive);
 }
 
 void TimeRangeList::shift(const rational &diff)
@@ -273,24 +323,54 @@ TimeRangeList TimeRangeList::Intersects(const TimeRange &range) const
 {
   TimeRangeList intersect_list;
 
-  for (int i=0;i<size();i++) {
-    const TimeRange& compare = array_.at(i);
+  int first = FirstEndingAfter(range.in(), false);
+  int last = FirstStartingAfter(range.out(), false);
 
-    if (compare.out() <= range.in() || compare.in() >= range.out()) {
-      // No intersect
-      continue;
-    } else {
-      // Crop the time range to the range and add it to the list
-      TimeRange cropped(qMax(range.in(), compare.in()),
-                        qMin(range.out(), compare.out()));
+  // Cropped ranges stay sorted and apart, so they can go straight into the list
+  for (int i=first; i<last; i++) {
+    const TimeRange& compare = array_.at(i);
 
-      intersect_list.insert(cropped);
-    }
+    intersect_list.array_.append(TimeRange(qMax(range.in(), compare.in()),
+                                           qMin(range.out(), compare.out())));
   }
 
   return intersect_list;
 }
 
+int TimeRangeList::FirstEndingAfter(const rational &time, bool inclusive) const
+{
+  QVector<TimeRange>::const_iterator it;
+
+  if (inclusive) {
+    it = std::lower_bound(array_.cbegin(), array_.cend(), time, [](const TimeRange& r, const rational& t){
+      return r.out() < t;
+    });
+  } else {
+    it = std::upper_bound(array_.cbegin(), array_.cend(), time, [](const rational& t, const TimeRange& r){
+      return t < r.out();
+    });
+  }
+
+  return it - array_.cbegin();
+}
+
+int TimeRangeList::FirstStartingAfter(const rational &time, bool inclusive) const
+{
+  QVector<TimeRange>::const_iterator it;
+
+  if (inclusive) {
+    it = std::upper_bound(array_.cbegin(), array_.cend(), time, [](const rational& t, const TimeRange& r){
+      return t < r.in();
+    });
+  } else {
+    it = std::lower_bound(array_.cbegin(), array_.cend(), time, [](const TimeRange& r, const rational& t){
+      return r.in() < t;
+    });
+  }
+
+  return it - array_.cbegin();
+}
+
 uint qHash(const TimeRange &r, uint seed)
 {
   return qHash(r.in(), seed) ^ qHash(r.out(), seed);
@@ -67,19 +67,29 @@ private:
 
 };
 
+/**
+ * @brief A set of times stored as ranges
+ *
+ * Ranges are kept sorted and coalesced (no two ranges overlap or touch), so lookups are binary
+ * searches and iterating always goes from earliest to latest.
+ */
 class TimeRangeList {
 public:
   TimeRangeList() = default;
 
-  TimeRangeList(std::initializer_list<TimeRange> r) :
-    array_(r)
-  {
-  }
+  TimeRangeList(std::initializer_list<TimeRange> r);
 
   void insert(TimeRange range_to_add);
 
+  /**
+   * @brief Insert every range of another list, merging the two lists in one pass
+   */
+  void insert(const TimeRangeList& list_to_add);
+
   void remove(const TimeRange& remove);
 
+  void remove(const TimeRangeList& list_to_remove);
+
   bool contains(const TimeRange& range, bool in_inclusive = true, bool out_inclusive = true) const;
 
   bool isEmpty() const
@@ -133,6 +143,18 @@ public:
   }
 
 private:
+  /**
+   * @brief Index of the first range that ends at or after `time` (or strictly after if `inclusive`
+   * is FALSE)
+   */
+  int FirstEndingAfter(const rational& time, bool inclusive) const;
+
+  /**
+   * @brief Index of the first range that starts after `time` (or at or after if `inclusive` is
+   * FALSE)
+   */
+  int FirstStartingAfter(const rational& time, bool inclusive) const;
+
   QVector<TimeRange> array_;
 
 };
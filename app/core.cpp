@@ -22,7 +22,9 @@
 
 #include <QApplication>
 #include <QClipboard>
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QHBoxLayout>
@@ -52,15 +54,20 @@
 #include "render/colormanager.h"
 #include "render/diskmanager.h"
 #include "render/rendermanager.h"
+#include "task/export/renderqueue.h"
 #ifdef USE_OTIO
 #include "task/project/loadotio/loadotio.h"
 #include "task/project/saveotio/saveotio.h"
 #endif
 #include "task/project/import/import.h"
 #include "task/project/import/importerrordialog.h"
+#include "task/project/journal/projectjournal.h"
 #include "task/project/load/load.h"
+#include "task/project/loadbinary/loadbinary.h"
 #include "task/project/save/save.h"
+#include "task/project/savebinary/savebinary.h"
 #include "task/taskmanager.h"
+#include "threading/workstealingexecutor.h"
 #include "ui/style/style.h"
 #include "undo/undostack.h"
 #include "widget/menu/menushared.h"
@@ -134,6 +141,10 @@ void Core::Start()
 
   // Initialize task manager
   TaskManager::CreateInstance();
+  RenderQueue::CreateInstance();
+
+  // Initialize executor for splitting up work within a single render
+  WorkStealingExecutor::CreateInstance();
 
   // Initialize RenderManager
   RenderManager::CreateInstance();
@@ -180,8 +191,11 @@ void Core::Stop()
 
   RenderManager::DestroyInstance();
 
+  WorkStealingExecutor::DestroyInstance();
+
   MenuShared::DestroyInstance();
 
+  RenderQueue::DestroyInstance();
   TaskManager::DestroyInstance();
 
   PanelManager::DestroyInstance();
@@ -540,11 +554,19 @@ bool Core::StartHeadlessExport()
   }
 
   // Start a load task and try running it
-  ProjectLoadTask plm(startup_project);
-  CLITaskDialog task_dialog(&plm);
+  std::unique_ptr<ProjectLoadBaseTask> plm;
+
+  if (startup_project.endsWith(QStringLiteral(".ovb"), Qt::CaseInsensitive)
+      || startup_project.endsWith(QStringLiteral(".ovj"), Qt::CaseInsensitive)) {
+    plm = std::unique_ptr<ProjectLoadBaseTask>(new ProjectLoadBinaryTask(startup_project));
+  } else {
+    plm = std::unique_ptr<ProjectLoadBaseTask>(new ProjectLoadTask(startup_project));
+  }
+
+  CLITaskDialog task_dialog(plm.get());
 
   if (task_dialog.Run()) {
-    std::unique_ptr<Project> p = std::unique_ptr<Project>(plm.GetLoadedProject());
+    std::unique_ptr<Project> p = std::unique_ptr<Project>(plm->GetLoadedProject());
     QVector<Item*> items = p->get_items_of_type(Item::kSequence);
 
     // Check if this project contains sequences
@@ -628,6 +650,8 @@ void Core::OpenStartupProject()
     // If no load project is set, create a new one on open
     CreateNewProject();
   }
+
+  PromptToRecoverJournals();
 }
 
 void Core::StartGUI(bool full_screen)
@@ -709,6 +733,8 @@ void Core::SaveProjectInternal(Project* project)
                              "cannot open OpenTimelineIO files."));
     return;
 #endif
+  } else if (project->filename().endsWith(QStringLiteral(".ovb"), Qt::CaseInsensitive)) {
+    psm = new ProjectSaveBinaryTask(project);
   } else {
     psm = new ProjectSaveTask(project);
   }
@@ -754,8 +780,24 @@ void Core::SaveAutorecovery()
 {
   foreach (Project* p, open_projects_) {
     if (!p->has_autorecovery_been_saved()) {
-      // FIXME: SAVE AN AUTORECOVERY PROJECT
-      p->set_autorecovery_saved(true);
+      ProjectJournal* journal = autorecovery_journals_.value(p);
+
+      if (!journal) {
+        QDir autorecovery_dir(GetAutorecoveryDirectory());
+        autorecovery_dir.mkpath(QStringLiteral("."));
+
+        QString base_name = p->filename().isEmpty() ? QStringLiteral("untitled") : QFileInfo(p->filename()).completeBaseName();
+
+        journal = new ProjectJournal(autorecovery_dir.filePath(QStringLiteral("%1-%2.ovj").arg(base_name,
+                                                                                              QString::number(QDateTime::currentMSecsSinceEpoch()))),
+                                     p->filename());
+        autorecovery_journals_.insert(p, journal);
+      }
+
+      // If the last write is still going, leave this project flagged and try again next time
+      if (journal->Write(p)) {
+        p->set_autorecovery_saved(true);
+      }
     }
   }
 }
@@ -888,15 +930,25 @@ QString Core::GetProjectFilter(bool include_any_filter)
 {
   QString filters;
 
-#ifdef USE_OTIO
   if (include_any_filter) {
-    filters.append(QStringLiteral("All Supported Projects (*.ove *.otio);;"));
-  }
+#ifdef USE_OTIO
+    filters.append(QStringLiteral("All Supported Projects (*.ove *.ovb *.ovj *.otio);;"));
+#else
+    filters.append(QStringLiteral("All Supported Projects (*.ove *.ovb *.ovj);;"));
 #endif
+  }
 
   // Append standard filter
   filters.append(QStringLiteral("%1 (*.ove)").arg(tr("Olive Project")));
 
+  // Binary projects are faster to open and save but aren't meant for interchange
+  filters.append(QStringLiteral(";;%1 (*.ovb)").arg(tr("Olive Binary Project")));
+
+  if (include_any_filter) {
+    // Journals can be opened to recover a project, but projects are never saved as them
+    filters.append(QStringLiteral(";;%1 (*.ovj)").arg(tr("Olive Autorecovery Journal")));
+  }
+
 #ifdef USE_OTIO
   filters.append(QStringLiteral(";;%2 (*.otio)").arg(tr("OpenTimelineIO")));
 #endif
@@ -909,6 +961,62 @@ QString Core::GetRecentProjectsFilePath()
   return QDir(FileFunctions::GetConfigurationLocation()).filePath(QStringLiteral("recent"));
 }
 
+QString Core::GetAutorecoveryDirectory()
+{
+  return QDir(FileFunctions::GetConfigurationLocation()).filePath(QStringLiteral("autorecovery"));
+}
+
+void Core::PromptToRecoverJournals()
+{
+  // Journals are removed when their project closes, so any still here are from a session that
+  // ended unexpectedly
+  QFileInfoList journals = QDir(GetAutorecoveryDirectory()).entryInfoList({QStringLiteral("*.ovj")},
+                                                                          QDir::Files,
+                                                                          QDir::Time);
+
+  if (journals.isEmpty()) {
+    return;
+  }
+
+  QMessageBox b(main_window_);
+  b.setIcon(QMessageBox::Question);
+  b.setWindowModality(Qt::WindowModal);
+  b.setWindowTitle(tr("Recover Projects"));
+  b.setText(tr("Olive didn't close properly last time. Would you like to recover the %n project(s) "
+               "that were open?", nullptr, journals.size()));
+
+  QPushButton* recover_btn = b.addButton(tr("Recover"), QMessageBox::AcceptRole);
+  QPushButton* discard_btn = b.addButton(tr("Discard"), QMessageBox::DestructiveRole);
+  b.addButton(tr("Not Now"), QMessageBox::RejectRole);
+
+  b.exec();
+
+  if (b.clickedButton() == recover_btn) {
+    foreach (const QFileInfo& info, journals) {
+      QString filename = info.absoluteFilePath();
+
+      TaskDialog* task_dialog = new TaskDialog(new ProjectLoadBinaryTask(filename), tr("Recover Project"), main_window());
+
+      connect(task_dialog, &TaskDialog::TaskSucceeded, this, &Core::AddOpenProjectFromTask);
+
+      // The recovered project is modified, so once it's open it starts a journal of its own and
+      // this one is no longer needed
+      connect(task_dialog, &TaskDialog::TaskSucceeded, this, [this, filename](Task* task){
+        if (open_projects_.contains(static_cast<ProjectLoadBaseTask*>(task)->GetLoadedProject())) {
+          SaveAutorecovery();
+          QFile::remove(filename);
+        }
+      });
+
+      task_dialog->open();
+    }
+  } else if (b.clickedButton() == discard_btn) {
+    foreach (const QFileInfo& info, journals) {
+      QFile::remove(info.absoluteFilePath());
+    }
+  }
+}
+
 void Core::SetStartupLocale()
 {
   // Set language
@@ -1011,6 +1119,10 @@ void Core::OpenProjectInternal(const QString &filename)
                              "cannot open OpenTimelineIO files."));
     return;
 #endif
+  } else if (filename.endsWith(QStringLiteral(".ovb"), Qt::CaseInsensitive)
+             || filename.endsWith(QStringLiteral(".ovj"), Qt::CaseInsensitive)) {
+    // Autorecovery journals are read by the binary loader too
+    load_task = new ProjectLoadBinaryTask(filename);
   } else {
     // Fallback to regular OVE project
     load_task = new ProjectLoadTask(filename);
@@ -1202,6 +1314,14 @@ bool Core::CloseProject(Project* p, bool auto_open_new, CloseProjectBehavior &co
 
       disconnect(p, &Project::ModifiedChanged, this, &Core::ProjectWasModified);
       emit ProjectClosed(p);
+
+      // The project was either saved or deliberately discarded, so there's nothing to recover
+      ProjectJournal* journal = autorecovery_journals_.take(p);
+      if (journal) {
+        journal->Remove();
+        delete journal;
+      }
+
       open_projects_.removeAt(i);
       delete p;
       break;
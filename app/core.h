@@ -22,6 +22,7 @@
 #define CORE_H
 
 #include <QFileInfoList>
+#include <QHash>
 #include <QList>
 #include <QTimer>
 #include <QTranslator>
@@ -39,6 +40,7 @@
 namespace olive {
 
 class MainWindow;
+class ProjectJournal;
 
 /**
  * @brief The main central Olive application instance
@@ -441,6 +443,9 @@ signals:
 private:
   /**
    * @brief Get the file filter than can be used with QFileDialog to open and save compatible projects
+   *
+   * If `include_any_filter` is TRUE, the filter is for opening, so it also includes autorecovery
+   * journals.
    */
   static QString GetProjectFilter(bool include_any_filter);
 
@@ -449,6 +454,16 @@ private:
    */
   static QString GetRecentProjectsFilePath();
 
+  /**
+   * @brief Returns the directory autorecovery journals are written to
+   */
+  static QString GetAutorecoveryDirectory();
+
+  /**
+   * @brief Offer to open any autorecovery journals left behind by a session that didn't close
+   */
+  void PromptToRecoverJournals();
+
   /**
    * @brief Called only on startup to set the locale
    */
@@ -500,6 +515,11 @@ private:
    */
   QList<Project*> open_projects_;
 
+  /**
+   * @brief Autorecovery journal of each open project that has been autosaved
+   */
+  QHash<Project*, ProjectJournal*> autorecovery_journals_;
+
   /**
    * @brief Currently active tool
    */
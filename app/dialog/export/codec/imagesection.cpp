@@ -36,7 +36,64 @@ ImageSection::ImageSection(QWidget* parent) :
   layout->addWidget(new QLabel(tr("Image Sequence:")), row, 0);
 
   image_sequence_checkbox_ = new QCheckBox();
-  layout->addWidget(new QCheckBox(), row, 1);
+  image_sequence_checkbox_->setChecked(true);
+  layout->addWidget(image_sequence_checkbox_, row, 1);
+
+  row++;
+
+  layout->addWidget(new QLabel(tr("Compression:")), row, 0);
+
+  compression_combobox_ = new QComboBox();
+  layout->addWidget(compression_combobox_, row, 1);
+}
+
+void ImageSection::SetCodec(ExportCodec::Codec codec)
+{
+  compression_combobox_->clear();
+
+  // Item data is the compression name OpenImageIO expects
+  switch (codec) {
+  case ExportCodec::kCodecOpenEXR:
+    compression_combobox_->addItem(tr("None"), QStringLiteral("none"));
+    compression_combobox_->addItem(tr("RLE"), QStringLiteral("rle"));
+    compression_combobox_->addItem(tr("ZIP (Single Scanline)"), QStringLiteral("zips"));
+    compression_combobox_->addItem(tr("ZIP"), QStringLiteral("zip"));
+    compression_combobox_->addItem(tr("PIZ"), QStringLiteral("piz"));
+    compression_combobox_->addItem(tr("PXR24"), QStringLiteral("pxr24"));
+    compression_combobox_->addItem(tr("B44"), QStringLiteral("b44"));
+    compression_combobox_->addItem(tr("B44A"), QStringLiteral("b44a"));
+    compression_combobox_->addItem(tr("DWAA"), QStringLiteral("dwaa"));
+    compression_combobox_->addItem(tr("DWAB"), QStringLiteral("dwab"));
+    compression_combobox_->setCurrentIndex(3);
+    break;
+  case ExportCodec::kCodecPNG:
+    compression_combobox_->addItem(tr("Fastest"), QStringLiteral("zip:1"));
+    compression_combobox_->addItem(tr("Default"), QStringLiteral("zip:6"));
+    compression_combobox_->addItem(tr("Smallest"), QStringLiteral("zip:9"));
+    compression_combobox_->setCurrentIndex(1);
+    break;
+  case ExportCodec::kCodecTIFF:
+    compression_combobox_->addItem(tr("None"), QStringLiteral("none"));
+    compression_combobox_->addItem(tr("LZW"), QStringLiteral("lzw"));
+    compression_combobox_->addItem(tr("ZIP"), QStringLiteral("zip"));
+    compression_combobox_->addItem(tr("PackBits"), QStringLiteral("packbits"));
+    compression_combobox_->setCurrentIndex(2);
+    break;
+  default:
+    break;
+  }
+
+  compression_combobox_->setEnabled(compression_combobox_->count() > 0);
+}
+
+void ImageSection::AddOpts(EncodingParams *params)
+{
+  params->set_video_option(QStringLiteral("image_sequence"),
+                           image_sequence_checkbox_->isChecked() ? QStringLiteral("1") : QStringLiteral("0"));
+
+  if (compression_combobox_->count() > 0) {
+    params->set_video_option(QStringLiteral("compression"), compression_combobox_->currentData().toString());
+  }
 }
 
 QCheckBox *ImageSection::image_sequence_checkbox() const
@@ -22,6 +22,7 @@
 #define IMAGESECTION_H
 
 #include <QCheckBox>
+#include <QComboBox>
 
 #include "codecsection.h"
 
@@ -35,9 +36,18 @@ public:
 
   QCheckBox* image_sequence_checkbox() const;
 
+  /**
+   * @brief Fill the compression list with the methods available for this codec
+   */
+  void SetCodec(ExportCodec::Codec codec);
+
+  virtual void AddOpts(EncodingParams* params) override;
+
 private:
   QCheckBox* image_sequence_checkbox_;
 
+  QComboBox* compression_combobox_;
+
 };
 
 }
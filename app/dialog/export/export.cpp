@@ -35,6 +35,7 @@
 #include "dialog/task/task.h"
 #include "project/item/sequence/sequence.h"
 #include "project/project.h"
+#include "task/export/renderqueue.h"
 #include "ui/icons/icons.h"
 
 namespace olive {
@@ -155,6 +156,8 @@ ExportDialog::ExportDialog(ViewerOutput *viewer_node, TimelinePoints *points, QW
   buttons_ = new QDialogButtonBox();
   buttons_->setCenterButtons(true);
   buttons_->addButton(tr("Export"), QDialogButtonBox::AcceptRole);
+  QPushButton* queue_btn = buttons_->addButton(tr("Add to Queue"), QDialogButtonBox::ActionRole);
+  connect(queue_btn, &QPushButton::clicked, this, &ExportDialog::QueueExport);
   buttons_->addButton(QDialogButtonBox::Cancel);
   connect(buttons_, &QDialogButtonBox::accepted, this, &ExportDialog::StartExport);
   connect(buttons_, &QDialogButtonBox::rejected, this, &ExportDialog::reject);
@@ -235,7 +238,7 @@ ExportDialog::ExportDialog(ViewerOutput *viewer_node, TimelinePoints *points, QW
   preview_viewer_->SetColorTransform(video_tab_->CurrentOCIOColorSpace());
 }
 
-void ExportDialog::StartExport()
+bool ExportDialog::ValidateExport()
 {
   if (!video_enabled_->isChecked() && !audio_enabled_->isChecked()) {
     QMessageBox b(this);
@@ -245,7 +248,7 @@ void ExportDialog::StartExport()
     b.setText(tr("Both video and audio are disabled. There's nothing to export."));
     b.addButton(QMessageBox::Ok);
     b.exec();
-    return;
+    return false;
   }
 
   // Validate if the entered filename contains the correct extension (the extension is necessary
@@ -267,7 +270,7 @@ void ExportDialog::StartExport()
     if (b.exec() == QMessageBox::Yes) {
       filename_edit_->setText(proposed_filename.append(necessary_ext));
     } else {
-      return;
+      return false;
     }
   }
 
@@ -285,7 +288,7 @@ void ExportDialog::StartExport()
                  "Please choose a different filename."));
     b.addButton(QMessageBox::Ok);
     b.exec();
-    return;
+    return false;
   }
 
   // Validate if the file exists and whether the user wishes to overwrite it
@@ -300,7 +303,7 @@ void ExportDialog::StartExport()
     b.addButton(QMessageBox::No);
 
     if (b.exec() == QMessageBox::No) {
-      return;
+      return false;
     }
   }
 
@@ -314,6 +317,15 @@ void ExportDialog::StartExport()
     b.setWindowTitle(tr("Invalid Parameters"));
     b.setText(tr("Width and height must be multiples of 2."));
     b.exec();
+    return false;
+  }
+
+  return true;
+}
+
+void ExportDialog::StartExport()
+{
+  if (!ValidateExport()) {
     return;
   }
 
@@ -323,6 +335,17 @@ void ExportDialog::StartExport()
   td->open();
 }
 
+void ExportDialog::QueueExport()
+{
+  if (!ValidateExport()) {
+    return;
+  }
+
+  RenderQueue::instance()->AddJob(viewer_node_, color_manager_, GenerateParams());
+
+  this->accept();
+}
+
 void ExportDialog::ExportFinished()
 {
   TaskDialog* td = static_cast<TaskDialog*>(sender());
@@ -462,6 +485,7 @@ ExportParams ExportDialog::GenerateParams() const
 
   ExportParams params;
   params.SetFilename(filename_edit_->text().trimmed());
+  params.set_encoder(ExportFormat::GetEncoder(static_cast<ExportFormat::Format>(format_combobox_->currentIndex())));
   params.SetExportLength(viewer_node_->GetLength());
 
   if (range_combobox_->currentIndex() == kRangeInToOut
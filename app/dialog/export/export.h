@@ -51,6 +51,15 @@ private:
 
   ExportParams GenerateParams() const;
 
+  /**
+   * @brief Check the user's settings make sense, asking them to fix anything that doesn't
+   *
+   * @return
+   *
+   * TRUE if we can go ahead with exporting.
+   */
+  bool ValidateExport();
+
   ViewerOutput* viewer_node_;
   TimelinePoints* points_;
 
@@ -91,6 +100,8 @@ private slots:
 
   void StartExport();
 
+  void QueueExport();
+
   void ExportFinished();
 
 };
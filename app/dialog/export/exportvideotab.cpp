@@ -199,6 +199,7 @@ void ExportVideoTab::VideoCodecChanged()
     SetCodecSection(h264_section());
   } else if (ExportCodec::IsCodecAStillImage(codec)) {
     SetCodecSection(image_section());
+    image_section()->SetCodec(codec);
   }
 
   // Set default pixel format
@@ -21,12 +21,19 @@
 #include "block.h"
 
 #include <QDebug>
+#include <QtMath>
 
 #include "node/output/track/track.h"
 #include "transition/transition.h"
 
 namespace olive {
 
+// Simpson's rule subdivisions used between each pair of speed keyframes (must be even)
+const int kSpeedIntegrationSteps = 16;
+
+// Iterations used when solving keyframed speed for a sequence time
+const int kSpeedSolveIterations = 48;
+
 Block::Block() :
   previous_(nullptr),
   next_(nullptr)
@@ -179,8 +186,11 @@ rational Block::SequenceToMediaTime(const rational &sequence_time) const
   rational local_time = sequence_time - in();
 
   // FIXME: Doesn't handle reversing
-  if (speed_input_->is_keyframing() || speed_input_->is_connected()) {
+  if (speed_input_->is_connected()) {
     // FIXME: We'll need to calculate the speed hoo boy
+  } else if (speed_input_->is_keyframing()) {
+    // Media time is the area under the speed curve
+    local_time = rational::fromDouble(IntegrateSpeed(in(), sequence_time));
   } else {
     double speed_value = speed_input_->get_standard_value().toDouble();
 
@@ -206,8 +216,37 @@ rational Block::MediaToSequenceTime(const rational &media_time) const
   rational sequence_time = media_time - media_in();
 
   // FIXME: Doesn't handle reversing
-  if (speed_input_->is_keyframing() || speed_input_->is_connected()) {
+  if (speed_input_->is_connected()) {
     // FIXME: We'll need to calculate the speed hoo boy
+  } else if (speed_input_->is_keyframing()) {
+    double target = sequence_time.toDouble();
+    double start_speed = GetSpeedAtTime(in());
+
+    if (target <= 0 || qFuzzyIsNull(start_speed)) {
+      // Before the in point, assume the speed at the in point carries on
+      sequence_time = qFuzzyIsNull(start_speed) ? rational() : rational::fromDouble(target / start_speed);
+    } else {
+      // There's no closed form for the inverse, so search for the time where the area under the
+      // speed curve reaches the media time
+      double low = 0;
+      double high = qMax(length().toDouble(), 1.0);
+
+      for (int i=0;i<kSpeedSolveIterations && IntegrateSpeed(in(), in() + rational::fromDouble(high)) < target;i++) {
+        high *= 2.0;
+      }
+
+      for (int i=0;i<kSpeedSolveIterations;i++) {
+        double mid = (low + high) * 0.5;
+
+        if (IntegrateSpeed(in(), in() + rational::fromDouble(mid)) < target) {
+          low = mid;
+        } else {
+          high = mid;
+        }
+      }
+
+      sequence_time = rational::fromDouble((low + high) * 0.5);
+    }
   } else {
     double speed_value = speed_input_->get_standard_value().toDouble();
 
@@ -370,6 +409,49 @@ NodeInput *Block::speed_input() const
   return speed_input_;
 }
 
+double Block::GetSpeedAtTime(const rational &sequence_time) const
+{
+  if (speed_input_->is_connected()) {
+    // FIXME: We'll need to calculate the speed hoo boy
+    return 1.0;
+  } else if (speed_input_->is_keyframing()) {
+    return speed_input_->get_value_at_time(sequence_time).toDouble();
+  } else {
+    return speed_input_->get_standard_value().toDouble();
+  }
+}
+
+double Block::IntegrateSpeed(const rational &start, const rational &end) const
+{
+  if (end < start) {
+    return -IntegrateSpeed(end, start);
+  }
+
+  double area = 0;
+  rational segment_start = start;
+
+  while (segment_start < end) {
+    // Integrate each keyframe segment separately so that holds and sharp corners land exactly on
+    // segment boundaries
+    NodeKeyframePtr next_key = speed_input_->get_closest_keyframe_after_time(segment_start);
+    rational segment_end = (next_key && next_key->time() < end) ? next_key->time() : end;
+
+    double a = segment_start.toDouble();
+    double step = (segment_end.toDouble() - a) / kSpeedIntegrationSteps;
+    double sum = GetSpeedAtTime(segment_start) + GetSpeedAtTime(segment_end);
+
+    for (int i=1;i<kSpeedIntegrationSteps;i++) {
+      sum += ((i % 2) ? 4.0 : 2.0) * GetSpeedAtTime(rational::fromDouble(a + step * i));
+    }
+
+    area += sum * step / 3.0;
+
+    segment_start = segment_end;
+  }
+
+  return area;
+}
+
 void Block::Hash(QCryptographicHash &, const rational &) const
 {
   // A block does nothing by default, so we hash nothing
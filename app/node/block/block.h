@@ -83,6 +83,14 @@ public:
   NodeInput* media_in_input() const;
   NodeInput* speed_input() const;
 
+  /**
+   * @brief Get this block's speed at a given time in the sequence
+   *
+   * Follows the speed input's keyframes if it has any. Connected speeds aren't supported yet and
+   * always return 1.0.
+   */
+  double GetSpeedAtTime(const rational& sequence_time) const;
+
   virtual void Hash(QCryptographicHash &hash, const rational &time) const override;
 
 public slots:
@@ -122,6 +130,13 @@ protected:
 private:
   void set_length_internal(const rational &length);
 
+  /**
+   * @brief Integrate keyframed speed over a range of sequence time
+   *
+   * The result is how much media time passes between `start` and `end`.
+   */
+  double IntegrateSpeed(const rational& start, const rational& end) const;
+
   NodeInput* length_input_;
   NodeInput* media_in_input_;
   NodeInput* speed_input_;
@@ -27,6 +27,12 @@ ClipBlock::ClipBlock()
   texture_input_ = new NodeInput("buffer_in", NodeInput::kBuffer);
   texture_input_->set_is_keyframable(false);
   AddInput(texture_input_);
+
+  preserve_pitch_input_ = new NodeInput("preserve_pitch_in", NodeParam::kBoolean);
+  preserve_pitch_input_->set_connectable(false);
+  preserve_pitch_input_->set_is_keyframable(false);
+  preserve_pitch_input_->set_standard_value(false);
+  AddInput(preserve_pitch_input_);
 }
 
 Node *ClipBlock::copy() const
@@ -59,6 +65,16 @@ NodeInput *ClipBlock::texture_input() const
   return texture_input_;
 }
 
+NodeInput *ClipBlock::preserve_pitch_input() const
+{
+  return preserve_pitch_input_;
+}
+
+bool ClipBlock::preserve_pitch() const
+{
+  return preserve_pitch_input_->get_standard_value().toBool();
+}
+
 void ClipBlock::InvalidateCache(const TimeRange &range, NodeInput *from, NodeInput *source)
 {
   // If signal is from texture input, transform all times from media time to sequence time
@@ -109,6 +125,7 @@ void ClipBlock::Retranslate()
   Block::Retranslate();
 
   texture_input_->set_name(tr("Buffer"));
+  preserve_pitch_input_->set_name(tr("Maintain Audio Pitch"));
 }
 
 void ClipBlock::Hash(QCryptographicHash &hash, const rational &time) const
@@ -120,4 +137,14 @@ void ClipBlock::Hash(QCryptographicHash &hash, const rational &time) const
   }
 }
 
+QVector<NodeInput *> ClipBlock::GetInputsToHash() const
+{
+  QVector<NodeInput*> inputs = Block::GetInputsToHash();
+
+  // Only affects audio, which isn't hashed
+  inputs.removeOne(preserve_pitch_input_);
+
+  return inputs;
+}
+
 }
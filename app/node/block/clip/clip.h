@@ -44,6 +44,13 @@ public:
 
   NodeInput* texture_input() const;
 
+  NodeInput* preserve_pitch_input() const;
+
+  /**
+   * @brief Whether audio should keep its pitch when this clip's speed is changed
+   */
+  bool preserve_pitch() const;
+
   virtual void InvalidateCache(const TimeRange &range, NodeInput *from, NodeInput* source) override;
 
   virtual TimeRange InputTimeAdjustment(NodeInput* input, const TimeRange& input_time) const override;
@@ -56,9 +63,14 @@ public:
 
   virtual void Hash(QCryptographicHash &hash, const rational &time) const override;
 
+protected:
+  virtual QVector<NodeInput*> GetInputsToHash() const override;
+
 private:
   NodeInput* texture_input_;
 
+  NodeInput* preserve_pitch_input_;
+
 };
 
 }
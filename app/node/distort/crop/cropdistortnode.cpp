@@ -80,6 +80,7 @@ NodeValueTable CropDistortNode::Value(NodeValueDatabase &value) const
   job.InsertValue(QStringLiteral("resolution_in"),
                   ShaderValue(value[QStringLiteral("global")].Get(NodeParam::kVec2, QStringLiteral("resolution")), NodeParam::kVec2));
   job.SetAlphaChannelRequired(true);
+  job.SetFusion(ShaderJob::kFusionCrop, texture_input_);
 
   NodeValueTable table = value.Merge();
 
@@ -87,6 +87,9 @@ NodeValueTable TransformDistortNode::Value(NodeValueDatabase &value) const
       //        end up with gaps in the screen that will require an alpha channel.
       job.SetAlphaChannelRequired(true);
 
+      // Consecutive transforms and crops can be collapsed into one draw by the renderer
+      job.SetFusion(ShaderJob::kFusionMatrix, QStringLiteral("ove_maintex"));
+
       table.Push(NodeParam::kShaderJob, QVariant::fromValue(job), this);
     }
   }
@@ -20,6 +20,8 @@
 
 #include "stroke.h"
 
+#include <QtMath>
+
 #include "render/color.h"
 
 namespace olive {
@@ -97,8 +99,23 @@ NodeValueTable StrokeFilterNode::Value(NodeValueDatabase &value) const
   NodeValueTable table = value.Merge();
 
   if (!job.GetValue(tex_input_).data.isNull()) {
-    if (job.GetValue(radius_input_).data.toDouble() > 0.0
+    double radius = job.GetValue(radius_input_).data.toDouble();
+
+    if (radius > 0.0
         && job.GetValue(opacity_input_).data.toDouble() > 0.0) {
+      // The stroke is drawn from a jump flooded distance field (see stroke.frag), which needs one
+      // pass per power of two the stroke reaches (with margin for non-square pixels), plus passes
+      // to mark seeds, refine and draw
+      int jump_steps = qMax(1, qCeil(std::log2(2.0 * (qCeil(radius) + 1))));
+
+      job.InsertValue(QStringLiteral("seed_in"), job.GetValue(tex_input_));
+      job.SetInterpolation(QStringLiteral("seed_in"), Texture::kNearest);
+      job.InsertValue(QStringLiteral("jump_steps_in"), ShaderValue(jump_steps, NodeParam::kInt));
+      job.SetIterations(jump_steps + 3, QStringLiteral("seed_in"));
+
+      // Seed offsets are stored as-is, 8-bit intermediates would round them off for wide strokes
+      job.SetIterativeFormat(VideoParams::kFormatFloat16);
+
       table.Push(NodeParam::kShaderJob, QVariant::fromValue(job), this);
     } else {
       table.Push(job.GetValue(tex_input_), this);
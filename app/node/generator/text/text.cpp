@@ -22,8 +22,13 @@
 
 #include <QTextDocument>
 
+#include "common/filefunctions.h"
+
 namespace olive {
 
+QCache<QString, TextGenerator::Coverage> TextGenerator::coverage_cache_(64 * 1024 * 1024);
+QMutex TextGenerator::coverage_cache_lock_;
+
 enum TextVerticalAlign {
   kVerticalAlignTop,
   kVerticalAlignCenter,
@@ -92,6 +97,13 @@ void TextGenerator::Retranslate()
   valign_input_->set_combobox_strings({tr("Top"), tr("Center"), tr("Bottom")});
 }
 
+ShaderCode TextGenerator::GetShaderCode(const QString &shader_id) const
+{
+  Q_UNUSED(shader_id)
+
+  return ShaderCode(FileFunctions::ReadFileAsString(":/shaders/textcoverage.frag"));
+}
+
 NodeValueTable TextGenerator::Value(NodeValueDatabase &value) const
 {
   GenerateJob job;
@@ -101,6 +113,7 @@ NodeValueTable TextGenerator::Value(NodeValueDatabase &value) const
   job.InsertValue(font_input_, value);
   job.InsertValue(font_size_input_, value);
   job.SetAlphaChannelRequired(true);
+  job.SetCoverageShaderID(QStringLiteral("coverage"));
 
   NodeValueTable table = value.Merge();
 
@@ -113,13 +126,49 @@ NodeValueTable TextGenerator::Value(NodeValueDatabase &value) const
 
 void TextGenerator::GenerateFrame(FramePtr frame, const GenerateJob& job) const
 {
-  // This could probably be more optimized, but for now we use Qt to draw to a QImage.
-  // QImages only support integer pixels and we use float pixels, so what we do here is draw onto
-  // a single-channel QImage (alpha only) and then transplant that alpha channel to our float buffer
-  // with correct float RGB.
-  QImage img(frame->width(), frame->height(), QImage::Format_Grayscale8);
-  img.fill(0);
+  // `frame` is single-channel coverage (see Value()), the color is applied afterwards on the GPU
+  const VideoParams& params = frame->video_params();
+
+  QString key = QStringList({QString::number(params.width()),
+                             QString::number(params.height()),
+                             QString::number(params.divider()),
+                             job.GetValue(valign_input_).data.toString(),
+                             job.GetValue(font_size_input_).data.toString(),
+                             job.GetValue(font_input_).data.toString(),
+                             job.GetValue(text_input_).data.toString()}).join(QChar(0));
+
+  Coverage coverage;
+  bool cached = false;
+
+  coverage_cache_lock_.lock();
+
+  Coverage* c = coverage_cache_.object(key);
+  if (c) {
+    coverage = *c;
+    cached = true;
+  }
+
+  coverage_cache_lock_.unlock();
+
+  if (!cached) {
+    coverage = RasterizeCoverage(params, job);
+
+    coverage_cache_lock_.lock();
+    coverage_cache_.insert(key, new Coverage(coverage), coverage.image.bytesPerLine() * coverage.image.height());
+    coverage_cache_lock_.unlock();
+  }
+
+  memset(frame->data(), 0, frame->allocated_size());
 
+  for (int y=0; y<coverage.image.height(); y++) {
+    memcpy(frame->data() + (coverage.rect.y() + y) * frame->linesize_bytes() + coverage.rect.x(),
+           coverage.image.constScanLine(y),
+           coverage.image.width());
+  }
+}
+
+TextGenerator::Coverage TextGenerator::RasterizeCoverage(const VideoParams &params, const GenerateJob &job) const
+{
   QTextDocument text_doc;
 
   // Set default font
@@ -134,46 +183,53 @@ void TextGenerator::GenerateFrame(FramePtr frame, const GenerateJob& job) const
   text_doc.setHtml(job.GetValue(text_input_).data.toString());
 
   // Align to 80% width because that's considered the "title safe" area
-  int tenth_of_width = frame->video_params().width() / 10;
+  int tenth_of_width = params.width() / 10;
   text_doc.setTextWidth(tenth_of_width * 8);
 
-  // Draw rich text onto image
-  QPainter p(&img);
-  p.scale(1.0 / frame->video_params().divider(), 1.0 / frame->video_params().divider());
-
-  // Push 10% inwards to compensate for title safe area
-  p.translate(tenth_of_width, 0);
-
   TextVerticalAlign valign = static_cast<TextVerticalAlign>(job.GetValue(valign_input_).data.toInt());
   int doc_height = text_doc.size().height();
+  int doc_top = 0;
 
   switch (valign) {
   case kVerticalAlignTop:
     // Push 10% inwards for title safe area
-    p.translate(0, frame->video_params().height() / 10);
+    doc_top = params.height() / 10;
     break;
   case kVerticalAlignCenter:
     // Center align
-    p.translate(0, frame->video_params().height() / 2 - doc_height / 2);
+    doc_top = params.height() / 2 - doc_height / 2;
     break;
   case kVerticalAlignBottom:
     // Push 10% inwards for title safe area
-    p.translate(0, frame->video_params().height() - doc_height - frame->video_params().height() / 10);
+    doc_top = params.height() - doc_height - params.height() / 10;
     break;
   }
 
-  text_doc.drawContents(&p);
+  // Only rasterize the area the text covers (pushed 10% inwards to compensate for the title safe
+  // area) rather than the whole frame
+  qreal scale = 1.0 / params.divider();
+  QRectF doc_rect(tenth_of_width, doc_top, text_doc.size().width(), text_doc.size().height());
 
-  // Transplant alpha channel to frame
-  Color rgb = job.GetValue(color_input_).data.value<Color>();
-  for (int x=0; x<frame->width(); x++) {
-    for (int y=0; y<frame->height(); y++) {
-      uchar src_alpha = img.bits()[img.bytesPerLine() * y + x];
-      float alpha = float(src_alpha) / 255.0f;
+  Coverage coverage;
+  coverage.rect = QRectF(doc_rect.topLeft() * scale, doc_rect.size() * scale).toAlignedRect();
+  coverage.rect &= QRect(0, 0, params.effective_width(), params.effective_height());
 
-      frame->set_pixel(x, y, Color(rgb.red() * alpha, rgb.green() * alpha, rgb.blue() * alpha, alpha));
-    }
+  if (coverage.rect.isEmpty()) {
+    return coverage;
   }
+
+  // QImages only support integer pixels, so we draw onto a single-channel QImage (alpha only)
+  coverage.image = QImage(coverage.rect.size(), QImage::Format_Grayscale8);
+  coverage.image.fill(0);
+
+  QPainter p(&coverage.image);
+  p.translate(-coverage.rect.topLeft());
+  p.scale(scale, scale);
+  p.translate(tenth_of_width, doc_top);
+
+  text_doc.drawContents(&p);
+
+  return coverage;
 }
 
 }
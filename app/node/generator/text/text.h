@@ -21,6 +21,9 @@
 #ifndef TEXTGENERATOR_H
 #define TEXTGENERATOR_H
 
+#include <QCache>
+#include <QMutex>
+
 #include "node/node.h"
 
 namespace olive {
@@ -40,11 +43,28 @@ public:
 
   virtual void Retranslate() override;
 
+  virtual ShaderCode GetShaderCode(const QString& shader_id) const override;
+
   virtual NodeValueTable Value(NodeValueDatabase& value) const override;
 
   virtual void GenerateFrame(FramePtr frame, const GenerateJob &job) const override;
 
 private:
+  /**
+   * @brief Rasterized text, only covering the area the text takes up in the frame
+   */
+  struct Coverage {
+    QRect rect;
+    QImage image;
+  };
+
+  Coverage RasterizeCoverage(const VideoParams& params, const GenerateJob &job) const;
+
+  /// Laid out text is usually the same from frame to frame, so we keep recent results
+  static QCache<QString, Coverage> coverage_cache_;
+
+  static QMutex coverage_cache_lock_;
+
   NodeInput* text_input_;
 
   NodeInput* color_input_;
@@ -48,6 +48,8 @@ void NodeGraph::AddNode(Node *node)
 
   node_children_.append(node);
 
+  MarkDirty();
+
   emit NodeAdded(node);
 }
 
@@ -151,9 +153,22 @@ void NodeGraph::TakeNode(Node *node, QObject* new_parent)
 
   node_children_.removeAll(node);
 
+  MarkDirty();
+
   emit NodeRemoved(node);
 }
 
+quint64 NodeGraph::dirty_generation() const
+{
+  quint64 generation = Item::dirty_generation();
+
+  foreach (Node* node, node_children_) {
+    generation = qMax(generation, node->dirty_generation());
+  }
+
+  return generation;
+}
+
 const QList<Node *> &NodeGraph::nodes() const
 {
   return node_children_;
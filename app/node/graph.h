@@ -73,6 +73,11 @@ public:
 
   void EndOperation();
 
+  /**
+   * @brief Includes changes to any node in the graph, as well as nodes being added or removed
+   */
+  virtual quint64 dirty_generation() const override;
+
 signals:
   /**
    * @brief Signal emitted when a Node is added to the graph
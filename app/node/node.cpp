@@ -25,6 +25,7 @@
 #include <QDebug>
 #include <QFile>
 
+#include "common/dirtygeneration.h"
 #include "common/timecodefunctions.h"
 #include "common/xmlutils.h"
 #include "project/project.h"
@@ -35,7 +36,8 @@
 namespace olive {
 
 Node::Node() :
-  can_be_deleted_(true)
+  can_be_deleted_(true),
+  dirty_generation_(NextDirtyGeneration())
 {
   output_ = new NodeOutput("node_out");
   AddParameter(output_);
@@ -401,6 +403,8 @@ void Node::SetLabel(const QString &s)
   if (label_ != s) {
     label_ = s;
 
+    MarkDirty();
+
     emit LabelChanged(label_);
   }
 }
@@ -875,6 +879,8 @@ void Node::SetPosition(const QPointF &pos)
 {
   position_ = pos;
 
+  MarkDirty();
+
   emit PositionChanged(position_);
 }
 
@@ -927,13 +933,22 @@ void Node::DisconnectInput(NodeInput *input)
   disconnect(input, &NodeInput::EdgeRemoved, this, &Node::InputConnectionChanged);
 }
 
+void Node::MarkDirty()
+{
+  dirty_generation_ = NextDirtyGeneration();
+}
+
 void Node::InputChanged(const TimeRange& range)
 {
+  MarkDirty();
+
   InvalidateCache(range, static_cast<NodeInput*>(sender()), static_cast<NodeInput*>(sender()));
 }
 
 void Node::InputConnectionChanged(NodeEdgePtr edge)
 {
+  MarkDirty();
+
   InvalidateCache(TimeRange(RATIONAL_MIN, RATIONAL_MAX), edge->input(), edge->input());
 }
 
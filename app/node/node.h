@@ -429,6 +429,18 @@ public:
   const QString& GetLabel() const;
   void SetLabel(const QString& s);
 
+  /**
+   * @brief Dirty generation of the last change to this node's values, connections or UI state
+   *
+   * \see NextDirtyGeneration()
+   */
+  quint64 dirty_generation() const
+  {
+    return dirty_generation_;
+  }
+
+  void MarkDirty();
+
   virtual void Hash(QCryptographicHash& hash, const rational &time) const;
 
 protected:
@@ -542,6 +554,8 @@ private:
    */
   QString label_;
 
+  quint64 dirty_generation_;
+
 };
 
 template<class T>
@@ -21,6 +21,7 @@
 #include "traverser.h"
 
 #include "node.h"
+#include "threading/workstealingexecutor.h"
 
 namespace olive {
 
@@ -31,6 +32,50 @@ NodeValueDatabase NodeTraverser::GenerateDatabase(const Node* node, const TimeRa
   // We need to insert tables into the database for each input
   QVector<NodeInput*> inputs = node->GetInputsIncludingArrays();
 
+  if (TraverseInputsInParallel()) {
+    QVector<NodeValueTable> tables(inputs.size());
+
+    {
+      TaskGroup group;
+      int last_connected = -1;
+
+      for (int i=0; i<inputs.size(); i++) {
+        if (inputs.at(i)->is_connected()) {
+          if (last_connected != -1) {
+            // Fork the previous connected input, we'll traverse the last one ourselves
+            group.Run([this, node, &inputs, &tables, &range, last_connected]{
+              NodeInput* input = inputs.at(last_connected);
+              tables[last_connected] = ProcessInput(input, node->InputTimeAdjustment(input, range));
+            });
+          }
+
+          last_connected = i;
+        } else {
+          tables[i] = ProcessInput(inputs.at(i), node->InputTimeAdjustment(inputs.at(i), range));
+        }
+      }
+
+      if (last_connected != -1) {
+        NodeInput* input = inputs.at(last_connected);
+        tables[last_connected] = ProcessInput(input, node->InputTimeAdjustment(input, range));
+      }
+
+      group.Wait();
+    }
+
+    if (IsCancelled()) {
+      return NodeValueDatabase();
+    }
+
+    for (int i=0; i<inputs.size(); i++) {
+      database.Insert(inputs.at(i), tables.at(i));
+    }
+
+    AddGlobalsToDatabase(database, range);
+
+    return database;
+  }
+
   foreach (NodeInput* input, inputs) {
     if (IsCancelled()) {
       return NodeValueDatabase();
@@ -136,9 +181,10 @@ QVariant NodeTraverser::ProcessSamples(const Node *node, const TimeRange &range,
   return QVariant();
 }
 
-QVariant NodeTraverser::ProcessFrameGeneration(const Node *node, const GenerateJob &job)
+QVariant NodeTraverser::ProcessFrameGeneration(const Node *node, const TimeRange &range, const GenerateJob &job)
 {
   Q_UNUSED(node)
+  Q_UNUSED(range)
   Q_UNUSED(job)
 
   return QVariant();
@@ -237,7 +283,7 @@ void NodeTraverser::PostProcessTable(const Node *node, const TimeRange &range, N
 
     // Run generate jobs
     foreach (const NodeValue& v, generate_jobs_to_run) {
-      QVariant value = ProcessFrameGeneration(node, v.data().value<GenerateJob>());
+      QVariant value = ProcessFrameGeneration(node, range, v.data().value<GenerateJob>());
 
       if (!value.isNull()) {
         output_params.Push(NodeParam::kTexture, value, node);
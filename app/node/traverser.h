@@ -54,7 +54,7 @@ protected:
 
   virtual QVariant ProcessSamples(const Node *node, const TimeRange &range, const SampleJob &job);
 
-  virtual QVariant ProcessFrameGeneration(const Node *node, const GenerateJob& job);
+  virtual QVariant ProcessFrameGeneration(const Node *node, const TimeRange &range, const GenerateJob& job);
 
   virtual QVariant GetCachedFrame(const Node *node, const rational &time);
 
@@ -65,6 +65,17 @@ protected:
     return QVector2D(0, 0);
   }
 
+  /**
+   * @brief Whether GenerateDatabase() may traverse a node's inputs concurrently
+   *
+   * If this returns TRUE, each connected input is traversed as its own task on the
+   * WorkStealingExecutor, so everything the traversal calls must be thread-safe.
+   */
+  virtual bool TraverseInputsInParallel() const
+  {
+    return false;
+  }
+
 private:
   void PostProcessTable(const Node *node, const TimeRange &range, NodeValueTable &output_params);
 
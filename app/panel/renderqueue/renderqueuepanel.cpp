@@ -0,0 +1,212 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "renderqueuepanel.h"
+
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+#include "task/export/renderqueue.h"
+
+namespace olive {
+
+RenderQueuePanel::RenderQueuePanel(QWidget *parent) :
+  PanelWidget(QStringLiteral("RenderQueuePanel"), parent)
+{
+  QWidget* central = new QWidget();
+  QVBoxLayout* layout = new QVBoxLayout(central);
+
+  QHBoxLayout* button_layout = new QHBoxLayout();
+  layout->addLayout(button_layout);
+
+  pause_btn_ = new QPushButton();
+  pause_btn_->setCheckable(true);
+  connect(pause_btn_, &QPushButton::toggled, this, &RenderQueuePanel::SetPaused);
+  button_layout->addWidget(pause_btn_);
+
+  raise_btn_ = new QPushButton();
+  connect(raise_btn_, &QPushButton::clicked, this, &RenderQueuePanel::RaiseSelected);
+  button_layout->addWidget(raise_btn_);
+
+  lower_btn_ = new QPushButton();
+  connect(lower_btn_, &QPushButton::clicked, this, &RenderQueuePanel::LowerSelected);
+  button_layout->addWidget(lower_btn_);
+
+  remove_btn_ = new QPushButton();
+  connect(remove_btn_, &QPushButton::clicked, this, &RenderQueuePanel::RemoveSelected);
+  button_layout->addWidget(remove_btn_);
+
+  button_layout->addStretch();
+
+  job_list_ = new QTreeWidget();
+  job_list_->setColumnCount(4);
+  job_list_->setRootIsDecorated(false);
+  job_list_->setSelectionMode(QAbstractItemView::ExtendedSelection);
+  job_list_->header()->setSectionResizeMode(1, QHeaderView::Stretch);
+  connect(job_list_, &QTreeWidget::itemSelectionChanged, this, &RenderQueuePanel::UpdateButtons);
+  layout->addWidget(job_list_);
+
+  QHBoxLayout* limit_layout = new QHBoxLayout();
+  layout->addLayout(limit_layout);
+
+  running_jobs_lbl_ = new QLabel();
+  limit_layout->addWidget(running_jobs_lbl_);
+
+  running_jobs_edit_ = new QSpinBox();
+  running_jobs_edit_->setMinimum(1);
+  running_jobs_edit_->setValue(RenderQueue::instance()->GetMaximumRunningJobs());
+  connect(running_jobs_edit_, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+          RenderQueue::instance(), &RenderQueue::SetMaximumRunningJobs);
+  limit_layout->addWidget(running_jobs_edit_);
+
+  frames_per_job_lbl_ = new QLabel();
+  limit_layout->addWidget(frames_per_job_lbl_);
+
+  frames_per_job_edit_ = new QSpinBox();
+  frames_per_job_edit_->setMinimum(1);
+  frames_per_job_edit_->setMaximum(1024);
+  frames_per_job_edit_->setValue(RenderQueue::instance()->GetMaximumFramesPerJob());
+  connect(frames_per_job_edit_, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+          RenderQueue::instance(), &RenderQueue::SetMaximumFramesPerJob);
+  limit_layout->addWidget(frames_per_job_edit_);
+
+  limit_layout->addStretch();
+
+  SetWidgetWithPadding(central);
+
+  connect(RenderQueue::instance(), &RenderQueue::JobsChanged, this, &RenderQueuePanel::UpdateJobs);
+
+  Retranslate();
+}
+
+void RenderQueuePanel::Retranslate()
+{
+  SetTitle(tr("Render Queue"));
+
+  job_list_->setHeaderLabels({tr("Sequence"), tr("File"), tr("Priority"), tr("Status")});
+
+  pause_btn_->setText(pause_btn_->isChecked() ? tr("Resume") : tr("Pause"));
+  raise_btn_->setText(tr("Raise Priority"));
+  lower_btn_->setText(tr("Lower Priority"));
+  remove_btn_->setText(tr("Remove"));
+
+  running_jobs_lbl_->setText(tr("Simultaneous Exports:"));
+  frames_per_job_lbl_->setText(tr("Frames Per Export:"));
+
+  UpdateJobs();
+}
+
+QVector<int> RenderQueuePanel::GetSelectedJobs() const
+{
+  QVector<int> ids;
+
+  foreach (QTreeWidgetItem* item, job_list_->selectedItems()) {
+    ids.append(item->data(0, Qt::UserRole).toInt());
+  }
+
+  return ids;
+}
+
+void RenderQueuePanel::ChangeSelectedPriority(int change)
+{
+  QVector<int> ids = GetSelectedJobs();
+
+  foreach (const RenderQueue::Job& job, RenderQueue::instance()->GetJobs()) {
+    if (ids.contains(job.id)) {
+      RenderQueue::instance()->SetJobPriority(job.id, job.priority + change);
+    }
+  }
+}
+
+void RenderQueuePanel::UpdateJobs()
+{
+  QVector<int> selected = GetSelectedJobs();
+
+  job_list_->clear();
+
+  foreach (const RenderQueue::Job& job, RenderQueue::instance()->GetJobs()) {
+    QString status;
+
+    switch (job.state) {
+    case RenderQueue::kJobQueued:
+      status = tr("Queued");
+      break;
+    case RenderQueue::kJobRunning:
+      status = tr("Exporting");
+      break;
+    case RenderQueue::kJobFinished:
+      status = tr("Finished");
+      break;
+    case RenderQueue::kJobFailed:
+      status = tr("Failed");
+      break;
+    }
+
+    QTreeWidgetItem* item = new QTreeWidgetItem({job.viewer->media_name(),
+                                                 QFileInfo(job.params.filename()).fileName(),
+                                                 QString::number(job.priority),
+                                                 status});
+    item->setToolTip(1, job.params.filename());
+    item->setData(0, Qt::UserRole, job.id);
+    job_list_->addTopLevelItem(item);
+
+    item->setSelected(selected.contains(job.id));
+  }
+
+  UpdateButtons();
+}
+
+void RenderQueuePanel::UpdateButtons()
+{
+  bool any_selected = !job_list_->selectedItems().isEmpty();
+
+  raise_btn_->setEnabled(any_selected);
+  lower_btn_->setEnabled(any_selected);
+  remove_btn_->setEnabled(any_selected);
+}
+
+void RenderQueuePanel::SetPaused(bool paused)
+{
+  RenderQueue::instance()->SetPaused(paused);
+
+  pause_btn_->setText(paused ? tr("Resume") : tr("Pause"));
+}
+
+void RenderQueuePanel::RaiseSelected()
+{
+  ChangeSelectedPriority(1);
+}
+
+void RenderQueuePanel::LowerSelected()
+{
+  ChangeSelectedPriority(-1);
+}
+
+void RenderQueuePanel::RemoveSelected()
+{
+  // Running jobs refuse to be removed, they're cancelled from the task manager instead
+  foreach (int id, GetSelectedJobs()) {
+    RenderQueue::instance()->RemoveJob(id);
+  }
+}
+
+}
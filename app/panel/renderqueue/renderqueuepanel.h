@@ -0,0 +1,87 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef RENDERQUEUE_PANEL_H
+#define RENDERQUEUE_PANEL_H
+
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTreeWidget>
+
+#include "widget/panel/panel.h"
+
+namespace olive {
+
+/**
+ * @brief A panel for viewing and managing the exports waiting in the RenderQueue
+ */
+class RenderQueuePanel : public PanelWidget
+{
+  Q_OBJECT
+public:
+  RenderQueuePanel(QWidget* parent = nullptr);
+
+private:
+  virtual void Retranslate() override;
+
+  /**
+   * @brief Returns the IDs of the selected jobs
+   */
+  QVector<int> GetSelectedJobs() const;
+
+  void ChangeSelectedPriority(int change);
+
+  QTreeWidget* job_list_;
+
+  QPushButton* pause_btn_;
+
+  QPushButton* raise_btn_;
+
+  QPushButton* lower_btn_;
+
+  QPushButton* remove_btn_;
+
+  QLabel* running_jobs_lbl_;
+
+  QSpinBox* running_jobs_edit_;
+
+  QLabel* frames_per_job_lbl_;
+
+  QSpinBox* frames_per_job_edit_;
+
+private slots:
+  void UpdateJobs();
+
+  void UpdateButtons();
+
+  void SetPaused(bool paused);
+
+  void RaiseSelected();
+
+  void LowerSelected();
+
+  void RemoveSelected();
+
+};
+
+}
+
+#endif // RENDERQUEUE_PANEL_H
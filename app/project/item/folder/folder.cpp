@@ -69,6 +69,22 @@ void Folder::Load(QXmlStreamReader *reader, XMLNodeData& xml_node_data, uint ver
       child = new Footage();
     } else if (reader->name() == QStringLiteral("sequence")) {
       child = new Sequence();
+    } else if (reader->name() == QStringLiteral("sequenceref")) {
+      // A sequence that was loaded separately, find it by its pointer
+      child = nullptr;
+
+      XMLAttributeLoop(reader, attr) {
+        if (attr.name() == QStringLiteral("ptr")) {
+          child = xml_node_data.item_ptrs.value(attr.value().toULongLong());
+        }
+      }
+
+      reader->skipCurrentElement();
+
+      if (child) {
+        child->setParent(this);
+      }
+      continue;
     } else {
       reader->skipCurrentElement();
       continue;
@@ -80,12 +96,24 @@ void Folder::Load(QXmlStreamReader *reader, XMLNodeData& xml_node_data, uint ver
 }
 
 void Folder::Save(QXmlStreamWriter *writer) const
+{
+  Save(writer, true);
+}
+
+void Folder::Save(QXmlStreamWriter *writer, bool include_sequences) const
 {
   writer->writeAttribute(QStringLiteral("name"), name());
 
   writer->writeAttribute(QStringLiteral("ptr"), QString::number(reinterpret_cast<quintptr>(this)));
 
   foreach (Item* child, children()) {
+    if (!include_sequences && child->type() == Item::kSequence) {
+      writer->writeStartElement(QStringLiteral("sequenceref"));
+      writer->writeAttribute(QStringLiteral("ptr"), QString::number(reinterpret_cast<quintptr>(child)));
+      writer->writeEndElement(); // sequenceref
+      continue;
+    }
+
     switch (child->type()) {
     case Item::kFootage:
       writer->writeStartElement(QStringLiteral("footage"));
@@ -98,7 +126,11 @@ void Folder::Save(QXmlStreamWriter *writer) const
       break;
     }
 
-    child->Save(writer);
+    if (child->type() == Item::kFolder) {
+      static_cast<Folder*>(child)->Save(writer, include_sequences);
+    } else {
+      child->Save(writer);
+    }
 
     writer->writeEndElement(); // footage/folder/sequence
   }
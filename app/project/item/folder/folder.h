@@ -48,6 +48,13 @@ public:
 
   virtual void Save(QXmlStreamWriter* writer) const override;
 
+  /**
+   * @brief Save this folder, optionally writing sequences only as references to their pointers
+   *
+   * \see Project::SaveWithoutSequences()
+   */
+  void Save(QXmlStreamWriter* writer, bool include_sequences) const;
+
 private:
 
 };
@@ -20,11 +20,14 @@
 
 #include "item.h"
 
+#include "common/dirtygeneration.h"
+
 namespace olive {
 
 Item::Item() :
   item_parent_(nullptr),
-  project_(nullptr)
+  project_(nullptr),
+  dirty_generation_(NextDirtyGeneration())
 {
 }
 
@@ -41,6 +44,8 @@ void Item::set_name(const QString &n)
 {
   name_ = n;
 
+  MarkDirty();
+
   NameChangedEvent(n);
 }
 
@@ -114,6 +119,11 @@ bool Item::ChildExistsWithName(const QString &name)
   return ChildExistsWithNameInternal(name, this);
 }
 
+void Item::MarkDirty()
+{
+  dirty_generation_ = NextDirtyGeneration();
+}
+
 void Item::NameChangedEvent(const QString &)
 {
 }
@@ -125,6 +135,8 @@ void Item::childEvent(QChildEvent *event)
   Item* cast_test = dynamic_cast<Item*>(event->child());
 
   if (cast_test) {
+    MarkDirty();
+
     if (event->type() == QEvent::ChildAdded) {
 
       item_children_.append(cast_test);
@@ -112,6 +112,20 @@ public:
 
   bool ChildExistsWithName(const QString& name);
 
+  /**
+   * @brief Dirty generation of the last change to this item
+   *
+   * Derivatives that hold other objects may override this to include their changes too.
+   *
+   * \see NextDirtyGeneration()
+   */
+  virtual quint64 dirty_generation() const
+  {
+    return dirty_generation_;
+  }
+
+  void MarkDirty();
+
 protected:
   virtual void NameChangedEvent(const QString& name);
 
@@ -130,6 +144,8 @@ private:
 
   QString tooltip_;
 
+  quint64 dirty_generation_;
+
 };
 
 }
@@ -43,6 +43,16 @@ Sequence::Sequence()
   viewer_output_ = new ViewerOutput();
   viewer_output_->SetCanBeDeleted(false);
   AddNode(viewer_output_);
+
+  // Markers and the workarea aren't nodes, so track their changes here
+  connect(markers(), &TimelineMarkerList::MarkerAdded, this, [this](TimelineMarker* marker){
+    connect(marker, &TimelineMarker::TimeChanged, this, [this](){ MarkDirty(); });
+    connect(marker, &TimelineMarker::NameChanged, this, [this](){ MarkDirty(); });
+    MarkDirty();
+  });
+  connect(markers(), &TimelineMarkerList::MarkerRemoved, this, [this](){ MarkDirty(); });
+  connect(workarea(), &TimelineWorkArea::EnabledChanged, this, [this](){ MarkDirty(); });
+  connect(workarea(), &TimelineWorkArea::RangeChanged, this, [this](){ MarkDirty(); });
 }
 
 void Sequence::Load(QXmlStreamReader *reader, XMLNodeData& xml_node_data, uint version, const QAtomicInt *cancelled)
@@ -260,6 +270,8 @@ const VideoParams &Sequence::video_params() const
 void Sequence::set_video_params(const VideoParams &vparam)
 {
   viewer_output_->set_video_params(vparam);
+
+  MarkDirty();
 }
 
 const AudioParams &Sequence::audio_params() const
@@ -270,6 +282,8 @@ const AudioParams &Sequence::audio_params() const
 void Sequence::set_audio_params(const AudioParams &params)
 {
   viewer_output_->set_audio_params(params);
+
+  MarkDirty();
 }
 
 void Sequence::set_default_parameters()
@@ -26,6 +26,7 @@
 #include "common/xmlutils.h"
 #include "core.h"
 #include "dialog/progress/progress.h"
+#include "render/colorprocessorcache.h"
 #include "render/diskmanager.h"
 #include "window/mainwindow/mainwindow.h"
 
@@ -47,6 +48,11 @@ void Project::Load(QXmlStreamReader *reader, MainWindowLayoutInfo* layout, uint
 {
   XMLNodeData xml_node_data;
 
+  Load(reader, xml_node_data, layout, version, cancelled);
+}
+
+void Project::Load(QXmlStreamReader *reader, XMLNodeData &xml_node_data, MainWindowLayoutInfo *layout, uint version, const QAtomicInt *cancelled)
+{
   while (XMLReadNextStartElement(reader)) {
     if (reader->name() == QStringLiteral("root")) {
 
@@ -94,11 +100,25 @@ void Project::Load(QXmlStreamReader *reader, MainWindowLayoutInfo* layout, uint
 }
 
 void Project::Save(QXmlStreamWriter *writer) const
+{
+  SaveInternal(writer, true);
+
+  // Save main window project layout
+  MainWindowLayoutInfo main_window_info = Core::instance()->main_window()->SaveLayout();
+  main_window_info.toXml(writer);
+}
+
+void Project::SaveWithoutSequences(QXmlStreamWriter *writer) const
+{
+  SaveInternal(writer, false);
+}
+
+void Project::SaveInternal(QXmlStreamWriter *writer, bool include_sequences) const
 {
   writer->writeTextElement(QStringLiteral("cachepath"), cache_path(false));
 
   writer->writeStartElement(QStringLiteral("root"));
-  root_.Save(writer);
+  root_.Save(writer, include_sequences);
   writer->writeEndElement();
 
   writer->writeStartElement(QStringLiteral("colormanagement"));
@@ -108,10 +128,6 @@ void Project::Save(QXmlStreamWriter *writer) const
   writer->writeTextElement(QStringLiteral("default"), color_manager_.GetDefaultInputColorSpace());
 
   writer->writeEndElement(); // colormanagement
-
-  // Save main window project layout
-  MainWindowLayoutInfo main_window_info = Core::instance()->main_window()->SaveLayout();
-  main_window_info.toXml(writer);
 }
 
 Folder *Project::root()
@@ -204,6 +220,9 @@ const QString &Project::cache_path(bool default_if_empty) const
 
 void Project::ColorConfigChanged()
 {
+  // Any processors created from the old config are now invalid
+  ColorProcessorCache::Clear();
+
   QVector<Item*> footage = this->get_items_of_type(Item::kFootage);
 
   foreach (Item* item, footage) {
@@ -49,8 +49,25 @@ public:
 
   void Load(QXmlStreamReader* reader, MainWindowLayoutInfo *layout, uint version, const QAtomicInt* cancelled);
 
+  /**
+   * @brief Load using existing XML node data
+   *
+   * Allows items that were loaded separately (e.g. sequences in a binary project) to be resolved
+   * alongside the rest of the project.
+   */
+  void Load(QXmlStreamReader* reader, XMLNodeData& xml_node_data, MainWindowLayoutInfo *layout, uint version, const QAtomicInt* cancelled);
+
   void Save(QXmlStreamWriter* writer) const;
 
+  /**
+   * @brief Save the project without its sequences or the window layout
+   *
+   * Sequences are written as references to their pointers, to be resolved through
+   * XMLNodeData::item_ptrs when loading. Used by the binary project format, which stores each
+   * sequence separately so they can be loaded in parallel.
+   */
+  void SaveWithoutSequences(QXmlStreamWriter* writer) const;
+
   Folder* root();
 
   QString name() const;
@@ -84,6 +101,8 @@ signals:
   void ModifiedChanged(bool e);
 
 private:
+  void SaveInternal(QXmlStreamWriter* writer, bool include_sequences) const;
+
   Folder root_;
 
   QString filename_;
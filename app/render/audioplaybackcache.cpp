@@ -52,6 +52,10 @@ void AudioPlaybackCache::SetParameters(const AudioParams &params)
   // Restart empty file so there's always "something" to play
   ClearPlaylist();
 
+  // Existing summaries are unusable too
+  visual_ = AudioVisualWaveform();
+  visual_.set_channel_count(params_.channel_count());
+
   // Our current audio cache is unusable, so we truncate it automatically
   InvalidateAll();
 
@@ -143,6 +147,24 @@ void AudioPlaybackCache::WritePCM(const TimeRange &range, SampleBufferPtr sample
     }
   }
 
+  if (!ranges_we_validated.isEmpty()) {
+    // Keep the visual waveform in step with what we just wrote
+    AudioVisualWaveform written;
+
+    if (samples) {
+      written.set_channel_count(params_.channel_count());
+      written.OverwriteSamples(samples, params_.sample_rate());
+    }
+
+    foreach (const TimeRange& v, ranges_we_validated) {
+      if (samples) {
+        visual_.OverwriteSums(written, v.in(), v.in() - range.in(), v.length());
+      } else {
+        visual_.OverwriteSilence(v.in(), v.length());
+      }
+    }
+  }
+
   foreach (const TimeRange& v, ranges_we_validated) {
     Validate(v);
   }
@@ -162,6 +184,8 @@ void AudioPlaybackCache::ShiftEvent(const rational &from_in_time, const rational
     return;
   }
 
+  visual_.Shift(from_in_time, to_in_time);
+
   qint64 to = params_.time_to_bytes(to_in_time);
   qint64 from = params_.time_to_bytes(from_in_time);
 
@@ -262,6 +286,10 @@ void AudioPlaybackCache::LengthChangedEvent(const rational& old, const rational&
     return;
   }
 
+  if (visual_.length() > newlen) {
+    visual_.TrimOut(visual_.length() - newlen);
+  }
+
   qint64 new_len_in_bytes = params_.time_to_bytes(newlen);
 
   while (new_len_in_bytes < playlist_.GetLength()) {
@@ -298,9 +326,11 @@ AudioPlaybackCache::Segment AudioPlaybackCache::CreateSegment(const qint64 &size
 
   s.set_offset(offset);
 
-  // Create empty file
+  // Create silent file at full size, which keeps it safe to memory-map the whole segment even
+  // before any PCM has been written to it
   QFile f(s.filename());
   if (f.open(QFile::WriteOnly)) {
+    f.resize(size);
     f.close();
   }
 
@@ -384,17 +414,7 @@ void AudioPlaybackCache::UpdateOffsetsFrom(int index)
 
 QList<TimeRange> AudioPlaybackCache::GetValidRanges(const TimeRange& range, const qint64& job_time)
 {
-  QList<TimeRange> valid_ranges;
-
-  for (int i=jobs_.size()-1;i>=0;i--) {
-    const JobIdentifier& job = jobs_.at(i);
-
-    if (job_time >= job.job_time && job.range.OverlapsWith(range)) {
-      valid_ranges.append(job.range.Intersected(range));
-    }
-  }
-
-  return valid_ranges;
+  return GetRangesCurrentForJob(range, job_time);
 }
 
 AudioPlaybackCache::PlaybackDevice *AudioPlaybackCache::CreatePlaybackDevice(QObject* parent) const
@@ -408,6 +428,8 @@ AudioPlaybackCache::Segment::Segment(qint64 size, const QString &filename)
   filename_ = filename;
 }
 
+const int AudioPlaybackCache::PlaybackDevice::kMappedSegmentsAhead = 2;
+
 AudioPlaybackCache::PlaybackDevice::PlaybackDevice(const AudioPlaybackCache::Playlist &playlist, QObject *parent) :
   QIODevice(parent),
   playlist_(playlist),
@@ -421,6 +443,97 @@ AudioPlaybackCache::PlaybackDevice::~PlaybackDevice()
   close();
 }
 
+bool AudioPlaybackCache::PlaybackDevice::open(QIODevice::OpenMode mode)
+{
+  if (!QIODevice::open(mode)) {
+    return false;
+  }
+
+  mapped_segments_.fill({nullptr, nullptr, 0}, playlist_.size());
+
+  UpdateMappedSegments();
+
+  return true;
+}
+
+void AudioPlaybackCache::PlaybackDevice::close()
+{
+  while (!mapped_indexes_.isEmpty()) {
+    UnmapSegment(mapped_indexes_.last());
+  }
+  mapped_segments_.clear();
+
+  QIODevice::close();
+}
+
+void AudioPlaybackCache::PlaybackDevice::UpdateMappedSegments()
+{
+  if (current_segment_ < 0) {
+    return;
+  }
+
+  int last = qMin(current_segment_ + kMappedSegmentsAhead, mapped_segments_.size() - 1);
+
+  // Close segments outside the window, either played past or left behind by a seek
+  for (int i=mapped_indexes_.size()-1; i>=0; i--) {
+    int index = mapped_indexes_.at(i);
+
+    if (index < current_segment_ || index > last) {
+      UnmapSegment(index);
+    }
+  }
+
+  for (int i=current_segment_; i<=last; i++) {
+    if (!mapped_segments_.at(i).file) {
+      MapSegment(i);
+    }
+  }
+}
+
+void AudioPlaybackCache::PlaybackDevice::MapSegment(int index)
+{
+  const Segment& s = playlist_.at(index);
+  MappedSegment& m = mapped_segments_[index];
+
+  m.file = new QFile(s.filename());
+  m.data = nullptr;
+  m.size = 0;
+
+  mapped_indexes_.append(index);
+
+  if (m.file->open(QFile::ReadOnly)) {
+    // The file may be larger than the segment if it was trimmed, or smaller if it was created
+    // before segments were pre-sized
+    qint64 map_size = qMin(s.size(), m.file->size());
+
+    if (map_size > 0) {
+      m.data = reinterpret_cast<const char*>(m.file->map(0, map_size));
+
+      if (m.data) {
+        m.size = map_size;
+      } else {
+        qWarning() << "Failed to map audio segment" << s.filename();
+      }
+    }
+  } else {
+    qWarning() << "Failed to open audio segment" << s.filename();
+  }
+}
+
+void AudioPlaybackCache::PlaybackDevice::UnmapSegment(int index)
+{
+  MappedSegment& m = mapped_segments_[index];
+
+  // Closing or deleting the file will also unmap it
+  delete m.file;
+
+  m.file = nullptr;
+  m.data = nullptr;
+  m.size = 0;
+
+  mapped_indexes_.removeOne(index);
+}
+
 bool AudioPlaybackCache::PlaybackDevice::seek(qint64 pos)
 {
   // Default behavior
@@ -437,6 +550,8 @@ bool AudioPlaybackCache::PlaybackDevice::seek(qint64 pos)
   // Find position in segment
   segment_read_index_ = pos - playlist_.at(current_segment_).offset();
 
+  UpdateMappedSegments();
+
   return true;
 }
 
@@ -446,39 +561,40 @@ qint64 AudioPlaybackCache::PlaybackDevice::readData(char *data, qint64 maxSize)
 
   while (read_size < maxSize
          && current_segment_ >= 0
-         && current_segment_ < playlist_.size()) {
-    const Segment& cs = playlist_.at(current_segment_);
-    qint64 current_segment_sz = cs.size();
-    QFile segment_file(cs.filename());
+         && current_segment_ < mapped_segments_.size()) {
+    const MappedSegment& ms = mapped_segments_.at(current_segment_);
+    qint64 current_segment_sz = playlist_.at(current_segment_).size();
 
-    if (segment_file.open(QFile::ReadOnly)) {
-      // Seek to our stored index of this segment
-      segment_file.seek(segment_read_index_);
+    // Determine how many bytes to read
+    qint64 this_read_length = qMin(current_segment_sz - segment_read_index_,
+                                   maxSize - read_size);
 
-      // Determine how many bytes to read
-      qint64 this_read_length = qMin(current_segment_sz - segment_read_index_,
-                                     maxSize - read_size);
+    // Copy whatever is mapped, anything past it is silence
+    qint64 mapped_length = qBound(qint64(0), ms.size - segment_read_index_, this_read_length);
 
-      // Read those bytes
-      segment_file.read(data + read_size, this_read_length);
+    if (mapped_length > 0) {
+      memcpy(data + read_size, ms.data + segment_read_index_, mapped_length);
+    }
+
+    if (mapped_length < this_read_length) {
+      memset(data + read_size + mapped_length, 0, this_read_length - mapped_length);
+    }
 
-      // Close the file
-      segment_file.close();
+    // Add to the read index
+    segment_read_index_ += this_read_length;
 
-      // Add to the read index
-      segment_read_index_ += this_read_length;
+    // Add to the read size
+    read_size += this_read_length;
 
-      // Add to the read size
-      read_size += this_read_length;
+    // If we've reached the end of this segment, tick the counter over to the next segment
+    if (segment_read_index_ == current_segment_sz) {
+      // Jump to the next file
+      segment_read_index_ = 0;
+      current_segment_++;
 
-      // If we've reached the end of this segment, tick the counter over to the next segment
-      if (segment_read_index_ == current_segment_sz) {
-        // Jump to the next file
-        segment_read_index_ = 0;
-        current_segment_++;
+      if (current_segment_ < mapped_segments_.size()) {
+        UpdateMappedSegments();
       }
-    } else {
-      qWarning() << "Failed to read data from segment";
     }
   }
 
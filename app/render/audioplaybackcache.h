@@ -21,6 +21,9 @@
 #ifndef AUDIOPLAYBACKCACHE_H
 #define AUDIOPLAYBACKCACHE_H
 
+#include <QFile>
+
+#include "audio/audiovisualwaveform.h"
 #include "common/timerange.h"
 #include "codec/samplebuffer.h"
 #include "render/playbackcache.h"
@@ -71,6 +74,17 @@ public:
 
   QList<TimeRange> GetValidRanges(const TimeRange &range, const qint64 &job_time);
 
+  /**
+   * @brief Visual summary of everything written to this cache
+   *
+   * Kept up to date alongside the PCM so views can draw the whole cache without reading it back.
+   * Copies are cheap and safe to hand to other threads.
+   */
+  const AudioVisualWaveform& visual_waveform() const
+  {
+    return visual_;
+  }
+
   class Segment
   {
   public:
@@ -139,6 +153,18 @@ public:
 
     virtual ~PlaybackDevice() override;
 
+    /**
+     * @brief Opens the device, memory-mapping the segments around the read position
+     *
+     * Only a few segments are mapped at a time, since long sequences can have more segments than
+     * the process is allowed open files. Segments ahead of the read position are mapped before
+     * they're reached so that readData(), which is called from the audio output, rarely has to
+     * wait on the file system, and segments already played past are closed.
+     */
+    virtual bool open(OpenMode mode) override;
+
+    virtual void close() override;
+
     virtual bool isSequential() const override
     {
       return false;
@@ -162,8 +188,33 @@ public:
     }
 
   private:
+    struct MappedSegment {
+      QFile* file;
+      const char* data;
+      qint64 size;
+    };
+
+    /**
+     * @brief Map the current segment and the next few, and close any others
+     */
+    void UpdateMappedSegments();
+
+    void MapSegment(int index);
+
+    void UnmapSegment(int index);
+
+    /**
+     * @brief Amount of segments after the current one to keep mapped
+     */
+    static const int kMappedSegmentsAhead;
+
     Playlist playlist_;
 
+    QVector<MappedSegment> mapped_segments_;
+
+    // Indexes of segments in mapped_segments_ that currently have a file open
+    QVector<int> mapped_indexes_;
+
     int current_segment_;
 
     qint64 segment_read_index_;
@@ -212,6 +263,8 @@ private:
 
   AudioParams params_;
 
+  AudioVisualWaveform visual_;
+
 };
 
 }
@@ -76,6 +76,7 @@ ColorProcessor::ColorProcessor(ColorManager *config, const QString &input, const
 
   cpu_processor_ = processor_->getDefaultCPUProcessor();
   id_ = GenerateID(config, input, transform);
+  cache_id_ = processor_->getCacheID();
 }
 
 void ColorProcessor::ConvertFrame(Frame *f)
@@ -90,7 +91,7 @@ void ColorProcessor::ConvertFrame(Frame *f)
   OCIO::PackedImageDesc img(f->data(),
                             f->width(),
                             f->height(),
-                            VideoParams::kRGBAChannelCount,
+                            f->channel_count(),
                             ocio_bit_depth,
                             OCIO::AutoStride,
                             OCIO::AutoStride,
@@ -59,6 +59,17 @@ public:
     return id_;
   }
 
+  /**
+   * @brief OCIO's identifier for the operations this processor performs
+   *
+   * Unlike id(), two processors that perform identical operations will share this ID even if
+   * they were created from differently named transforms.
+   */
+  const QByteArray& cache_id() const
+  {
+    return cache_id_;
+  }
+
   static QString GenerateID(ColorManager* config, const QString& input, const ColorTransform& dest_space);
 
 private:
@@ -68,6 +79,8 @@ private:
 
   QString id_;
 
+  QByteArray cache_id_;
+
 };
 
 using ColorProcessorChain = QVector<ColorProcessorPtr>;
@@ -0,0 +1,80 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "colorprocessorcache.h"
+
+namespace olive {
+
+QHash<QString, ColorProcessorPtr> ColorProcessorCache::processors_;
+QReadWriteLock ColorProcessorCache::lock_;
+
+ColorProcessorPtr ColorProcessorCache::Get(ColorManager *config, const QString &input, const ColorTransform &dest_space)
+{
+  QString key = GenerateKey(config, input, dest_space);
+
+  {
+    QReadLocker locker(&lock_);
+
+    ColorProcessorPtr existing = processors_.value(key);
+    if (existing) {
+      return existing;
+    }
+  }
+
+  // Create the processor outside of our lock since it will lock the ColorManager instead
+  ColorProcessorPtr processor = ColorProcessor::Create(config, input, dest_space);
+
+  QWriteLocker locker(&lock_);
+
+  // Another thread may have created the same processor while we were, in which case prefer
+  // theirs so that everyone shares the same instance
+  ColorProcessorPtr existing = processors_.value(key);
+  if (existing) {
+    return existing;
+  }
+
+  processors_.insert(key, processor);
+
+  return processor;
+}
+
+void ColorProcessorCache::Clear()
+{
+  QWriteLocker locker(&lock_);
+
+  processors_.clear();
+}
+
+int ColorProcessorCache::count()
+{
+  QReadLocker locker(&lock_);
+
+  return processors_.size();
+}
+
+QString ColorProcessorCache::GenerateKey(ColorManager *config, const QString &input, const ColorTransform &dest_space)
+{
+  // ColorProcessor's ID doesn't distinguish a display from a colorspace of the same name, so we
+  // add that here
+  return QStringLiteral("%1:%2").arg(ColorProcessor::GenerateID(config, input, dest_space),
+                                     dest_space.is_display() ? QStringLiteral("d") : QStringLiteral("c"));
+}
+
+}
@@ -21,12 +21,46 @@
 #ifndef COLORPROCESSORCACHE_H
 #define COLORPROCESSORCACHE_H
 
-#include "project/item/footage/stream.h"
+#include <QHash>
+#include <QReadWriteLock>
+
 #include "render/colorprocessor.h"
 
 namespace olive {
 
-using ColorProcessorCache = QHash<QString, ColorProcessorPtr>;
+/**
+ * @brief Process-wide cache of ColorProcessors keyed by their transform
+ *
+ * Building an OCIO processor requires locking the ColorManager and walking the config, which is
+ * far too expensive to do for every frame. Since a processor is immutable once created, any
+ * number of render threads can share one. The cache must be cleared whenever a color config
+ * changes so stale processors aren't handed out.
+ *
+ * All functions are thread-safe.
+ */
+class ColorProcessorCache
+{
+public:
+  /**
+   * @brief Retrieve a processor for this transform, creating it if it doesn't exist yet
+   */
+  static ColorProcessorPtr Get(ColorManager* config, const QString& input, const ColorTransform& dest_space);
+
+  /**
+   * @brief Remove all cached processors
+   */
+  static void Clear();
+
+  static int count();
+
+private:
+  static QString GenerateKey(ColorManager* config, const QString& input, const ColorTransform& dest_space);
+
+  static QHash<QString, ColorProcessorPtr> processors_;
+
+  static QReadWriteLock lock_;
+
+};
 
 }
 
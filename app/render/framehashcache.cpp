@@ -45,22 +45,17 @@ FrameHashCache::FrameHashCache(QObject *parent) :
 
 QByteArray FrameHashCache::GetHash(const rational &time)
 {
-  return time_hash_map_.value(time);
+  return time_hash_map_.GetHash(time);
 }
 
 void FrameHashCache::SetHash(const rational &time, const QByteArray &hash, const qint64& job_time, bool frame_exists)
 {
-  for (int i=jobs_.size()-1; i>=0; i--) {
-    const JobIdentifier& job = jobs_.at(i);
-
-    if (job.range.Contains(time)
-        && job_time < job.job_time) {
-      // Hash here has changed since this frame started rendering, discard it
-      return;
-    }
+  if (!IsJobCurrent(time, job_time)) {
+    // Hash here has changed since this frame started rendering, discard it
+    return;
   }
 
-  time_hash_map_.insert(time, hash);
+  time_hash_map_.SetHash(time, hash);
 
   TimeRange validated_range;
   if (frame_exists) {
@@ -78,45 +73,23 @@ void FrameHashCache::ValidateFramesWithHash(const QByteArray &hash)
 {
   const TimeRangeList& invalidated_ranges = GetInvalidatedRanges();
 
-  for (auto iterator=time_hash_map_.begin();iterator!=time_hash_map_.end();iterator++) {
-    if (iterator.value() == hash) {
-      TimeRange frame_range(iterator.key(), iterator.key() + timebase_);
+  foreach (const rational& time, time_hash_map_.GetFramesWithHash(hash)) {
+    TimeRange frame_range(time, time + timebase_);
 
-      if (invalidated_ranges.contains(frame_range)) {
-        Validate(frame_range);
-      }
+    if (invalidated_ranges.contains(frame_range)) {
+      Validate(frame_range);
     }
   }
 }
 
 QList<rational> FrameHashCache::GetFramesWithHash(const QByteArray &hash)
 {
-  QList<rational> times;
-
-  for (auto iterator=time_hash_map_.begin();iterator!=time_hash_map_.end();iterator++) {
-    if (iterator.value() == hash) {
-      times.append(iterator.key());
-    }
-  }
-
-  return times;
+  return time_hash_map_.GetFramesWithHash(hash);
 }
 
 QList<rational> FrameHashCache::TakeFramesWithHash(const QByteArray &hash)
 {
-  QList<rational> times;
-
-  auto iterator = time_hash_map_.begin();
-
-  while (iterator != time_hash_map_.end()) {
-    if (iterator.value() == hash) {
-      times.append(iterator.key());
-
-      iterator = time_hash_map_.erase(iterator);
-    } else {
-      iterator++;
-    }
-  }
+  QList<rational> times = time_hash_map_.TakeFramesWithHash(hash);
 
   foreach (const rational& r, times) {
     Invalidate(TimeRange(r, r + timebase_));
@@ -125,11 +98,6 @@ QList<rational> FrameHashCache::TakeFramesWithHash(const QByteArray &hash)
   return times;
 }
 
-QMap<rational, QByteArray> FrameHashCache::time_hash_map()
-{
-  return time_hash_map_;
-}
-
 QString FrameHashCache::GetFormatExtension()
 {
   return QStringLiteral(".exr");
@@ -274,57 +242,13 @@ FramePtr FrameHashCache::LoadCacheFrame(const QString &fn)
 void FrameHashCache::LengthChangedEvent(const rational &old, const rational &newlen)
 {
   if (newlen < old) {
-    auto i = time_hash_map_.begin();
-
-    while (i != time_hash_map_.end()) {
-      if (i.key() >= newlen) {
-        i = time_hash_map_.erase(i);
-      } else {
-        i++;
-      }
-    }
+    time_hash_map_.Truncate(newlen);
   }
 }
 
-struct HashTimePair {
-  rational time;
-  QByteArray hash;
-};
-
 void FrameHashCache::ShiftEvent(const rational &from, const rational &to)
 {
-  auto i = time_hash_map_.begin();
-
-  // POSITIVE if moving forward ->
-  // NEGATIVE if moving backward <-
-  rational diff = to - from;
-  bool diff_is_negative = (diff < rational());
-
-  QList<HashTimePair> shifted_times;
-
-  while (i != time_hash_map_.end()) {
-    if (diff_is_negative && i.key() >= to && i.key() < from) {
-
-      // This time will be removed in the shift so we just discard it
-      i = time_hash_map_.erase(i);
-
-    } else if (i.key() >= from) {
-
-      // This time is after the from time and must be shifted
-      shifted_times.append({i.key() + diff, i.value()});
-      i = time_hash_map_.erase(i);
-
-    } else {
-
-      // Do nothing
-      i++;
-
-    }
-  }
-
-  foreach (const HashTimePair& p, shifted_times) {
-    time_hash_map_.insert(p.time, p.hash);
-  }
+  time_hash_map_.Shift(from, to);
 }
 
 void FrameHashCache::InvalidateEvent(const TimeRange &range)
@@ -332,7 +256,7 @@ void FrameHashCache::InvalidateEvent(const TimeRange &range)
   QVector<rational> invalid_frames = GetFrameListFromTimeRange({range});
 
   foreach (const rational& r, invalid_frames) {
-    time_hash_map_.remove(r);
+    time_hash_map_.Remove(r);
   }
 }
 
@@ -344,10 +268,8 @@ void FrameHashCache::HashDeleted(const QString& s, const QByteArray &hash)
   }
 
   TimeRangeList ranges_to_invalidate;
-  for (auto i=time_hash_map_.constBegin(); i!=time_hash_map_.constEnd(); i++) {
-    if (i.value() == hash) {
-      ranges_to_invalidate.insert(TimeRange(i.key(), i.key() + timebase_));
-    }
+  foreach (const rational& time, time_hash_map_.GetFramesWithHash(hash)) {
+    ranges_to_invalidate.insert(TimeRange(time, time + timebase_));
   }
 
   foreach (const TimeRange& range, ranges_to_invalidate) {
@@ -358,7 +280,7 @@ void FrameHashCache::HashDeleted(const QString& s, const QByteArray &hash)
 void FrameHashCache::ProjectInvalidated(Project *p)
 {
   if (GetProject() == p) {
-    time_hash_map_.clear();
+    time_hash_map_.Clear();
 
     InvalidateAll();
   }
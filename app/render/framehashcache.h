@@ -26,6 +26,7 @@
 #include "common/rational.h"
 #include "common/timerange.h"
 #include "codec/frame.h"
+#include "render/framehashmap.h"
 #include "render/playbackcache.h"
 #include "render/videoparams.h"
 
@@ -53,8 +54,6 @@ public:
    */
   QList<rational> TakeFramesWithHash(const QByteArray& hash);
 
-  QMap<rational, QByteArray> time_hash_map();
-
   /**
    * @brief Return the path of the cached image at this time
    */
@@ -86,7 +85,7 @@ protected:
   virtual void InvalidateEvent(const TimeRange& range) override;
 
 private:
-  QMap<rational, QByteArray> time_hash_map_;
+  FrameHashMap time_hash_map_;
 
   rational timebase_;
 
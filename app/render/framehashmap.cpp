@@ -0,0 +1,115 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "framehashmap.h"
+
+#include "common/tick.h"
+
+namespace olive {
+
+QByteArray FrameHashMap::GetHash(const rational &time) const
+{
+  return map_.value(Tick::from_time(time)).hash;
+}
+
+void FrameHashMap::SetHash(const rational &time, const QByteArray &hash)
+{
+  map_.insert(Tick::from_time(time), {time, hash});
+}
+
+void FrameHashMap::Remove(const rational &time)
+{
+  map_.remove(Tick::from_time(time));
+}
+
+QList<rational> FrameHashMap::GetFramesWithHash(const QByteArray &hash) const
+{
+  QList<rational> times;
+
+  for (auto iterator=map_.cbegin();iterator!=map_.cend();iterator++) {
+    if (iterator.value().hash == hash) {
+      times.append(iterator.value().time);
+    }
+  }
+
+  return times;
+}
+
+QList<rational> FrameHashMap::TakeFramesWithHash(const QByteArray &hash)
+{
+  QList<rational> times;
+
+  auto iterator = map_.begin();
+
+  while (iterator != map_.end()) {
+    if (iterator.value().hash == hash) {
+      times.append(iterator.value().time);
+
+      iterator = map_.erase(iterator);
+    } else {
+      iterator++;
+    }
+  }
+
+  return times;
+}
+
+void FrameHashMap::Truncate(const rational &length)
+{
+  // Everything from the length onwards is sorted at the end of the map
+  auto i = map_.lowerBound(Tick::from_time(length));
+
+  while (i != map_.end()) {
+    i = map_.erase(i);
+  }
+}
+
+void FrameHashMap::Shift(const rational &from, const rational &to)
+{
+  // POSITIVE if moving forward ->
+  // NEGATIVE if moving backward <-
+  rational diff = to - from;
+  bool diff_is_negative = (diff < rational());
+
+  int64_t from_ticks = Tick::from_time(from);
+
+  // Everything before the earlier of the two times is untouched, so skip straight past it
+  auto i = map_.lowerBound(diff_is_negative ? Tick::from_time(to) : from_ticks);
+
+  QList<HashTimePair> shifted_times;
+
+  while (i != map_.end()) {
+    if (i.key() >= from_ticks) {
+
+      // This time is after the from time and must be shifted
+      shifted_times.append({i.value().time + diff, i.value().hash});
+
+    }
+
+    // Times between `to` and `from` are removed in a backwards shift so they're just discarded
+    i = map_.erase(i);
+  }
+
+  foreach (const HashTimePair& p, shifted_times) {
+    map_.insert(Tick::from_time(p.time), p);
+  }
+}
+
+}
@@ -0,0 +1,96 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef FRAMEHASHMAP_H
+#define FRAMEHASHMAP_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+
+#include "common/rational.h"
+
+namespace olive {
+
+/**
+ * @brief The hash of each frame FrameHashCache knows about, sorted by time
+ *
+ * Frames are keyed by ticks so lookups compare integers rather than rationals, \see Tick. The
+ * exact time is kept alongside for timebases that don't convert to ticks losslessly.
+ */
+class FrameHashMap
+{
+public:
+  FrameHashMap() = default;
+
+  /**
+   * @brief Returns the hash at `time`, or an empty QByteArray if there isn't one
+   */
+  QByteArray GetHash(const rational& time) const;
+
+  void SetHash(const rational& time, const QByteArray& hash);
+
+  void Remove(const rational& time);
+
+  void Clear()
+  {
+    map_.clear();
+  }
+
+  int Count() const
+  {
+    return map_.size();
+  }
+
+  /**
+   * @brief Returns the times of every frame with `hash`, from earliest to latest
+   */
+  QList<rational> GetFramesWithHash(const QByteArray& hash) const;
+
+  /**
+   * @brief Same as GetFramesWithHash() but also removes these frames
+   */
+  QList<rational> TakeFramesWithHash(const QByteArray& hash);
+
+  /**
+   * @brief Remove every frame at or after `length`
+   */
+  void Truncate(const rational& length);
+
+  /**
+   * @brief Move every frame at or after `from` by `to - from`
+   *
+   * If moving backwards, frames between `to` and `from` are removed since they're overwritten.
+   */
+  void Shift(const rational& from, const rational& to);
+
+private:
+  struct HashTimePair {
+    rational time;
+    QByteArray hash;
+  };
+
+  QMap<int64_t, HashTimePair> map_;
+
+};
+
+}
+
+#endif // FRAMEHASHMAP_H
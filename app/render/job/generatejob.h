@@ -42,9 +42,29 @@ public:
     alpha_channel_required_ = e;
   }
 
+  /**
+   * @brief Shader to draw a coverage frame with, or empty if the generator outputs final pixels
+   *
+   * If set, Node::GenerateFrame() receives a single-channel 8-bit frame to write coverage into.
+   * The renderer uploads it as-is and draws it through this shader (see Node::GetShaderCode())
+   * with the coverage as `ove_maintex` and the job's values as uniforms, so colorizing happens on
+   * the GPU rather than per-pixel on the CPU.
+   */
+  const QString& GetCoverageShaderID() const
+  {
+    return coverage_shader_id_;
+  }
+
+  void SetCoverageShaderID(const QString& id)
+  {
+    coverage_shader_id_ = id;
+  }
+
 private:
   bool alpha_channel_required_;
 
+  QString coverage_shader_id_;
+
 };
 
 }
@@ -30,10 +30,28 @@ namespace olive {
 
 class ShaderJob : public GenerateJob {
 public:
+  /**
+   * @brief Describes how this job may be merged with adjacent jobs into a single draw
+   *
+   * See ShaderChain for how these are combined.
+   */
+  enum Fusion {
+    /// Job must be run on its own
+    kFusionNone,
+
+    /// Job draws its input with the default shader, positioned only by a 2D `ove_mvpmat`
+    kFusionMatrix,
+
+    /// Job runs `crop.frag` on its input
+    kFusionCrop
+  };
+
   ShaderJob()
   {
     iterations_ = 1;
     iterative_input_ = nullptr;
+    iterative_format_ = VideoParams::kFormatInvalid;
+    fusion_ = kFusionNone;
   }
 
   const QString& GetShaderID() const
@@ -67,6 +85,22 @@ public:
     return iterative_input_;
   }
 
+  /**
+   * @brief Pixel format of the textures passed between iterations
+   *
+   * Defaults to kFormatInvalid, which uses the destination's format. Set this if the iterations
+   * store something other than color that needs more precision than the destination might have.
+   */
+  VideoParams::Format GetIterativeFormat() const
+  {
+    return iterative_format_;
+  }
+
+  void SetIterativeFormat(VideoParams::Format format)
+  {
+    iterative_format_ = format;
+  }
+
   Texture::Interpolation GetInterpolation(const QString& id) const
   {
     return interpolation_.value(id, Texture::kDefaultInterpolation);
@@ -82,6 +116,27 @@ public:
     interpolation_.insert(id, interp);
   }
 
+  Fusion GetFusion() const
+  {
+    return fusion_;
+  }
+
+  const QString& GetFusionInput() const
+  {
+    return fusion_input_;
+  }
+
+  void SetFusion(Fusion fusion, NodeInput* main_input)
+  {
+    SetFusion(fusion, main_input->id());
+  }
+
+  void SetFusion(Fusion fusion, const QString& main_input)
+  {
+    fusion_ = fusion;
+    fusion_input_ = main_input;
+  }
+
 private:
   QString shader_id_;
 
@@ -89,8 +144,14 @@ private:
 
   QString iterative_input_;
 
+  VideoParams::Format iterative_format_;
+
   QHash<QString, Texture::Interpolation> interpolation_;
 
+  Fusion fusion_;
+
+  QString fusion_input_;
+
 };
 
 }
@@ -521,12 +521,17 @@ void OpenGLRenderer::Blit(QVariant s, ShaderJob job, Texture *destination, Video
 
   TexturePtr output_tex, input_tex;
   if (real_iteration_count > 1) {
+    VideoParams iterative_params = destination_params;
+    if (job.GetIterativeFormat() != VideoParams::kFormatInvalid) {
+      iterative_params.set_format(job.GetIterativeFormat());
+    }
+
     // Create one texture to bounce off
-    output_tex = CreateTexture(destination_params);
+    output_tex = CreateTexture(iterative_params);
 
     if (real_iteration_count > 2) {
       // Create a second texture bounce off
-      input_tex = CreateTexture(destination_params);
+      input_tex = CreateTexture(iterative_params);
     }
   }
 
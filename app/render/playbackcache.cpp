@@ -20,6 +20,7 @@
 
 #include "playbackcache.h"
 
+#include <algorithm>
 #include <QDateTime>
 
 #include "node/output/viewer/viewer.h"
@@ -38,9 +39,7 @@ void PlaybackCache::Invalidate(const TimeRange &r)
 
   invalidated_.insert(r);
 
-  RemoveRangeFromJobs(r);
-  qint64 job_time = QDateTime::currentMSecsSinceEpoch();
-  jobs_.append({r, job_time});
+  SetJobTime(r, QDateTime::currentMSecsSinceEpoch());
 
   InvalidateEvent(r);
 
@@ -73,7 +72,7 @@ void PlaybackCache::SetLength(const rational &r)
   } else if (r > length_) {
     // If new length is greater, simply extend the invalidated range for now
     invalidated_.insert(range_diff);
-    jobs_.append({range_diff, QDateTime::currentMSecsSinceEpoch()});
+    SetJobTime(range_diff, QDateTime::currentMSecsSinceEpoch());
   } else {
     // If new length is smaller, removed hashes
     invalidated_.remove(range_diff);
@@ -159,29 +158,147 @@ Project *PlaybackCache::GetProject() const
   return sequence->project();
 }
 
+// Beyond this many jobs, the closest neighboring jobs are merged until half as many are left, so
+// the merging only happens once every few hundred invalidations
+const int kMaxJobCount = 1024;
+const int kCoalescedJobCount = kMaxJobCount / 2;
+
+bool PlaybackCache::IsJobCurrent(const rational &time, qint64 job_time) const
+{
+  int index = FindFirstJobEndingAfter(time);
+
+  if (index < jobs_.size() && jobs_.at(index).range.Contains(time)) {
+    return job_time >= jobs_.at(index).job_time;
+  }
+
+  return true;
+}
+
+QList<TimeRange> PlaybackCache::GetRangesCurrentForJob(const TimeRange &range, qint64 job_time) const
+{
+  QList<TimeRange> valid_ranges;
+
+  for (int i=FindFirstJobEndingAfter(range.in()); i<jobs_.size() && jobs_.at(i).range.in() < range.out(); i++) {
+    const JobIdentifier& job = jobs_.at(i);
+
+    if (job_time >= job.job_time) {
+      valid_ranges.append(job.range.Intersected(range));
+    }
+  }
+
+  return valid_ranges;
+}
+
+void PlaybackCache::SetJobTime(const TimeRange &range, qint64 job_time)
+{
+  RemoveRangeFromJobs(range);
+
+  int index = FindFirstJobEndingAfter(range.in());
+
+  // Coalesce with neighbors invalidated at the same time
+  bool merge_before = (index > 0
+                       && jobs_.at(index - 1).job_time == job_time
+                       && jobs_.at(index - 1).range.out() == range.in());
+
+  bool merge_after = (index < jobs_.size()
+                      && jobs_.at(index).job_time == job_time
+                      && jobs_.at(index).range.in() == range.out());
+
+  if (merge_before && merge_after) {
+    jobs_[index - 1].range.set_out(jobs_.at(index).range.out());
+    jobs_.removeAt(index);
+  } else if (merge_before) {
+    jobs_[index - 1].range.set_out(range.out());
+  } else if (merge_after) {
+    jobs_[index].range.set_in(range.in());
+  } else {
+    jobs_.insert(index, {range, job_time});
+  }
+
+  if (jobs_.size() > kMaxJobCount) {
+    CoalesceJobs();
+  }
+}
+
 void PlaybackCache::RemoveRangeFromJobs(const TimeRange &remove)
 {
-  // Code shamelessly copied from TimeRangeList::RemoveTimeRange
-  for (int i=0;i<jobs_.size();i++) {
-    JobIdentifier& job = jobs_[i];
-    TimeRange& compare = job.range;
-
-    if (remove.Contains(compare)) {
-      // This element is entirely encompassed in this range, remove it
-      jobs_.removeAt(i);
-      i--;
-    } else if (compare.Contains(remove, false, false)) {
-      // The remove range is within this element, only choice is to split the element into two
-      jobs_.append({TimeRange(remove.out(), compare.out()), job.job_time});
-      compare.set_out(remove.in());
-    } else if (compare.in() < remove.in() && compare.out() > remove.in()) {
-      // This element's out point overlaps the range's in, we'll trim it
-      compare.set_out(remove.in());
-    } else if (compare.in() < remove.out() && compare.out() > remove.out()) {
-      // This element's in point overlaps the range's out, we'll trim it
-      compare.set_in(remove.out());
+  int first = FindFirstJobEndingAfter(remove.in());
+  int last = first;
+
+  while (last < jobs_.size() && jobs_.at(last).range.in() < remove.out()) {
+    last++;
+  }
+
+  if (first == last) {
+    return;
+  }
+
+  // Keep whatever's left of the jobs either side of the removed range
+  QVector<JobIdentifier> remainder;
+
+  const JobIdentifier& first_job = jobs_.at(first);
+  if (first_job.range.in() < remove.in()) {
+    remainder.append({TimeRange(first_job.range.in(), remove.in()), first_job.job_time});
+  }
+
+  const JobIdentifier& last_job = jobs_.at(last - 1);
+  if (last_job.range.out() > remove.out()) {
+    remainder.append({TimeRange(remove.out(), last_job.range.out()), last_job.job_time});
+  }
+
+  jobs_.remove(first, last - first);
+
+  for (int i=0; i<remainder.size(); i++) {
+    jobs_.insert(first + i, remainder.at(i));
+  }
+}
+
+int PlaybackCache::FindFirstJobEndingAfter(const rational &time) const
+{
+  auto it = std::upper_bound(jobs_.cbegin(), jobs_.cend(), time, [](const rational& t, const JobIdentifier& j){
+    return t < j.range.out();
+  });
+
+  return it - jobs_.cbegin();
+}
+
+void PlaybackCache::CoalesceJobs()
+{
+  // Order the gaps between neighboring jobs from smallest to largest, touching jobs first
+  QVector<int> gaps(jobs_.size() - 1);
+  for (int i=0; i<gaps.size(); i++) {
+    gaps[i] = i;
+  }
+
+  std::sort(gaps.begin(), gaps.end(), [this](int a, int b){
+    return jobs_.at(a + 1).range.in() - jobs_.at(a).range.out()
+        < jobs_.at(b + 1).range.in() - jobs_.at(b).range.out();
+  });
+
+  // Close the smallest gaps, each one joins a job to the one after it
+  QVector<bool> join_next(jobs_.size(), false);
+  for (int i=0; i<jobs_.size()-kCoalescedJobCount; i++) {
+    join_next[gaps.at(i)] = true;
+  }
+
+  // Merged jobs keep the newest time and cover the gaps between them. At worst, this rejects a
+  // result that was actually still current, which just gets rendered again.
+  QVector<JobIdentifier> coalesced;
+  coalesced.reserve(kCoalescedJobCount);
+
+  for (int i=0; i<jobs_.size(); i++) {
+    const JobIdentifier& job = jobs_.at(i);
+
+    if (i > 0 && join_next.at(i - 1)) {
+      JobIdentifier& previous = coalesced.last();
+      previous.range.set_out(job.range.out());
+      previous.job_time = qMax(previous.job_time, job.job_time);
+    } else {
+      coalesced.append(job);
     }
   }
+
+  jobs_ = coalesced;
 }
 
 QString PlaybackCache::GetCacheDirectory() const
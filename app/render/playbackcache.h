@@ -61,6 +61,16 @@ public:
 
   QString GetCacheDirectory() const;
 
+  /**
+   * @brief Number of ranges currently tracked for rejecting stale jobs
+   *
+   * This is bounded regardless of how many times the cache has been invalidated.
+   */
+  int GetJobCount() const
+  {
+    return jobs_.size();
+  }
+
 public slots:
   void Invalidate(const TimeRange& r);
 
@@ -90,16 +100,43 @@ protected:
 
   Project* GetProject() const;
 
+  /**
+   * @brief Returns whether a job started at `job_time` is still current at `time`
+   *
+   * A job is stale if `time` has been invalidated since it started.
+   */
+  bool IsJobCurrent(const rational& time, qint64 job_time) const;
+
+  /**
+   * @brief Parts of `range` that haven't been invalidated since `job_time`
+   */
+  QList<TimeRange> GetRangesCurrentForJob(const TimeRange& range, qint64 job_time) const;
+
+private:
   struct JobIdentifier {
     TimeRange range;
     qint64 job_time;
   };
 
-  QList<JobIdentifier> jobs_;
+  void SetJobTime(const TimeRange& range, qint64 job_time);
 
-private:
   void RemoveRangeFromJobs(const TimeRange& remove);
 
+  /**
+   * @brief Index of the first job whose range ends after `time`
+   */
+  int FindFirstJobEndingAfter(const rational& time) const;
+
+  /**
+   * @brief Merge the closest neighboring jobs once there are too many
+   */
+  void CoalesceJobs();
+
+  /**
+   * @brief Time each range was last invalidated, sorted and non-overlapping
+   */
+  QVector<JobIdentifier> jobs_;
+
   TimeRangeList invalidated_;
 
   rational length_;
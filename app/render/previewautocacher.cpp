@@ -30,7 +30,7 @@ PreviewAutoCacher::PreviewAutoCacher() :
   connect(&delayed_requeue_timer_, &QTimer::timeout, this, &PreviewAutoCacher::RequeueFrames);
 }
 
-RenderTicketPtr PreviewAutoCacher::GetSingleFrame(const rational &t)
+RenderTicketPtr PreviewAutoCacher::GetSingleFrame(const rational &t, RenderTicket::Priority priority, qint64 deadline)
 {
   if (single_frame_render_) {
     single_frame_render_->Cancel();
@@ -39,6 +39,7 @@ RenderTicketPtr PreviewAutoCacher::GetSingleFrame(const rational &t)
   single_frame_render_ = std::make_shared<RenderTicket>();
 
   single_frame_render_->setProperty("time", QVariant::fromValue(t));
+  single_frame_render_->SetPriority(priority, deadline);
 
   // Copy because TryRender() might set this to null and we still want to return a handle to this
   RenderTicketPtr copy = single_frame_render_;
@@ -255,7 +256,7 @@ void PreviewAutoCacher::VideoRendered()
       w->SetTicket(RenderManager::instance()->SaveFrameToCache(viewer_node_->video_frame_cache(),
                                                                watcher->Get().value<FramePtr>(),
                                                                hash,
-                                                               true));
+                                                               RenderTicket::kPriorityInteractive));
     }
 
     video_tasks_.remove(watcher);
@@ -306,6 +307,10 @@ void PreviewAutoCacher::VideoParamsChanged()
 
   ClearVideoQueue();
   video_params_changed_ = true;
+
+  // Intermediates are sized by the sequence, so the idle ones are unlikely to be used again
+  RenderManager::instance()->ClearTexturePool();
+
   TryRender();
 }
 
@@ -572,7 +577,8 @@ void PreviewAutoCacher::TryRender()
         RenderTicketWatcher* watcher = new RenderTicketWatcher();
         connect(watcher, &RenderTicketWatcher::Finished, this, &PreviewAutoCacher::AudioRendered);
         audio_tasks_.insert(watcher, r);
-        watcher->SetTicket(RenderManager::instance()->RenderAudio(copied_viewer_node_, r, true));
+        watcher->SetTicket(RenderManager::instance()->RenderAudio(copied_viewer_node_, r, true,
+                                                                  RenderTicket::kPriorityCache));
       }
     }
 
@@ -593,7 +599,8 @@ void PreviewAutoCacher::TryRender()
                                                               single_frame_render_->property("time").value<rational>(),
                                                               RenderMode::kOffline,
                                                               viewer_node_->video_frame_cache(),
-                                                              true));
+                                                              single_frame_render_->GetPriority(),
+                                                              single_frame_render_->GetDeadline()));
 
     single_frame_render_ = nullptr;
   }
@@ -638,7 +645,7 @@ void PreviewAutoCacher::RequeueFrames()
                                                                   color_manager_,
                                                                   t, RenderMode::kOffline,
                                                                   viewer_node_->video_frame_cache(),
-                                                                  false));
+                                                                  RenderTicket::kPriorityCache));
       }
     }
 
@@ -22,7 +22,14 @@ class PreviewAutoCacher : public QObject
 public:
   PreviewAutoCacher();
 
-  RenderTicketPtr GetSingleFrame(const rational& t);
+  /**
+   * @brief Render a single frame outside of the auto-cache
+   *
+   * `priority` and `deadline` are passed through to RenderManager::RenderFrame().
+   */
+  RenderTicketPtr GetSingleFrame(const rational& t,
+                                 RenderTicket::Priority priority = RenderTicket::kPriorityInteractive,
+                                 qint64 deadline = 0);
 
   /**
    * @brief Set the viewer node to auto-cache
@@ -26,10 +26,18 @@
 
 namespace olive {
 
-Renderer::Renderer(QObject *parent) :
-  QObject(parent)
+uint qHash(const Renderer::TexturePoolKey &key, uint seed)
 {
+  return ::qHash(key.width, seed) ^ ::qHash(key.height, seed)
+      ^ ::qHash(int(key.format), seed) ^ ::qHash(key.channel_count, seed);
+}
 
+Renderer::Renderer(QObject *parent) :
+  QObject(parent),
+  texture_pool_limit_(0),
+  texture_pool_release_count_(0),
+  texture_pool_stats_()
+{
 }
 
 TexturePtr Renderer::CreateTexture(const VideoParams &params, Texture::Type type, const void *data, int linesize)
@@ -40,6 +48,19 @@ TexturePtr Renderer::CreateTexture(const VideoParams &params, Texture::Type type
     v = CreateNativeTexture3D(params.effective_width(), params.effective_height(),
                               params.effective_depth(), params.format(), params.channel_count(), data, linesize);
   } else {
+    v = TakeTextureFromPool(params);
+
+    if (!v.isNull()) {
+      // Recycled texture, its previous contents are still there so replace them if we have data
+      TexturePtr recycled = std::make_shared<Texture>(this, v, params, type);
+
+      if (data) {
+        UploadToTexture(recycled.get(), data, linesize);
+      }
+
+      return recycled;
+    }
+
     v = CreateNativeTexture2D(params.effective_width(), params.effective_height(), params.format(),
                               params.channel_count(), data, linesize);
   }
@@ -68,169 +89,325 @@ void Renderer::BlitColorManaged(ColorProcessorPtr color_processor, TexturePtr so
 
 void Renderer::Destroy()
 {
-  color_cache_.clear();
+  {
+    QWriteLocker locker(&color_cache_lock_);
+    color_cache_.clear();
+  }
+
+  // Textures released after this point will be destroyed immediately
+  SetTexturePoolLimit(0);
 
   DestroyInternal();
 }
 
-bool Renderer::GetColorContext(ColorProcessorPtr color_processor, Renderer::ColorContext *ctx)
+void Renderer::SetTexturePoolLimit(qint64 bytes)
 {
-  QMutexLocker locker(&color_cache_mutex_);
+  texture_pool_mutex_.lock();
+  texture_pool_limit_ = bytes;
+  texture_pool_mutex_.unlock();
 
-  ColorContext& color_ctx = *ctx;
+  if (bytes == 0) {
+    ClearTexturePool();
+  }
+}
 
-  if (color_cache_.contains(color_processor->id())) {
-    color_ctx = color_cache_.value(color_processor->id());
-    return true;
-  } else {
-    // Create shader description
-    const char* ocio_func_name = "OCIODisplay";
-    auto shader_desc = OCIO::GpuShaderDesc::CreateShaderDesc();
-    shader_desc->setLanguage(OCIO::GPU_LANGUAGE_GLSL_1_3);
-    shader_desc->setFunctionName(ocio_func_name);
-    shader_desc->setResourcePrefix("ocio_");
-
-    // Generate shader
-    color_processor->GetProcessor()->getDefaultGPUProcessor()->extractGpuShaderInfo(shader_desc);
-
-    QString shader_frag;
-    shader_frag.append(QStringLiteral("// Main texture input\n"
-                                      "uniform sampler2D ove_maintex;\n"
-                                      "uniform int ove_maintex_alpha;\n"
-                                      "\n"
-                                      "// Macros defining `ove_maintex_alpha` state\n"
-                                      "// Matches `AlphaAssociated` C++ enum\n"
-                                      "#define ALPHA_NONE     0\n"
-                                      "#define ALPHA_UNASSOC  1\n"
-                                      "#define ALPHA_ASSOC    2\n"
-                                      "\n"
-                                      "// Macros so OCIO's shaders work on this GLSL version\n"
-                                      "#define texture2D texture\n"
-                                      "#define texture3D texture\n"
-                                      "\n"
-                                      "// Main texture coordinate\n"
-                                      "in vec2 ove_texcoord;\n"
-                                      "\n"
-                                      "// Texture output\n"
-                                      "out vec4 fragColor;\n"));
-    shader_frag.append(shader_desc->getShaderText());
-    shader_frag.append(QStringLiteral("\n"
-                                      "// Alpha association functions\n"
-                                      "vec4 assoc(vec4 c) {\n"
-                                      "  return vec4(c.rgb * c.a, c.a);\n"
-                                      "}\n"
-                                      "\n"
-                                      "vec4 reassoc(vec4 c) {\n"
-                                      "  return (c.a == 0.0) ? c : assoc(c);\n"
-                                      "}\n"
-                                      "\n"
-                                      "vec4 deassoc(vec4 c) {\n"
-                                      "  return (c.a == 0.0) ? c : vec4(c.rgb / c.a, c.a);\n"
-                                      "}\n"
-                                      "\n"
-                                      "void main() {\n"
-                                      "  vec4 col = texture(ove_maintex, ove_texcoord);\n"
-                                      "\n"
-                                      "  // If alpha is associated, de-associate now\n"
-                                      "  if (ove_maintex_alpha == ALPHA_ASSOC) {\n"
-                                      "    col = deassoc(col);\n"
-                                      "  }\n"
-                                      "\n"
-                                      "  // Perform color conversion\n"
-                                      "  col = %1(col);\n"
-                                      "\n"
-                                      "  // Associate or re-associate here\n"
-                                      "  if (ove_maintex_alpha == ALPHA_ASSOC) {\n"
-                                      "    col = reassoc(col);\n"
-                                      "  } else if (ove_maintex_alpha == ALPHA_UNASSOC) {\n"
-                                      "    col = assoc(col);\n"
-                                      "  }\n"
-                                      "\n"
-                                      "  fragColor = col;\n"
-                                      "}\n").arg(ocio_func_name));
-
-    // Try to compile shader
-    color_ctx.compiled_shader = CreateNativeShader(ShaderCode(shader_frag,
-                                                              FileFunctions::ReadFileAsString(QStringLiteral(":/shaders/default.vert"))));
-
-    if (color_ctx.compiled_shader.isNull()) {
-      return false;
+Renderer::TexturePoolStatistics Renderer::GetTexturePoolStatistics()
+{
+  QMutexLocker locker(&texture_pool_mutex_);
+
+  return texture_pool_stats_;
+}
+
+void Renderer::ClearTexturePool()
+{
+  QHash<TexturePoolKey, QVector<PooledTexture> > pool;
+
+  {
+    QMutexLocker locker(&texture_pool_mutex_);
+
+    pool.swap(texture_pool_);
+
+    texture_pool_stats_.idle_count = 0;
+    texture_pool_stats_.idle_bytes = 0;
+  }
+
+  // Destroy outside of the lock since this may wait on the render thread
+  for (auto it=pool.cbegin(); it!=pool.cend(); it++) {
+    foreach (const PooledTexture& t, it.value()) {
+      DestroyNativeTexture(t.native);
     }
+  }
+}
 
-    color_ctx.lut3d_textures.resize(shader_desc->getNum3DTextures());
-    for (unsigned int i=0; i<shader_desc->getNum3DTextures(); i++) {
-      const char* tex_name = nullptr;
-      const char* sampler_name = nullptr;
-      unsigned int edge_len = 0;
-      OCIO::Interpolation interpolation = OCIO::INTERP_LINEAR;
+void Renderer::ReleaseTexture(const QVariant &native, const VideoParams &params, Texture::Type type)
+{
+  QVector<QVariant> destroy;
 
-      shader_desc->get3DTexture(i, tex_name, sampler_name, edge_len, interpolation);
+  if (type == Texture::k2D) {
+    QMutexLocker locker(&texture_pool_mutex_);
 
-      if (!tex_name || !*tex_name
-          || !sampler_name || !*sampler_name
-          || !edge_len) {
-        qCritical() << "3D LUT texture data is corrupted";
-        return false;
-      }
+    qint64 sz = VideoParams::GetBufferSize(params.effective_width(), params.effective_height(),
+                                           params.format(), params.channel_count());
+
+    if (sz <= texture_pool_limit_) {
+      // Make room by evicting whichever textures have been idle longest. Each key's textures are in
+      // release order, so the oldest is at the front of one of them.
+      while (texture_pool_stats_.idle_bytes + sz > texture_pool_limit_) {
+        auto oldest = texture_pool_.end();
+
+        for (auto it=texture_pool_.begin(); it!=texture_pool_.end(); it++) {
+          if (oldest == texture_pool_.end()
+              || it->first().release_index < oldest->first().release_index) {
+            oldest = it;
+          }
+        }
+
+        const TexturePoolKey& key = oldest.key();
 
-      const float* values = nullptr;
-      shader_desc->get3DTextureValues(i, values);
-      if (!values) {
-        qCritical() << "3D LUT texture values are missing";
-        return false;
+        destroy.append(oldest->takeFirst().native);
+
+        texture_pool_stats_.idle_count--;
+        texture_pool_stats_.idle_bytes -= VideoParams::GetBufferSize(key.width, key.height,
+                                                                      key.format, key.channel_count);
+        texture_pool_stats_.evictions++;
+
+        if (oldest->isEmpty()) {
+          texture_pool_.erase(oldest);
+        }
       }
 
-      // Allocate 3D LUT
-      color_ctx.lut3d_textures[i].texture = CreateTexture(VideoParams(edge_len, edge_len, edge_len, VideoParams::kFormatFloat32, VideoParams::kRGBChannelCount),
-                                                          Texture::k3D, values);
-      color_ctx.lut3d_textures[i].name = sampler_name;
-      color_ctx.lut3d_textures[i].interpolation = (interpolation == OCIO::INTERP_NEAREST) ? Texture::kNearest : Texture::kLinear;
+      texture_pool_[GetTexturePoolKey(params)].append({native, texture_pool_release_count_});
+      texture_pool_release_count_++;
+
+      texture_pool_stats_.idle_count++;
+      texture_pool_stats_.idle_bytes += sz;
+      texture_pool_stats_.peak_idle_bytes = qMax(texture_pool_stats_.peak_idle_bytes,
+                                                 texture_pool_stats_.idle_bytes);
+    } else {
+      destroy.append(native);
     }
+  } else {
+    destroy.append(native);
+  }
 
-    color_ctx.lut1d_textures.resize(shader_desc->getNumTextures());
-    for (unsigned int i=0; i<shader_desc->getNumTextures(); i++) {
-      const char* tex_name = nullptr;
-      const char* sampler_name = nullptr;
-      unsigned int width = 0, height = 0;
-      OCIO::GpuShaderDesc::TextureType channel = OCIO::GpuShaderDesc::TEXTURE_RGB_CHANNEL;
-      OCIO::Interpolation interpolation = OCIO::INTERP_LINEAR;
-
-      shader_desc->getTexture(i, tex_name, sampler_name, width, height, channel, interpolation);
-
-      if (!tex_name || !*tex_name
-          || !sampler_name || !*sampler_name
-          || !width) {
-        qCritical() << "1D LUT texture data is corrupted";
-        return false;
-      }
+  // Destroy outside of the lock since this may wait on the render thread
+  foreach (const QVariant& t, destroy) {
+    DestroyNativeTexture(t);
+  }
+}
 
-      const float* values = nullptr;
-      shader_desc->getTextureValues(i, values);
-      if (!values) {
-        qCritical() << "1D LUT texture values are missing";
-        return false;
-      }
+Renderer::TexturePoolKey Renderer::GetTexturePoolKey(const VideoParams &params)
+{
+  return {params.effective_width(), params.effective_height(), params.format(), params.channel_count()};
+}
+
+QVariant Renderer::TakeTextureFromPool(const VideoParams &params)
+{
+  QMutexLocker locker(&texture_pool_mutex_);
+
+  if (texture_pool_limit_ == 0) {
+    return QVariant();
+  }
+
+  auto it = texture_pool_.find(GetTexturePoolKey(params));
+
+  if (it == texture_pool_.end()) {
+    texture_pool_stats_.misses++;
+    return QVariant();
+  }
+
+  // Take the most recently released, the oldest are the first to be evicted
+  QVariant native = it->takeLast().native;
+
+  if (it->isEmpty()) {
+    texture_pool_.erase(it);
+  }
+
+  texture_pool_stats_.hits++;
+  texture_pool_stats_.idle_count--;
+  texture_pool_stats_.idle_bytes -= VideoParams::GetBufferSize(params.effective_width(), params.effective_height(),
+                                                                params.format(), params.channel_count());
+
+  return native;
+}
+
+Renderer::ColorContextPtr Renderer::GetColorContext(ColorProcessorPtr color_processor)
+{
+  {
+    // Fast path, most processors will have been seen already so we only need a read lock
+    QReadLocker locker(&color_cache_lock_);
+
+    ColorContextPtr existing = color_cache_.value(color_processor->cache_id());
+    if (existing) {
+      return existing;
+    }
+  }
+
+  QWriteLocker locker(&color_cache_lock_);
 
-      // Allocate 1D LUT
-      color_ctx.lut1d_textures[i].texture = CreateTexture(VideoParams(width, height, VideoParams::kFormatFloat32, (channel == OCIO::GpuShaderDesc::TEXTURE_RED_CHANNEL) ? 1 : VideoParams::kRGBChannelCount),
-                                                          Texture::k2D,
-                                                          values);
-      color_ctx.lut1d_textures[i].name = sampler_name;
-      color_ctx.lut1d_textures[i].interpolation = (interpolation == OCIO::INTERP_NEAREST) ? Texture::kNearest : Texture::kLinear;
+  // Check again in case another thread created this context while we were waiting for the lock
+  ColorContextPtr color_ctx = color_cache_.value(color_processor->cache_id());
+
+  if (!color_ctx) {
+    color_ctx = CreateColorContext(color_processor);
+
+    if (color_ctx) {
+      color_cache_.insert(color_processor->cache_id(), color_ctx);
     }
+  }
 
-    color_cache_.insert(color_processor->id(), color_ctx);
+  return color_ctx;
+}
 
-    return true;
+Renderer::ColorContextPtr Renderer::CreateColorContext(ColorProcessorPtr color_processor)
+{
+  ColorContextPtr color_ctx = std::make_shared<ColorContext>();
+
+  // Create shader description
+  const char* ocio_func_name = "OCIODisplay";
+  auto shader_desc = OCIO::GpuShaderDesc::CreateShaderDesc();
+  shader_desc->setLanguage(OCIO::GPU_LANGUAGE_GLSL_1_3);
+  shader_desc->setFunctionName(ocio_func_name);
+  shader_desc->setResourcePrefix("ocio_");
+
+  // Generate shader
+  color_processor->GetProcessor()->getDefaultGPUProcessor()->extractGpuShaderInfo(shader_desc);
+
+  QString shader_frag;
+  shader_frag.append(QStringLiteral("// Main texture input\n"
+                                    "uniform sampler2D ove_maintex;\n"
+                                    "uniform int ove_maintex_alpha;\n"
+                                    "\n"
+                                    "// Macros defining `ove_maintex_alpha` state\n"
+                                    "// Matches `AlphaAssociated` C++ enum\n"
+                                    "#define ALPHA_NONE     0\n"
+                                    "#define ALPHA_UNASSOC  1\n"
+                                    "#define ALPHA_ASSOC    2\n"
+                                    "\n"
+                                    "// Macros so OCIO's shaders work on this GLSL version\n"
+                                    "#define texture2D texture\n"
+                                    "#define texture3D texture\n"
+                                    "\n"
+                                    "// Main texture coordinate\n"
+                                    "in vec2 ove_texcoord;\n"
+                                    "\n"
+                                    "// Texture output\n"
+                                    "out vec4 fragColor;\n"));
+  shader_frag.append(shader_desc->getShaderText());
+  shader_frag.append(QStringLiteral("\n"
+                                    "// Alpha association functions\n"
+                                    "vec4 assoc(vec4 c) {\n"
+                                    "  return vec4(c.rgb * c.a, c.a);\n"
+                                    "}\n"
+                                    "\n"
+                                    "vec4 reassoc(vec4 c) {\n"
+                                    "  return (c.a == 0.0) ? c : assoc(c);\n"
+                                    "}\n"
+                                    "\n"
+                                    "vec4 deassoc(vec4 c) {\n"
+                                    "  return (c.a == 0.0) ? c : vec4(c.rgb / c.a, c.a);\n"
+                                    "}\n"
+                                    "\n"
+                                    "void main() {\n"
+                                    "  vec4 col = texture(ove_maintex, ove_texcoord);\n"
+                                    "\n"
+                                    "  // If alpha is associated, de-associate now\n"
+                                    "  if (ove_maintex_alpha == ALPHA_ASSOC) {\n"
+                                    "    col = deassoc(col);\n"
+                                    "  }\n"
+                                    "\n"
+                                    "  // Perform color conversion\n"
+                                    "  col = %1(col);\n"
+                                    "\n"
+                                    "  // Associate or re-associate here\n"
+                                    "  if (ove_maintex_alpha == ALPHA_ASSOC) {\n"
+                                    "    col = reassoc(col);\n"
+                                    "  } else if (ove_maintex_alpha == ALPHA_UNASSOC) {\n"
+                                    "    col = assoc(col);\n"
+                                    "  }\n"
+                                    "\n"
+                                    "  fragColor = col;\n"
+                                    "}\n").arg(ocio_func_name));
+
+  // Try to compile shader
+  color_ctx->compiled_shader = CreateNativeShader(ShaderCode(shader_frag,
+                                                             FileFunctions::ReadFileAsString(QStringLiteral(":/shaders/default.vert"))));
+
+  if (color_ctx->compiled_shader.isNull()) {
+    return nullptr;
   }
+
+  color_ctx->lut3d_textures.resize(shader_desc->getNum3DTextures());
+  for (unsigned int i=0; i<shader_desc->getNum3DTextures(); i++) {
+    const char* tex_name = nullptr;
+    const char* sampler_name = nullptr;
+    unsigned int edge_len = 0;
+    OCIO::Interpolation interpolation = OCIO::INTERP_LINEAR;
+
+    shader_desc->get3DTexture(i, tex_name, sampler_name, edge_len, interpolation);
+
+    if (!tex_name || !*tex_name
+        || !sampler_name || !*sampler_name
+        || !edge_len) {
+      qCritical() << "3D LUT texture data is corrupted";
+      return nullptr;
+    }
+
+    const float* values = nullptr;
+    shader_desc->get3DTextureValues(i, values);
+    if (!values) {
+      qCritical() << "3D LUT texture values are missing";
+      return nullptr;
+    }
+
+    // Allocate 3D LUT
+    color_ctx->lut3d_textures[i].texture = CreateTexture(VideoParams(edge_len, edge_len, edge_len, VideoParams::kFormatFloat32, VideoParams::kRGBChannelCount),
+                                                         Texture::k3D, values);
+    color_ctx->lut3d_textures[i].name = sampler_name;
+    color_ctx->lut3d_textures[i].interpolation = (interpolation == OCIO::INTERP_NEAREST) ? Texture::kNearest : Texture::kLinear;
+  }
+
+  color_ctx->lut1d_textures.resize(shader_desc->getNumTextures());
+  for (unsigned int i=0; i<shader_desc->getNumTextures(); i++) {
+    const char* tex_name = nullptr;
+    const char* sampler_name = nullptr;
+    unsigned int width = 0, height = 0;
+    OCIO::GpuShaderDesc::TextureType channel = OCIO::GpuShaderDesc::TEXTURE_RGB_CHANNEL;
+    OCIO::Interpolation interpolation = OCIO::INTERP_LINEAR;
+
+    shader_desc->getTexture(i, tex_name, sampler_name, width, height, channel, interpolation);
+
+    if (!tex_name || !*tex_name
+        || !sampler_name || !*sampler_name
+        || !width) {
+      qCritical() << "1D LUT texture data is corrupted";
+      return nullptr;
+    }
+
+    const float* values = nullptr;
+    shader_desc->getTextureValues(i, values);
+    if (!values) {
+      qCritical() << "1D LUT texture values are missing";
+      return nullptr;
+    }
+
+    // Allocate 1D LUT
+    color_ctx->lut1d_textures[i].texture = CreateTexture(VideoParams(width, height, VideoParams::kFormatFloat32, (channel == OCIO::GpuShaderDesc::TEXTURE_RED_CHANNEL) ? 1 : VideoParams::kRGBChannelCount),
+                                                         Texture::k2D,
+                                                         values);
+    color_ctx->lut1d_textures[i].name = sampler_name;
+    color_ctx->lut1d_textures[i].interpolation = (interpolation == OCIO::INTERP_NEAREST) ? Texture::kNearest : Texture::kLinear;
+  }
+
+  return color_ctx;
 }
 
 void Renderer::BlitColorManagedInternal(ColorProcessorPtr color_processor, TexturePtr source,
                                         bool source_is_premultiplied, Texture *destination,
                                         VideoParams params, bool clear_destination, const QMatrix4x4& matrix)
 {
-  ColorContext color_ctx;
-  if (!GetColorContext(color_processor, &color_ctx)) {
+  ColorContextPtr color_ctx = GetColorContext(color_processor);
+  if (!color_ctx) {
     return;
   }
 
@@ -254,19 +431,19 @@ void Renderer::BlitColorManagedInternal(ColorProcessorPtr color_processor, Textu
   }
   job.InsertValue(QStringLiteral("ove_maintex_alpha"), ShaderValue(associated, NodeParam::kInt));
 
-  foreach (const ColorContext::LUT& l, color_ctx.lut3d_textures) {
+  foreach (const ColorContext::LUT& l, color_ctx->lut3d_textures) {
     job.InsertValue(l.name, ShaderValue(QVariant::fromValue(l.texture), NodeParam::kTexture));
     job.SetInterpolation(l.name, l.interpolation);
   }
-  foreach (const ColorContext::LUT& l, color_ctx.lut1d_textures) {
+  foreach (const ColorContext::LUT& l, color_ctx->lut1d_textures) {
     job.InsertValue(l.name, ShaderValue(QVariant::fromValue(l.texture), NodeParam::kTexture));
     job.SetInterpolation(l.name, l.interpolation);
   }
 
   if (destination) {
-    BlitToTexture(color_ctx.compiled_shader, job, destination, clear_destination);
+    BlitToTexture(color_ctx->compiled_shader, job, destination, clear_destination);
   } else {
-    Blit(color_ctx.compiled_shader, job, params, clear_destination);
+    Blit(color_ctx->compiled_shader, job, params, clear_destination);
   }
 }
 
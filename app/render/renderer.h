@@ -22,6 +22,7 @@
 #define RENDERCONTEXT_H
 
 #include <QObject>
+#include <QReadWriteLock>
 #include <QVariant>
 
 #include "common/define.h"
@@ -43,6 +44,13 @@ public:
 
   virtual bool Init() = 0;
 
+  /**
+   * @brief Create a texture, reusing an idle one from the pool if possible (2D only)
+   *
+   * A recycled texture still holds whatever was last drawn to it. If `data` isn't provided, the
+   * contents are undefined and callers must overwrite every pixel before sampling it, e.g. by
+   * blitting to it with `clear_destination` left TRUE.
+   */
   TexturePtr CreateTexture(const VideoParams& params, Texture::Type type, const void* data = nullptr, int linesize = 0);
   TexturePtr CreateTexture(const VideoParams& params, const void *data = nullptr, int linesize = 0);
 
@@ -69,6 +77,46 @@ public:
 
   virtual void PostDestroy() = 0;
 
+  struct TexturePoolStatistics {
+    /// Textures currently idle in the pool
+    int idle_count;
+
+    /// Memory used by idle textures
+    qint64 idle_bytes;
+
+    /// Largest amount of memory the idle textures have used at once
+    qint64 peak_idle_bytes;
+
+    /// Amount of requests served from the pool
+    qint64 hits;
+
+    /// Amount of requests that had to allocate a new texture
+    qint64 misses;
+
+    /// Amount of idle textures destroyed to make room for more recently released ones
+    qint64 evictions;
+  };
+
+  /**
+   * @brief Set the maximum amount of memory idle 2D textures can use before being destroyed
+   *
+   * When a 2D texture is no longer referenced, it's kept so that the next request for a texture
+   * of the same width, height, format, and channel count can reuse it rather than allocating a
+   * new one. When the limit is reached, the textures that have been idle longest are destroyed to
+   * make room, so sizes that are no longer requested don't hold onto memory. Setting this to 0 (the
+   * default) disables pooling and destroys the pool's contents.
+   *
+   * This function is thread-safe.
+   */
+  void SetTexturePoolLimit(qint64 bytes);
+
+  TexturePoolStatistics GetTexturePoolStatistics();
+
+  /**
+   * @brief Destroy all idle textures in the pool
+   */
+  void ClearTexturePool();
+
 public slots:
   virtual void PostInit() = 0;
 
@@ -97,6 +145,39 @@ protected slots:
                     bool clear_destination) = 0;
 
 private:
+  friend class Texture;
+
+  /**
+   * @brief Called by Texture when it's destroyed, either pools or destroys its native texture
+   */
+  void ReleaseTexture(const QVariant& native, const VideoParams& params, Texture::Type type);
+
+  struct TexturePoolKey {
+    int width;
+    int height;
+    VideoParams::Format format;
+    int channel_count;
+
+    bool operator==(const TexturePoolKey& rhs) const
+    {
+      return width == rhs.width && height == rhs.height
+          && format == rhs.format && channel_count == rhs.channel_count;
+    }
+  };
+
+  friend uint qHash(const TexturePoolKey& key, uint seed);
+
+  struct PooledTexture {
+    QVariant native;
+
+    /// Order this texture was released in, used to evict the oldest first
+    quint64 release_index;
+  };
+
+  static TexturePoolKey GetTexturePoolKey(const VideoParams& params);
+
+  QVariant TakeTextureFromPool(const VideoParams& params);
+
   struct ColorContext {
     struct LUT {
       TexturePtr texture;
@@ -110,22 +191,36 @@ private:
 
   };
 
+  using ColorContextPtr = std::shared_ptr<ColorContext>;
+
   enum AlphaAssociated {
     kAlphaNone,
     kAlphaUnassociated,
     kAlphaAssociated
   };
 
-  bool GetColorContext(ColorProcessorPtr color_processor, ColorContext* ctx);
+  ColorContextPtr GetColorContext(ColorProcessorPtr color_processor);
+
+  ColorContextPtr CreateColorContext(ColorProcessorPtr color_processor);
 
   void BlitColorManagedInternal(ColorProcessorPtr color_processor, TexturePtr source,
                                 bool source_is_premultiplied,
                                 Texture* destination, VideoParams params, bool clear_destination,
                                 const QMatrix4x4 &matrix);
 
-  QHash<QString, ColorContext> color_cache_;
+  QHash<QByteArray, ColorContextPtr> color_cache_;
+
+  QReadWriteLock color_cache_lock_;
+
+  QHash<TexturePoolKey, QVector<PooledTexture> > texture_pool_;
+
+  qint64 texture_pool_limit_;
+
+  quint64 texture_pool_release_count_;
+
+  TexturePoolStatistics texture_pool_stats_;
 
-  QMutex color_cache_mutex_;
+  QMutex texture_pool_mutex_;
 
 };
 
@@ -38,6 +38,9 @@ namespace olive {
 
 RenderManager* RenderManager::instance_ = nullptr;
 
+// Enough for a handful of 4K float intermediates, or many more at lower resolutions/bit depths
+const qint64 RenderManager::kTexturePoolLimit = 512 * 1024 * 1024;
+
 RenderManager::RenderManager(QObject *parent) :
   ThreadPool(QThread::IdlePriority, 0, parent),
   backend_(kOpenGL)
@@ -53,6 +56,10 @@ RenderManager::RenderManager(QObject *parent) :
     context_->Init();
     context_->PostInit();
 
+    // Intermediate textures are requested in the same few sizes for every frame, so recycle them
+    // rather than allocating new ones every time
+    context_->SetTexturePoolLimit(kTexturePoolLimit);
+
     still_cache_ = new StillImageCache();
     decoder_cache_ = new DecoderCache();
     shader_cache_ = new ShaderCache();
@@ -102,7 +109,8 @@ QByteArray RenderManager::Hash(const Node *n, const VideoParams &params, const r
 
 RenderTicketPtr RenderManager::RenderFrame(ViewerOutput* viewer, ColorManager* color_manager,
                                            const rational& time, RenderMode::Mode mode,
-                                           FrameHashCache* cache, bool prioritize)
+                                           FrameHashCache* cache, RenderTicket::Priority priority,
+                                           qint64 deadline)
 {
   return RenderFrame(viewer,
                      color_manager,
@@ -115,7 +123,8 @@ RenderTicketPtr RenderManager::RenderFrame(ViewerOutput* viewer, ColorManager* c
                      VideoParams::kFormatInvalid,
                      nullptr,
                      cache,
-                     prioritize);
+                     priority,
+                     deadline);
 }
 
 RenderTicketPtr RenderManager::RenderFrame(ViewerOutput* viewer, ColorManager* color_manager,
@@ -124,7 +133,8 @@ RenderTicketPtr RenderManager::RenderFrame(ViewerOutput* viewer, ColorManager* c
                                            const QSize& force_size,
                                            const QMatrix4x4& force_matrix, VideoParams::Format force_format,
                                            ColorProcessorPtr force_color_output,
-                                           FrameHashCache* cache, bool prioritize)
+                                           FrameHashCache* cache, RenderTicket::Priority priority,
+                                           qint64 deadline)
 {
   // Create ticket
   RenderTicketPtr ticket = std::make_shared<RenderTicket>();
@@ -145,24 +155,19 @@ RenderTicketPtr RenderManager::RenderFrame(ViewerOutput* viewer, ColorManager* c
     ticket->setProperty("cache", cache->GetCacheDirectory());
   }
 
-  if (ticket->thread() != this->thread()) {
-    ticket->moveToThread(this->thread());
-  }
+  ticket->SetPriority(priority, deadline);
 
-  // Queue appending the ticket and running the next job on our thread to make this function thread-safe
-  QMetaObject::invokeMethod(this, "AddTicket", Qt::AutoConnection,
-                            OLIVE_NS_ARG(RenderTicketPtr, ticket),
-                            Q_ARG(bool, prioritize));
+  AddTicket(ticket);
 
   return ticket;
 }
 
-RenderTicketPtr RenderManager::RenderAudio(ViewerOutput* viewer, const TimeRange& r, bool generate_waveforms, bool prioritize)
+RenderTicketPtr RenderManager::RenderAudio(ViewerOutput* viewer, const TimeRange& r, bool generate_waveforms, RenderTicket::Priority priority)
 {
-  return RenderAudio(viewer, r, viewer->audio_params(), generate_waveforms, prioritize);
+  return RenderAudio(viewer, r, viewer->audio_params(), generate_waveforms, priority);
 }
 
-RenderTicketPtr RenderManager::RenderAudio(ViewerOutput* viewer, const TimeRange &r, const AudioParams &params, bool generate_waveforms, bool prioritize)
+RenderTicketPtr RenderManager::RenderAudio(ViewerOutput* viewer, const TimeRange &r, const AudioParams &params, bool generate_waveforms, RenderTicket::Priority priority)
 {
   // Create ticket
   RenderTicketPtr ticket = std::make_shared<RenderTicket>();
@@ -173,19 +178,21 @@ RenderTicketPtr RenderManager::RenderAudio(ViewerOutput* viewer, const TimeRange
   ticket->setProperty("enablewaveforms", generate_waveforms);
   ticket->setProperty("aparam", QVariant::fromValue(params));
 
-  if (ticket->thread() != this->thread()) {
-    ticket->moveToThread(this->thread());
-  }
+  ticket->SetPriority(priority);
 
-  // Queue appending the ticket and running the next job on our thread to make this function thread-safe
-  QMetaObject::invokeMethod(this, "AddTicket", Qt::AutoConnection,
-                            OLIVE_NS_ARG(RenderTicketPtr, ticket),
-                            Q_ARG(bool, prioritize));
+  AddTicket(ticket);
 
   return ticket;
 }
 
-RenderTicketPtr RenderManager::SaveFrameToCache(FrameHashCache *cache, FramePtr frame, const QByteArray &hash, bool prioritize)
+void RenderManager::ClearTexturePool()
+{
+  if (context_) {
+    context_->ClearTexturePool();
+  }
+}
+
+RenderTicketPtr RenderManager::SaveFrameToCache(FrameHashCache *cache, FramePtr frame, const QByteArray &hash, RenderTicket::Priority priority)
 {
   // Create ticket
   RenderTicketPtr ticket = std::make_shared<RenderTicket>();
@@ -195,14 +202,9 @@ RenderTicketPtr RenderManager::SaveFrameToCache(FrameHashCache *cache, FramePtr
   ticket->setProperty("hash", hash);
   ticket->setProperty("type", kTypeVideoDownload);
 
-  if (ticket->thread() != this->thread()) {
-    ticket->moveToThread(this->thread());
-  }
+  ticket->SetPriority(priority);
 
-  // Queue appending the ticket and running the next job on our thread to make this function thread-safe
-  QMetaObject::invokeMethod(this, "AddTicket", Qt::AutoConnection,
-                            OLIVE_NS_ARG(RenderTicketPtr, ticket),
-                            Q_ARG(bool, prioritize));
+  AddTicket(ticket);
 
   return ticket;
 }
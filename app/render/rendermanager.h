@@ -75,36 +75,48 @@ public:
    * The ticket from this function will return a FramePtr - the rendered frame in reference color
    * space.
    *
-   * Setting `prioritize` to TRUE puts this ticket at the top of the queue. Leaving it as FALSE
-   * appends it to the bottom.
+   * `priority` determines which class of work this ticket competes in for render threads (see
+   * ThreadPool). Like a RenderTicket created directly, it defaults to the cache class.
+   * `deadline` orders playback tickets and is ignored by the other classes.
    *
    * This function is thread-safe.
    */
   RenderTicketPtr RenderFrame(ViewerOutput* viewer, ColorManager* color_manager,
                               const rational& time, RenderMode::Mode mode,
-                              FrameHashCache* cache = nullptr, bool prioritize = false);
+                              FrameHashCache* cache = nullptr,
+                              RenderTicket::Priority priority = RenderTicket::kPriorityCache,
+                              qint64 deadline = 0);
   RenderTicketPtr RenderFrame(ViewerOutput* viewer, ColorManager* color_manager,
                               const rational& time, RenderMode::Mode mode,
                               const VideoParams& video_params, const AudioParams& audio_params,
                               const QSize& force_size,
                               const QMatrix4x4& force_matrix, VideoParams::Format force_format,
                               ColorProcessorPtr force_color_output,
-                              FrameHashCache* cache = nullptr, bool prioritize = false);
+                              FrameHashCache* cache = nullptr,
+                              RenderTicket::Priority priority = RenderTicket::kPriorityCache,
+                              qint64 deadline = 0);
 
   /**
    * @brief Asynchronously generate a chunk of audio
    *
    * The ticket from this function will return a SampleBufferPtr - the rendered audio.
    *
-   * Setting `prioritize` to TRUE puts this ticket at the top of the queue. Leaving it as FALSE
-   * appends it to the bottom.
+   * `priority` determines which class of work this ticket competes in for render threads (see
+   * ThreadPool).
    *
    * This function is thread-safe.
    */
-  RenderTicketPtr RenderAudio(ViewerOutput* viewer, const TimeRange& r, const AudioParams& params, bool generate_waveforms, bool prioritize = false);
-  RenderTicketPtr RenderAudio(ViewerOutput* viewer, const TimeRange& r, bool generate_waveforms, bool prioritize = false);
+  RenderTicketPtr RenderAudio(ViewerOutput* viewer, const TimeRange& r, const AudioParams& params, bool generate_waveforms, RenderTicket::Priority priority = RenderTicket::kPriorityCache);
+  RenderTicketPtr RenderAudio(ViewerOutput* viewer, const TimeRange& r, bool generate_waveforms, RenderTicket::Priority priority = RenderTicket::kPriorityCache);
 
-  RenderTicketPtr SaveFrameToCache(FrameHashCache* cache, FramePtr frame, const QByteArray& hash, bool prioritize = false);
+  RenderTicketPtr SaveFrameToCache(FrameHashCache* cache, FramePtr frame, const QByteArray& hash, RenderTicket::Priority priority = RenderTicket::kPriorityCache);
+
+  /**
+   * @brief Destroy idle intermediate textures, e.g. when they won't be requested at their size again
+   *
+   * This function is thread-safe.
+   */
+  void ClearTexturePool();
 
   virtual void RunTicket(RenderTicketPtr ticket) const override;
 
@@ -128,6 +140,11 @@ private:
 
   static RenderManager* instance_;
 
+  /**
+   * @brief Memory idle intermediate textures may use between frames (see Renderer::SetTexturePoolLimit)
+   */
+  static const qint64 kTexturePoolLimit;
+
   Renderer* context_;
 
   Backend backend_;
@@ -21,22 +21,34 @@
 #include "renderprocessor.h"
 
 #include <QOpenGLContext>
+#include <QtMath>
 #include <QVector2D>
 #include <QVector3D>
 #include <QVector4D>
 
+#include "audio/tempoprocessor.h"
+#include "colorprocessorcache.h"
+#include "common/tick.h"
+#include "node/block/clip/clip.h"
 #include "project/project.h"
 #include "rendermanager.h"
+#include "threading/workstealingexecutor.h"
 
 namespace olive {
 
+// Audio on either side of a chunk given to speed changes, so the filters are already settled at
+// the chunk's edges rather than starting and ending cold
+const rational kSpeedChangeMargin(1, 10);
+
 RenderProcessor::RenderProcessor(RenderTicketPtr ticket, Renderer *render_ctx, StillImageCache* still_image_cache, DecoderCache* decoder_cache, ShaderCache *shader_cache, QVariant default_shader) :
   ticket_(ticket),
   render_ctx_(render_ctx),
   still_image_cache_(still_image_cache),
   decoder_cache_(decoder_cache),
   shader_cache_(shader_cache),
-  default_shader_(default_shader)
+  default_shader_(default_shader),
+  pending_lock_(QMutex::Recursive),
+  parallel_(false)
 {
 }
 
@@ -57,11 +69,17 @@ void RenderProcessor::Run()
     ViewerOutput* viewer = Node::ValueToPtr<ViewerOutput>(ticket_->property("viewer"));
     const VideoParams& video_params = ticket_->property("vparam").value<VideoParams>();
     rational time = ticket_->property("time").value<rational>();
+    TimeRange range(time, time + video_params.time_base());
+
+    // Renderer calls are queued onto the context's own thread, so branches (e.g. separate tracks)
+    // can decode, generate and upload alongside each other
+    parallel_ = WorkStealingExecutor::instance()
+        && (ticket_->GetPriority() == RenderTicket::kPriorityInteractive
+            || ticket_->GetPriority() == RenderTicket::kPriorityPlayback);
 
-    NodeValueTable table = ProcessInput(viewer->texture_input(),
-                                        TimeRange(time, time + video_params.time_base()));
+    NodeValueTable table = ProcessInput(viewer->texture_input(), range);
 
-    TexturePtr texture = table.Get(NodeParam::kTexture).value<TexturePtr>();
+    TexturePtr texture = ResolveTexture(table.Get(NodeParam::kTexture).value<TexturePtr>());
 
     // Set up output frame parameters
     VideoParams frame_params = ticket_->property("vparam").value<VideoParams>();
@@ -180,12 +198,105 @@ DecoderPtr RenderProcessor::ResolveDecoderFromInput(Stream *stream)
   return decoder;
 }
 
+StillImageCache::EntryPtr RenderProcessor::CreateStillImageEntry(VideoStream *video_stream, const rational &input_time)
+{
+  const VideoParams& video_params = ticket_->property("vparam").value<VideoParams>();
+
+  ColorManager* color_manager = Node::ValueToPtr<ColorManager>(ticket_->property("colormanager"));
+
+  // See if we can make this divider larger (i.e. if the fooage is smaller)
+  int footage_divider = video_params.divider();
+  while (footage_divider > 1
+         && VideoParams::GetScaledDimension(video_stream->width(), footage_divider-1) < video_params.effective_width()
+         && VideoParams::GetScaledDimension(video_stream->height(), footage_divider-1) < video_params.effective_height()) {
+    footage_divider--;
+  }
+
+  return std::make_shared<StillImageCache::Entry>(
+        nullptr,
+        video_stream,
+        ColorProcessor::GenerateID(color_manager, video_stream->colorspace(), color_manager->GetReferenceColorSpace()),
+        video_stream->premultiplied_alpha(),
+        footage_divider,
+        (video_stream->video_type() == VideoStream::kVideoTypeStill) ? 0 : input_time,
+        true);
+}
+
+VideoParams RenderProcessor::GetGeneratedFrameParams(const GenerateJob &job) const
+{
+  VideoParams frame_params = ticket_->property("vparam").value<VideoParams>();
+
+  if (!job.GetCoverageShaderID().isEmpty()) {
+    frame_params.set_format(VideoParams::kFormatUnsigned8);
+    frame_params.set_channel_count(1);
+  } else if (job.GetAlphaChannelRequired()) {
+    frame_params.set_channel_count(VideoParams::kRGBAChannelCount);
+  } else {
+    frame_params.set_channel_count(VideoParams::kRGBChannelCount);
+  }
+
+  return frame_params;
+}
+
 void RenderProcessor::Process(RenderTicketPtr ticket, Renderer *render_ctx, StillImageCache *still_image_cache, DecoderCache *decoder_cache, ShaderCache *shader_cache, QVariant default_shader)
 {
   RenderProcessor p(ticket, render_ctx, still_image_cache, decoder_cache, shader_cache, default_shader);
   p.Run();
 }
 
+TexturePtr RenderProcessor::ResolveTexture(TexturePtr texture)
+{
+  if (!texture) {
+    return texture;
+  }
+
+  QMutexLocker pending_locker(&pending_lock_);
+
+  auto it = pending_textures_.find(texture.get());
+
+  if (it == pending_textures_.end()) {
+    // Not a placeholder, nothing to do
+    return texture;
+  }
+
+  PendingTexturePtr pending = it->lock();
+
+  if (!pending) {
+    // A placeholder that's since been freed, this is a new texture at the same address
+    pending_textures_.erase(it);
+    return texture;
+  }
+
+  if (!pending->texture) {
+    const ShaderChain& chain = pending->chain;
+
+    QVariant shader;
+
+    {
+      // Chains with the same layout share a shader
+      QMutexLocker locker(shader_cache_->mutex());
+
+      shader = shader_cache_->value(chain.GenerateShaderID());
+
+      if (shader.isNull()) {
+        shader = render_ctx_->CreateNativeShader(chain.GenerateShaderCode());
+
+        if (shader.isNull()) {
+          return nullptr;
+        }
+
+        shader_cache_->insert(chain.GenerateShaderID(), shader);
+      }
+    }
+
+    pending->texture = render_ctx_->CreateTexture(texture->params());
+
+    render_ctx_->BlitToTexture(shader, chain.GenerateJob(), pending->texture.get());
+  }
+
+  return pending->texture;
+}
+
 NodeValueTable RenderProcessor::GenerateBlockTable(const TrackOutput *track, const TimeRange &range)
 {
   if (track->track_type() == Timeline::kTrackTypeAudio) {
@@ -209,8 +320,22 @@ NodeValueTable RenderProcessor::GenerateBlockTable(const TrackOutput *track, con
       int destination_offset = audio_params.time_to_samples(range_for_block.in() - range.in());
       int max_dest_sz = audio_params.time_to_samples(range_for_block.length());
 
+      // Audio is rendered in chunks that don't know about each other, so when the speed is
+      // changed, process some of the clip's audio around this chunk too and only keep the middle
+      bool speed_changed = !b->speed_input()->is_connected()
+          && (b->speed_input()->is_keyframing()
+              || !qFuzzyCompare(b->speed_input()->get_standard_value().toDouble(), 1.0));
+
+      TimeRange process_range = range_for_block;
+      if (speed_changed) {
+        process_range = TimeRange(qMax(b->in(), range_for_block.in() - kSpeedChangeMargin),
+                                  qMin(b->out(), range_for_block.out() + kSpeedChangeMargin));
+      }
+
+      int process_offset = audio_params.time_to_samples(range_for_block.in() - process_range.in());
+
       // Destination buffer
-      NodeValueTable table = GenerateTable(b, range_for_block);
+      NodeValueTable table = GenerateTable(b, process_range);
       SampleBufferPtr samples_from_this_block = table.Take(NodeParam::kSamples).value<SampleBufferPtr>();
 
       if (!samples_from_this_block) {
@@ -219,8 +344,12 @@ NodeValueTable RenderProcessor::GenerateBlockTable(const TrackOutput *track, con
       }
 
       // FIXME: Doesn't handle reversing
-      if (b->speed_input()->is_keyframing() || b->speed_input()->is_connected()) {
+      if (b->speed_input()->is_connected()) {
         // FIXME: We'll need to calculate the speed hoo boy
+      } else if (b->speed_input()->is_keyframing()) {
+        // Pitch can't be preserved along a speed curve, the tempo filter only takes one speed
+        ApplyVariableSpeed(b, process_range, samples_from_this_block,
+                           audio_params.time_to_samples(process_range.length()));
       } else {
         double speed_value = b->speed_input()->get_standard_value().toDouble();
 
@@ -228,15 +357,28 @@ NodeValueTable RenderProcessor::GenerateBlockTable(const TrackOutput *track, con
           // Just silence, don't think there's any other practical application of 0 speed audio
           samples_from_this_block->fill(0);
         } else if (!qFuzzyCompare(speed_value, 1.0)) {
-          // Multiply time
-          samples_from_this_block->speed(speed_value);
+          if (b->type() == Block::kClip && static_cast<ClipBlock*>(b)->preserve_pitch()) {
+            samples_from_this_block = ApplyTempo(samples_from_this_block, speed_value);
+          } else {
+            // Multiply time
+            samples_from_this_block->speed(speed_value);
+          }
         }
       }
 
-      int copy_length = qMin(max_dest_sz, samples_from_this_block->sample_count());
+      int copy_length = qMin(max_dest_sz, samples_from_this_block->sample_count() - process_offset);
 
-      // Copy samples into destination buffer
-      block_range_buffer->set(samples_from_this_block->const_data(), destination_offset, copy_length);
+      if (copy_length <= 0) {
+        continue;
+      }
+
+      // Copy samples into destination buffer, skipping the margin
+      QVector<const float*> copy_source(audio_params.channel_count());
+      for (int i=0;i<copy_source.size();i++) {
+        copy_source[i] = samples_from_this_block->const_data()[i] + process_offset;
+      }
+
+      block_range_buffer->set(copy_source.data(), destination_offset, copy_length);
 
       NodeValueTable::Merge({merged_table, table});
     }
@@ -262,6 +404,76 @@ NodeValueTable RenderProcessor::GenerateBlockTable(const TrackOutput *track, con
   }
 }
 
+void RenderProcessor::ApplyVariableSpeed(const Block *block, const TimeRange &range, SampleBufferPtr samples, int output_count)
+{
+  // Speed is sampled every few samples and assumed linear in between, which is exact for linear
+  // keyframes and plenty for everything else
+  const int kSpeedInterval = 64;
+
+  const AudioParams& params = samples->audio_params();
+
+  QVector<double> positions(qMax(0, output_count));
+
+  double position = 0;
+  double start_speed = block->GetSpeedAtTime(range.in());
+
+  for (int i=0;i<positions.size();i+=kSpeedInterval) {
+    int count = qMin(kSpeedInterval, positions.size() - i);
+    double end_speed = block->GetSpeedAtTime(range.in() + params.samples_to_time(i + count));
+    double speed_delta = (end_speed - start_speed) / count;
+
+    for (int j=0;j<count;j++) {
+      // Area under a linear ramp from `start_speed`
+      positions[i + j] = position + start_speed * j + 0.5 * speed_delta * j * j;
+    }
+
+    position += (start_speed + end_speed) * 0.5 * count;
+    start_speed = end_speed;
+  }
+
+  samples->resample(positions);
+}
+
+SampleBufferPtr RenderProcessor::ApplyTempo(SampleBufferPtr samples, double speed)
+{
+  // SampleBuffers are always float, TempoProcessor works on packed data
+  AudioParams packed_params(samples->audio_params().sample_rate(),
+                            samples->audio_params().channel_layout(),
+                            AudioParams::kFormatFloat32);
+
+  TempoProcessor tempo;
+
+  if (!tempo.Open(packed_params, speed)) {
+    samples->speed(speed);
+    return samples;
+  }
+
+  QByteArray packed_data = samples->toPackedData();
+  tempo.Push(packed_data.constData(), packed_data.size());
+
+  // Flush the filter so we get all of the audio back
+  tempo.Push(nullptr, 0);
+
+  QByteArray processed_data;
+  processed_data.reserve(qCeil(packed_data.size() / speed));
+
+  char buffer[16384];
+  int pulled;
+
+  while ((pulled = tempo.Pull(buffer, sizeof(buffer))) > 0) {
+    processed_data.append(buffer, pulled);
+  }
+
+  tempo.Close();
+
+  if (processed_data.isEmpty()) {
+    samples->speed(speed);
+    return samples;
+  }
+
+  return SampleBuffer::CreateFromPackedData(packed_params, processed_data);
+}
+
 QVariant RenderProcessor::ProcessVideoFootage(VideoStream *video_stream, const rational &input_time)
 {
   TexturePtr value = nullptr;
@@ -269,27 +481,13 @@ QVariant RenderProcessor::ProcessVideoFootage(VideoStream *video_stream, const r
   // Check the still frame cache. On large frames such as high resolution still images, uploading
   // and color managing them for every frame is a waste of time, so we implement a small cache here
   // to optimize such a situation
+  StillImageCache::EntryPtr want_entry = CreateStillImageEntry(video_stream, input_time);
+  int footage_divider = want_entry->divider;
+
   const VideoParams& video_params = ticket_->property("vparam").value<VideoParams>();
 
   ColorManager* color_manager = Node::ValueToPtr<ColorManager>(ticket_->property("colormanager"));
 
-  // See if we can make this divider larger (i.e. if the fooage is smaller)
-  int footage_divider = video_params.divider();
-  while (footage_divider > 1
-         && VideoParams::GetScaledDimension(video_stream->width(), footage_divider-1) < video_params.effective_width()
-         && VideoParams::GetScaledDimension(video_stream->height(), footage_divider-1) < video_params.effective_height()) {
-    footage_divider--;
-  }
-
-  StillImageCache::EntryPtr want_entry = std::make_shared<StillImageCache::Entry>(
-        nullptr,
-        video_stream,
-        ColorProcessor::GenerateID(color_manager, video_stream->colorspace(), color_manager->GetReferenceColorSpace()),
-        video_stream->premultiplied_alpha(),
-        footage_divider,
-        (video_stream->video_type() == VideoStream::kVideoTypeStill) ? 0 : input_time,
-        true);
-
   bool found_existing = false;
 
   still_image_cache_->mutex()->lock();
@@ -324,42 +522,44 @@ QVariant RenderProcessor::ProcessVideoFootage(VideoStream *video_stream, const r
 
     still_image_cache_->mutex()->unlock();
 
+    FramePtr frame = nullptr;
+
     DecoderPtr decoder = ResolveDecoderFromInput(video_stream);
 
     if (decoder) {
-      FramePtr frame = decoder->RetrieveVideo(input_time,
-                                              footage_divider);
-
-      if (frame) {
-        // Return a texture from the derived class
-        TexturePtr unmanaged_texture = render_ctx_->CreateTexture(frame->video_params(),
-                                                                  frame->data(),
-                                                                  frame->linesize_pixels());
-
-        // We convert to our rendering pixel format, since that will always be float-based which
-        // is necessary for correct color conversion
-        VideoParams managed_params = frame->video_params();
-        managed_params.set_format(video_params.format());
-        value = render_ctx_->CreateTexture(managed_params);
-
-        ColorProcessorPtr processor = ColorProcessor::Create(color_manager,
+      frame = decoder->RetrieveVideo(input_time,
+                                     footage_divider);
+    }
+
+    if (frame) {
+      // Return a texture from the derived class
+      TexturePtr unmanaged_texture = render_ctx_->CreateTexture(frame->video_params(),
+                                                                frame->data(),
+                                                                frame->linesize_pixels());
+
+      // We convert to our rendering pixel format, since that will always be float-based which
+      // is necessary for correct color conversion
+      VideoParams managed_params = frame->video_params();
+      managed_params.set_format(video_params.format());
+      value = render_ctx_->CreateTexture(managed_params);
+
+      ColorProcessorPtr processor = ColorProcessorCache::Get(color_manager,
                                                              video_stream->colorspace(),
                                                              color_manager->GetReferenceColorSpace());
 
-        render_ctx_->BlitColorManaged(processor, unmanaged_texture,
-                                      video_stream->premultiplied_alpha(),
-                                      value.get());
+      render_ctx_->BlitColorManaged(processor, unmanaged_texture,
+                                    video_stream->premultiplied_alpha(),
+                                    value.get());
 
-        still_image_cache_->mutex()->lock();
+      still_image_cache_->mutex()->lock();
 
-        // Put this into the image cache instead
-        want_entry->texture = value;
-        want_entry->working = false;
+      // Put this into the image cache instead
+      want_entry->texture = value;
+      want_entry->working = false;
 
-        still_image_cache_->wait_cond()->wakeAll();
+      still_image_cache_->wait_cond()->wakeAll();
 
-        still_image_cache_->mutex()->unlock();
-      }
+      still_image_cache_->mutex()->unlock();
     }
   }
 
@@ -389,22 +589,6 @@ QVariant RenderProcessor::ProcessShader(const Node *node, const TimeRange &range
 {
   Q_UNUSED(range)
 
-  QString full_shader_id = QStringLiteral("%1:%2").arg(node->id(), job.GetShaderID());
-
-  QMutexLocker locker(shader_cache_->mutex());
-
-  QVariant shader = shader_cache_->value(full_shader_id);
-
-  if (shader.isNull()) {
-    // Since we have shader code, compile it now
-    shader = render_ctx_->CreateNativeShader(node->GetShaderCode(job.GetShaderID()));
-
-    if (shader.isNull()) {
-      // Couldn't find or build the shader required
-      return QVariant();
-    }
-  }
-
   VideoParams tex_params = ticket_->property("vparam").value<VideoParams>();
 
   bool input_textures_have_alpha = false;
@@ -424,10 +608,74 @@ QVariant RenderProcessor::ProcessShader(const Node *node, const TimeRange &range
     tex_params.set_channel_count(VideoParams::kRGBChannelCount);
   }
 
+  if (ShaderChain::IsFusable(job)) {
+    // Defer this job so it can be drawn together with any fusable jobs before or after it
+    TexturePtr input = job.GetValue(job.GetFusionInput()).data.value<TexturePtr>();
+
+    QMutexLocker pending_locker(&pending_lock_);
+
+    PendingTexturePtr pending = std::make_shared<PendingTexture>();
+
+    PendingTexturePtr upstream = pending_textures_.value(input.get()).lock();
+    if (upstream
+        && !upstream->texture
+        && upstream->chain.count() < ShaderChain::kMaximumLength) {
+      // Input hasn't been drawn yet, extend its chain instead
+      pending->chain = upstream->chain;
+    } else {
+      pending->chain.SetSource(ResolveTexture(input));
+    }
+
+    pending->chain.Append(job);
+
+    // The deleter holds the only strong reference to the entry, dropping it with the placeholder
+    TexturePtr placeholder(new Texture(render_ctx_, QVariant(), tex_params, Texture::k2D),
+                           [pending](Texture* t) mutable {
+      pending.reset();
+      delete t;
+    });
+
+    pending_textures_.insert(placeholder.get(), pending);
+
+    return QVariant::fromValue(placeholder);
+  }
+
+  QString full_shader_id = QStringLiteral("%1:%2").arg(node->id(), job.GetShaderID());
+
+  QVariant shader;
+
+  {
+    QMutexLocker locker(shader_cache_->mutex());
+
+    shader = shader_cache_->value(full_shader_id);
+
+    if (shader.isNull()) {
+      // Since we have shader code, compile it now
+      shader = render_ctx_->CreateNativeShader(node->GetShaderCode(job.GetShaderID()));
+
+      if (shader.isNull()) {
+        // Couldn't find or build the shader required
+        return QVariant();
+      }
+
+      shader_cache_->insert(full_shader_id, shader);
+    }
+  }
+
+  // Draw any deferred inputs now since this shader needs to sample them
+  ShaderJob resolved_job = job;
+  for (auto it=job.GetValues().cbegin(); it!=job.GetValues().cend(); it++) {
+    if (it.value().type == NodeParam::kTexture && !it.value().array) {
+      ShaderValue v = it.value();
+      v.data = QVariant::fromValue(ResolveTexture(v.data.value<TexturePtr>()));
+      resolved_job.InsertValue(it.key(), v);
+    }
+  }
+
   TexturePtr destination = render_ctx_->CreateTexture(tex_params);
 
   // Run shader
-  render_ctx_->BlitToTexture(shader, job, destination.get());
+  render_ctx_->BlitToTexture(shader, resolved_job, destination.get());
 
   return QVariant::fromValue(destination);
 }
@@ -443,28 +691,59 @@ QVariant RenderProcessor::ProcessSamples(const Node *node, const TimeRange &rang
 
   const AudioParams& audio_params = ticket_->property("aparam").value<AudioParams>();
 
-  for (int i=0;i<job.samples()->sample_count();i++) {
-    // Calculate the exact rational time at this sample
-    double sample_to_second = static_cast<double>(i) / static_cast<double>(audio_params.sample_rate());
+  // Inputs that can't change over this range are only processed once, the rest every sample
+  QVector<NodeInput*> varying_inputs;
 
-    rational this_sample_time = rational::fromDouble(range.in().toDouble() + sample_to_second);
+  NodeValueMap::const_iterator j;
+  for (j=job.GetValues().constBegin(); j!=job.GetValues().constEnd(); j++) {
+    NodeInput* corresponding_input = node->GetInputWithID(j.key());
 
-    // Update all non-sample and non-footage inputs
-    NodeValueMap::const_iterator j;
-    for (j=job.GetValues().constBegin(); j!=job.GetValues().constEnd(); j++) {
-      NodeValueTable value;
-      NodeInput* corresponding_input = node->GetInputWithID(j.key());
+    if (corresponding_input
+        && (corresponding_input->is_connected()
+            || corresponding_input->is_keyframing()
+            || corresponding_input->IsArray())) {
+      varying_inputs.append(corresponding_input);
+      continue;
+    }
 
-      if (corresponding_input) {
-        value = ProcessInput(corresponding_input, TimeRange(this_sample_time, this_sample_time));
+    NodeValueTable value;
+
+    if (corresponding_input) {
+      value = ProcessInput(corresponding_input, TimeRange(range.in(), range.in()));
+    } else {
+      value.Push(j.value(), node);
+    }
+
+    value_db.Insert(j.key(), value);
+  }
+
+  if (varying_inputs.isEmpty()) {
+    AddGlobalsToDatabase(value_db, TimeRange(range.in(), range.in()));
+  }
+
+  // Step through samples in integer ticks, which every common sample rate divides exactly. A
+  // rational time is only made for samples that actually need one.
+  int64_t sample_ticks = Tick::from_time(range.in());
+  int64_t ticks_per_sample = Tick::per_timebase(audio_params.time_base());
+
+  for (int i=0;i<job.samples()->sample_count();i++, sample_ticks+=ticks_per_sample) {
+    if (!varying_inputs.isEmpty()) {
+      rational this_sample_time;
+
+      if (ticks_per_sample) {
+        this_sample_time = Tick::to_time(sample_ticks);
       } else {
-        value.Push(j.value(), node);
+        this_sample_time = range.in() + rational(i, audio_params.sample_rate());
       }
 
-      value_db.Insert(j.key(), value);
-    }
+      TimeRange this_sample_range(this_sample_time, this_sample_time);
 
-    AddGlobalsToDatabase(value_db, TimeRange(this_sample_time, this_sample_time));
+      foreach (NodeInput* input, varying_inputs) {
+        value_db.Insert(input, ProcessInput(input, this_sample_range));
+      }
+
+      AddGlobalsToDatabase(value_db, this_sample_range);
+    }
 
     node->ProcessSamples(value_db,
                          job.samples(),
@@ -475,18 +754,10 @@ QVariant RenderProcessor::ProcessSamples(const Node *node, const TimeRange &rang
   return QVariant::fromValue(output_buffer);
 }
 
-QVariant RenderProcessor::ProcessFrameGeneration(const Node *node, const GenerateJob &job)
+QVariant RenderProcessor::ProcessFrameGeneration(const Node *node, const TimeRange &range, const GenerateJob &job)
 {
   FramePtr frame = Frame::Create();
-
-  VideoParams frame_params = ticket_->property("vparam").value<VideoParams>();
-  if (job.GetAlphaChannelRequired()) {
-    frame_params.set_channel_count(VideoParams::kRGBAChannelCount);
-  } else {
-    frame_params.set_channel_count(VideoParams::kRGBChannelCount);
-  }
-
-  frame->set_video_params(frame_params);
+  frame->set_video_params(GetGeneratedFrameParams(job));
   frame->allocate();
 
   node->GenerateFrame(frame, job);
@@ -495,6 +766,21 @@ QVariant RenderProcessor::ProcessFrameGeneration(const Node *node, const Generat
                                                   frame->data(),
                                                   frame->linesize_pixels());
 
+  if (!job.GetCoverageShaderID().isEmpty()) {
+    // Colorize coverage with the node's shader
+    ShaderJob coverage_job;
+
+    for (auto it=job.GetValues().cbegin(); it!=job.GetValues().cend(); it++) {
+      coverage_job.InsertValue(it.key(), it.value());
+    }
+
+    coverage_job.InsertValue(QStringLiteral("ove_maintex"), ShaderValue(QVariant::fromValue(texture), NodeParam::kTexture));
+    coverage_job.SetShaderID(job.GetCoverageShaderID());
+    coverage_job.SetAlphaChannelRequired(job.GetAlphaChannelRequired());
+
+    return ProcessShader(node, range, coverage_job);
+  }
+
   return QVariant::fromValue(texture);
 }
 
@@ -24,6 +24,7 @@
 #include "node/traverser.h"
 #include "render/renderer.h"
 #include "rendercache.h"
+#include "shaderchain.h"
 #include "stillimagecache.h"
 #include "threading/threadticket.h"
 
@@ -51,12 +52,17 @@ protected:
 
   virtual QVariant ProcessSamples(const Node *node, const TimeRange &range, const SampleJob &job) override;
 
-  virtual QVariant ProcessFrameGeneration(const Node *node, const GenerateJob& job) override;
+  virtual QVariant ProcessFrameGeneration(const Node *node, const TimeRange &range, const GenerateJob& job) override;
 
   virtual QVariant GetCachedFrame(const Node *node, const rational &time) override;
 
   virtual QVector2D GenerateResolution() const override;
 
+  virtual bool TraverseInputsInParallel() const override
+  {
+    return parallel_;
+  }
+
 private:
   RenderProcessor(RenderTicketPtr ticket, Renderer* render_ctx, StillImageCache* still_image_cache, DecoderCache* decoder_cache, ShaderCache* shader_cache, QVariant default_shader);
 
@@ -64,6 +70,41 @@ private:
 
   DecoderPtr ResolveDecoderFromInput(Stream* stream);
 
+  StillImageCache::EntryPtr CreateStillImageEntry(VideoStream* video_stream, const rational& input_time);
+
+  VideoParams GetGeneratedFrameParams(const GenerateJob& job) const;
+
+  /**
+   * @brief Returns a texture that's safe to draw from
+   *
+   * Fusable shader jobs aren't run immediately, instead ProcessShader() returns a placeholder
+   * texture with no native texture behind it. If that placeholder needs to be read by anything
+   * other than another fusable job, this function draws its chain and returns the result.
+   * Textures that aren't placeholders are returned as-is.
+   */
+  TexturePtr ResolveTexture(TexturePtr texture);
+
+  /**
+   * @brief Resample a block's audio along its keyframed speed curve
+   *
+   * `samples` must start at the media time of `range.in()`.
+   */
+  static void ApplyVariableSpeed(const Block* block, const TimeRange& range, SampleBufferPtr samples, int output_count);
+
+  /**
+   * @brief Change the speed of audio without changing its pitch
+   *
+   * Falls back to a regular speed change if the tempo filter couldn't be created.
+   */
+  static SampleBufferPtr ApplyTempo(SampleBufferPtr samples, double speed);
+
+  struct PendingTexture {
+    ShaderChain chain;
+    TexturePtr texture;
+  };
+
+  using PendingTexturePtr = std::shared_ptr<PendingTexture>;
+
   RenderTicketPtr ticket_;
 
   Renderer* render_ctx_;
@@ -76,6 +117,26 @@ private:
 
   QVariant default_shader_;
 
+  /**
+   * @brief Deferred draws, keyed by the placeholder texture that stands in for each one
+   *
+   * Each placeholder owns its entry, so a chain's source and its drawn texture are freed as soon
+   * as the last node using the placeholder is done with it rather than at the end of the ticket.
+   */
+  QHash<Texture*, std::weak_ptr<PendingTexture> > pending_textures_;
+
+  /// Recursive since ProcessShader() resolves inputs while it holds it
+  QMutex pending_lock_;
+
+  /**
+   * @brief Whether this ticket's inputs are traversed on the WorkStealingExecutor
+   *
+   * Only interactive and playback frames do this. Export and cache tickets already keep every
+   * RenderManager thread busy with a frame each, so splitting them up would only add more
+   * threads than there are cores.
+   */
+  bool parallel_;
+
 };
 
 }
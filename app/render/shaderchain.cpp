@@ -0,0 +1,169 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "shaderchain.h"
+
+#include <QVector2D>
+#include <QVector4D>
+
+namespace olive {
+
+const int ShaderChain::kMaximumLength = 8;
+
+bool ShaderChain::IsFusable(const ShaderJob &job)
+{
+  return job.GetFusion() != ShaderJob::kFusionNone
+      && job.GetIterationCount() <= 1
+      && job.GetValue(job.GetFusionInput()).data.value<TexturePtr>();
+}
+
+QString ShaderChain::GenerateShaderID() const
+{
+  QString id = QStringLiteral("chain:");
+
+  foreach (const ShaderJob& stage, stages_) {
+    id.append((stage.GetFusion() == ShaderJob::kFusionMatrix) ? QLatin1Char('m') : QLatin1Char('c'));
+  }
+
+  return id;
+}
+
+ShaderCode ShaderChain::GenerateShaderCode() const
+{
+  QString uniforms;
+  QString body;
+
+  // Walk backwards from the output pixel to the source texture, mapping the coordinate through
+  // each stage and collecting anything that would have masked it out along the way
+  for (int i=stages_.size()-1; i>=0; i--) {
+    if (stages_.at(i).GetFusion() == ShaderJob::kFusionMatrix) {
+      uniforms.append(QStringLiteral("uniform mat4 ove_chain%1_mat;\n").arg(i));
+
+      body.append(QStringLiteral("  mapped = ove_chain%1_mat * vec4(pos, 0.0, 1.0);\n"
+                                 "  pos = mapped.xy / mapped.w;\n"
+                                 "  multiplier *= in_quad(pos);\n").arg(i));
+    } else {
+      uniforms.append(QStringLiteral("uniform vec4 ove_chain%1_crop;\n"
+                                     "uniform float ove_chain%1_feather;\n"
+                                     "uniform vec2 ove_chain%1_res;\n").arg(i));
+
+      body.append(QStringLiteral("  multiplier *= crop_mask(pos * 0.5 + 0.5, ove_chain%1_crop, "
+                                 "ove_chain%1_feather, ove_chain%1_res);\n").arg(i));
+    }
+  }
+
+  QString frag = QStringLiteral("// Source texture\n"
+                                "uniform sampler2D ove_maintex;\n"
+                                "\n"
+                                "// Stage parameters\n"
+                                "%1"
+                                "\n"
+                                "// Input texture coordinate\n"
+                                "in vec2 ove_texcoord;\n"
+                                "\n"
+                                "// Output color\n"
+                                "out vec4 fragColor;\n"
+                                "\n"
+                                "// Returns 0.0 if this point lies outside of the texture drawn by a transform\n"
+                                "float in_quad(vec2 p) {\n"
+                                "  return (p.x < -1.0 || p.x > 1.0 || p.y < -1.0 || p.y > 1.0) ? 0.0 : 1.0;\n"
+                                "}\n"
+                                "\n"
+                                "// Equivalent to crop.frag, crop is (left, top, right, bottom)\n"
+                                "float crop_mask(vec2 coord, vec4 crop, float feather, vec2 resolution) {\n"
+                                "  if (feather == 0.0) {\n"
+                                "    return (coord.x < crop.x\n"
+                                "            || coord.x > (1.0-crop.z)\n"
+                                "            || coord.y < crop.y\n"
+                                "            || coord.y > (1.0-crop.w)) ? 0.0 : 1.0;\n"
+                                "  }\n"
+                                "\n"
+                                "  vec2 f = vec2(feather / resolution.x, feather / resolution.y);\n"
+                                "\n"
+                                "  float m = clamp((coord.x - (crop.x - f.x*(1.0-crop.x))) / f.x, 0.0, 1.0);\n"
+                                "  m *= 1.0-clamp((coord.x - ((1.0-crop.z) - f.x*(crop.z))) / f.x, 0.0, 1.0);\n"
+                                "  m *= clamp((coord.y - (crop.y - f.y*(1.0-crop.y))) / f.y, 0.0, 1.0);\n"
+                                "  m *= 1.0-clamp((coord.y - ((1.0-crop.w) - f.y*(crop.w))) / f.y, 0.0, 1.0);\n"
+                                "  return m;\n"
+                                "}\n"
+                                "\n"
+                                "void main() {\n"
+                                "  vec2 pos = ove_texcoord * 2.0 - 1.0;\n"
+                                "  float multiplier = 1.0;\n"
+                                "  vec4 mapped;\n"
+                                "\n"
+                                "%2"
+                                "\n"
+                                "  // Sample outside of any branch so mipmapping still works\n"
+                                "  fragColor = texture(ove_maintex, pos * 0.5 + 0.5) * multiplier;\n"
+                                "}\n").arg(uniforms, body);
+
+  // Default vertex shader draws a full frame quad which is what we want here
+  return ShaderCode(frag);
+}
+
+ShaderJob ShaderChain::GenerateJob() const
+{
+  ShaderJob job;
+
+  job.SetShaderID(GenerateShaderID());
+  job.InsertValue(QStringLiteral("ove_maintex"), ShaderValue(QVariant::fromValue(source_), NodeParam::kTexture));
+  job.SetAlphaChannelRequired(true);
+
+  // Since the source is only sampled once, use the lowest quality any stage asked for (a
+  // stage set to nearest neighbor should still look like nearest neighbor)
+  Texture::Interpolation interpolation = Texture::kMipmappedLinear;
+
+  for (int i=0; i<stages_.size(); i++) {
+    const ShaderJob& stage = stages_.at(i);
+
+    if (stage.GetFusion() == ShaderJob::kFusionMatrix) {
+      // Stages map backwards from their output, so they need the inverse of the matrix that
+      // would have drawn them
+      QMatrix4x4 matrix = stage.GetValue(QStringLiteral("ove_mvpmat")).data.value<QMatrix4x4>();
+
+      job.InsertValue(QStringLiteral("ove_chain%1_mat").arg(i),
+                      ShaderValue(matrix.inverted(), NodeParam::kMatrix));
+    } else {
+      QVector4D crop(stage.GetValue(QStringLiteral("left_in")).data.toFloat(),
+                     stage.GetValue(QStringLiteral("top_in")).data.toFloat(),
+                     stage.GetValue(QStringLiteral("right_in")).data.toFloat(),
+                     stage.GetValue(QStringLiteral("bottom_in")).data.toFloat());
+
+      job.InsertValue(QStringLiteral("ove_chain%1_crop").arg(i),
+                      ShaderValue(crop, NodeParam::kVec4));
+      job.InsertValue(QStringLiteral("ove_chain%1_feather").arg(i),
+                      ShaderValue(stage.GetValue(QStringLiteral("feather_in")).data, NodeParam::kFloat));
+      job.InsertValue(QStringLiteral("ove_chain%1_res").arg(i),
+                      ShaderValue(stage.GetValue(QStringLiteral("resolution_in")).data, NodeParam::kVec2));
+    }
+
+    Texture::Interpolation stage_interp = stage.GetInterpolation(stage.GetFusionInput());
+    if (stage_interp < interpolation) {
+      interpolation = stage_interp;
+    }
+  }
+
+  job.SetInterpolation(QStringLiteral("ove_maintex"), interpolation);
+
+  return job;
+}
+
+}
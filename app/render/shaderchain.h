@@ -0,0 +1,104 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef SHADERCHAIN_H
+#define SHADERCHAIN_H
+
+#include "render/job/shaderjob.h"
+#include "render/shadercode.h"
+
+namespace olive {
+
+/**
+ * @brief A sequence of fusable ShaderJobs that can be drawn in a single pass
+ *
+ * Transforms and crops don't need to see any pixels other than the one they're drawing, so a run
+ * of them can be expressed as a series of coordinate mappings and masks applied to one source
+ * texture. ShaderChain generates a fragment shader for that run, so rather than allocating and
+ * filling a full frame texture for every stage, only the final result is ever drawn.
+ *
+ * Stages are ordered from the one closest to the source texture to the final output.
+ */
+class ShaderChain
+{
+public:
+  ShaderChain() = default;
+
+  /**
+   * @brief Maximum amount of stages in one chain, chosen to stay well within uniform limits
+   */
+  static const int kMaximumLength;
+
+  /**
+   * @brief Returns whether this job can be added to a chain
+   */
+  static bool IsFusable(const ShaderJob& job);
+
+  const TexturePtr& source() const
+  {
+    return source_;
+  }
+
+  void SetSource(TexturePtr source)
+  {
+    source_ = source;
+  }
+
+  /**
+   * @brief Add a job on top of the current stages
+   *
+   * The job's fusion input is expected to be the output of the chain so far (or the source
+   * texture if the chain is empty).
+   */
+  void Append(const ShaderJob& job)
+  {
+    stages_.append(job);
+  }
+
+  int count() const
+  {
+    return stages_.size();
+  }
+
+  /**
+   * @brief Returns an ID unique to the layout of this chain for caching the compiled shader
+   *
+   * Chains with the same kinds of stages in the same order share a shader and differ only in
+   * their uniforms.
+   */
+  QString GenerateShaderID() const;
+
+  ShaderCode GenerateShaderCode() const;
+
+  /**
+   * @brief Create a job that draws this chain with the shader from GenerateShaderCode()
+   */
+  ShaderJob GenerateJob() const;
+
+private:
+  TexturePtr source_;
+
+  QVector<ShaderJob> stages_;
+
+};
+
+}
+
+#endif // SHADERCHAIN_H
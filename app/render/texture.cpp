@@ -28,7 +28,10 @@ const Texture::Interpolation Texture::kDefaultInterpolation = Texture::kMipmappe
 
 Texture::~Texture()
 {
-  renderer_->DestroyNativeTexture(id_);
+  // Textures that haven't been rendered yet (see RenderProcessor) have no native texture
+  if (!id_.isNull()) {
+    renderer_->ReleaseTexture(id_, params_, type_);
+  }
 }
 
 void Texture::Upload(void *data, int linesize)
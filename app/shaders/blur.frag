@@ -12,9 +12,6 @@ in vec2 ove_texcoord;
 
 out vec4 fragColor;
 
-// Gaussian function uses PI
-#define M_PI 3.1415926535897932384626433832795
-
 // Methods
 #define METHOD_BOX_BLUR 0
 #define METHOD_GAUSSIAN_BLUR 1
@@ -24,16 +21,11 @@ out vec4 fragColor;
 #define MODE_HORIZONTAL 1
 #define MODE_VERTICAL 2
 
-// Single gaussian formula (unused, mainly here for documentation/just in case)
-//float gaussian(float x, float sigma) {
-//    return (1.0/(sigma*sqrt(2.0*M_PI)))*exp(-0.5*pow(x/sigma, 2.0));
-//}
-
-// Double gaussian formula, actually used in the code below
-// Should be faster than the single gaussian above since it doesn't need sqrt()
-float gaussian2(float x, float y, float sigma) {
-    return (1.0/((sigma*sigma)*2.0*M_PI))*exp(-0.5*(((x*x) + (y*y))/(sigma*sigma)));
-}
+// Maximum amount of samples taken per pass. Radii that would need more than this sample from a
+// smaller mipmap instead, keeping the cost per pixel constant no matter how large the radius is.
+// Since each sample already averages two texels (and mipmaps average more), the result remains
+// visually indistinguishable from sampling every texel.
+#define MAX_SAMPLES 48.0
 
 int determine_mode() {
     if (radius_in == 0.0) {
@@ -72,39 +64,45 @@ void main(void) {
     // We only sample on hard pixels, so we don't accept decimal radii
     float real_radius = ceil(radius_in);
 
-    vec4 composite = vec4(0.0);
-
-    float divider, sigma;
-
-    if (method_in == METHOD_BOX_BLUR) {
-
-        // Calculate the weight of each pixel based on the radius
-        divider = 1.0 / real_radius;
-
-    } else if (method_in == METHOD_GAUSSIAN_BLUR) {
+    float sigma = real_radius;
 
+    if (method_in == METHOD_GAUSSIAN_BLUR) {
         // Using (radius = 3 * sigma) because 3 standard deviations covers 97% of the blur according to this document:
         // http://chemaguerra.com/gaussian-filter-radius/
-        sigma = real_radius;
         real_radius *= 3.0;
-
-        // Use gaussian formula to calculate the weight of all pixels
-        divider = 0.0;
-        for (float i = -real_radius + 0.5; i <= real_radius; i += 2.0) {
-            divider += gaussian2(i, 0.0, sigma);
-        }
-
     }
 
-    for (float i = -real_radius + 0.5; i <= real_radius; i += 2.0) {
-        float weight;
+    // Size of one texel of the input in the same units as the radius (they differ when rendering at
+    // a lower resolution or with non-square pixels)
+    vec2 input_size = vec2(textureSize(tex_in, 0));
+    float physical_texel_size = (mode == MODE_HORIZONTAL) ? resolution_in.x / input_size.x : resolution_in.y / input_size.y;
+
+    // Each sample is placed between two texels so that linear filtering averages both of them for
+    // us, therefore we need (radius / texel size) samples to cover the whole kernel. If that's too
+    // many, move up the mipmap chain where each texel covers more of the image.
+    float lod = max(0.0, ceil(log2(real_radius / physical_texel_size / MAX_SAMPLES)));
+    float texel_size = physical_texel_size * exp2(lod);
+    float sample_step = 2.0 * texel_size;
+    float start = -real_radius + 0.5 * texel_size;
+
+    // Rather than calling exp() for every sample, we calculate the gaussian weights incrementally.
+    // The ratio between consecutive weights changes by a constant factor, so after computing the
+    // first weight and ratio, each further weight only costs two multiplications.
+    float weight = 1.0;
+    float weight_ratio = 1.0;
+    float weight_ratio_factor = 1.0;
+
+    if (method_in == METHOD_GAUSSIAN_BLUR) {
+        float two_sigma_sq = 2.0 * sigma * sigma;
+        weight = exp(-(start * start) / two_sigma_sq);
+        weight_ratio = exp(-(2.0 * start * sample_step + sample_step * sample_step) / two_sigma_sq);
+        weight_ratio_factor = exp(-(2.0 * sample_step * sample_step) / two_sigma_sq);
+    }
 
-        if (method_in == METHOD_BOX_BLUR) {
-            weight = divider;
-        } else if (method_in == METHOD_GAUSSIAN_BLUR) {
-            weight = gaussian2(i, 0.0, sigma) / divider;
-        }
+    vec4 composite = vec4(0.0);
+    float weight_sum = 0.0;
 
+    for (float i = start; i <= real_radius; i += sample_step) {
         vec2 pixel_coord = ove_texcoord;
         if (mode == MODE_HORIZONTAL) {
             pixel_coord.x += i / resolution_in.x;
@@ -117,9 +115,15 @@ void main(void) {
                 && pixel_coord.x < 1.0
                 && pixel_coord.y >= 0.0
                 && pixel_coord.y < 1.0)) {
-            composite += texture(tex_in, pixel_coord) * weight;
+            composite += textureLod(tex_in, pixel_coord, lod) * weight;
         }
+
+        // Samples outside the image still count towards the total so edges fade out
+        weight_sum += weight;
+
+        weight *= weight_ratio;
+        weight_ratio *= weight_ratio_factor;
     }
 
-    fragColor = composite;
+    fragColor = composite / weight_sum;
 }
@@ -6,6 +6,10 @@ uniform float opacity_in;
 uniform bool inner_in;
 uniform vec2 resolution_in;
 
+// Distance field inputs (see StrokeFilterNode::Value())
+uniform sampler2D seed_in;
+uniform int jump_steps_in;
+
 // Standard inputs
 uniform int ove_iteration;
 
@@ -13,50 +17,104 @@ in vec2 ove_texcoord;
 
 out vec4 fragColor;
 
+// The stroke is drawn from a distance field built by jump flooding, which costs a fixed 9 samples
+// per pass and one pass per power of two of the radius:
+//
+// - Iteration 0 marks "seeds", pixels inside the shape (or outside it for an inner stroke)
+// - Each jump iteration checks the seeds found by the pixels `step` away and keeps the nearest,
+//   halving `step` every time. One more pass at a step of 1 fixes most of the flood's errors.
+// - The last iteration draws the stroke from each pixel's distance to its nearest seed.
+//
+// Each pixel stores the offset in pixels to its nearest seed in RG, and whether it found one at
+// all in B. The intermediate textures are half float (see StrokeFilterNode::Value()), which holds
+// whole pixel offsets exactly up to 2048.
+
+float jump_range() {
+    return exp2(float(jump_steps_in));
+}
+
+vec4 encode_offset(vec2 offset) {
+    return vec4(offset, 1.0, 1.0);
+}
+
+vec2 decode_offset(vec4 v) {
+    return v.xy;
+}
+
+bool is_seed(float alpha) {
+    return inner_in ? (alpha < 0.5) : (alpha >= 0.5);
+}
+
 void main(void) {
     vec4 pixel_here = texture(tex_in, ove_texcoord);
 
-    // Detect no-op situations
-    if (radius_in == 0.0
-        || opacity_in == 0.0
-        || (inner_in && pixel_here.a == 0.0)
-        || (!inner_in && pixel_here.a == 1.0)) {
-        // No-op, do nothing
-        fragColor = pixel_here;
+    if (ove_iteration == 0) {
+        fragColor = is_seed(pixel_here.a) ? encode_offset(vec2(0.0)) : vec4(0.0);
         return;
     }
 
-    float radius = ceil(radius_in);
-
-    float stroke_weight = 0.0;
+    // Seed offsets are in pixels of our destination, distances are measured in sequence pixels
+    vec2 size = vec2(textureSize(seed_in, 0));
+    vec2 pixel_scale = resolution_in / size;
 
-    // Loop over box
-    for (float i=-radius + 0.5; i<=radius; i += 2.0) {
-        float x_coord = i / resolution_in.x;
+    if (ove_iteration <= jump_steps_in + 1) {
+        float step = (ove_iteration > jump_steps_in) ? 1.0 : exp2(float(jump_steps_in - ove_iteration));
 
-        for (float j=-radius + 0.5; j<=radius; j += 2.0) {
-            float y_coord = j / resolution_in.y;
+        vec2 nearest = vec2(0.0);
+        float nearest_dist = -1.0;
 
-            if (abs(length(vec2(i, j))) < radius) {
-                // Get pixel here
-                float alpha = texture(tex_in, ove_texcoord + vec2(x_coord, y_coord)).a;
+        for (int x=-1; x<=1; x++) {
+            for (int y=-1; y<=1; y++) {
+                vec2 neighbor = vec2(float(x), float(y)) * step;
+                vec2 coord = ove_texcoord + neighbor / size;
 
-                if (inner_in) {
-                    alpha = 1.0 - alpha;
+                if (coord.x < 0.0 || coord.y < 0.0 || coord.x > 1.0 || coord.y > 1.0) {
+                    continue;
                 }
 
-                stroke_weight += alpha;
+                vec4 seed = texture(seed_in, coord);
+
+                if (seed.b > 0.5) {
+                    vec2 offset = neighbor + decode_offset(seed);
 
-                if (stroke_weight >= 1.0) {
-                    break;
+                    // Seeds further than this are beyond any stroke
+                    if (abs(offset.x) > jump_range() || abs(offset.y) > jump_range()) {
+                        continue;
+                    }
+
+                    vec2 scaled = offset * pixel_scale;
+                    float dist = dot(scaled, scaled);
+
+                    if (nearest_dist < 0.0 || dist < nearest_dist) {
+                        nearest = offset;
+                        nearest_dist = dist;
+                    }
                 }
             }
         }
 
-        if (stroke_weight >= 1.0) {
-            stroke_weight = 1.0;
-            break;
-        }
+        fragColor = (nearest_dist < 0.0) ? vec4(0.0) : encode_offset(nearest);
+        return;
+    }
+
+    // Detect no-op situations
+    if (radius_in == 0.0
+        || opacity_in == 0.0
+        || (inner_in && pixel_here.a == 0.0)
+        || (!inner_in && pixel_here.a == 1.0)) {
+        // No-op, do nothing
+        fragColor = pixel_here;
+        return;
+    }
+
+    float stroke_weight = 0.0;
+
+    vec4 seed = texture(seed_in, ove_texcoord);
+
+    if (seed.b > 0.5) {
+        // Anti-alias the stroke's edge over one pixel
+        float dist = length(decode_offset(seed) * pixel_scale);
+        stroke_weight = clamp(radius_in - dist + 0.5, 0.0, 1.0);
     }
 
     stroke_weight *= opacity_in;
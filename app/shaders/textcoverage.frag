@@ -0,0 +1,15 @@
+// Input variables
+uniform sampler2D ove_maintex;
+uniform vec4 color_in;
+
+// Input texture coordinate
+in vec2 ove_texcoord;
+
+// Output color
+out vec4 fragColor;
+
+void main() {
+    // Text is rendered as coverage only, apply color here (premultiplied)
+    float alpha = texture(ove_maintex, ove_texcoord).r;
+    fragColor = vec4(color_in.rgb * alpha, alpha);
+}
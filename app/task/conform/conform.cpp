@@ -33,28 +33,29 @@ ConformTask::ConformTask(AudioStream *stream, const AudioParams& params) :
 
 bool ConformTask::Run()
 {
-  // Conforming is done by the renderer now, but I would like to use something like this just to
-  // show progress
+  DecoderPtr decoder = Decoder::CreateFromID(stream_->footage()->decoder());
 
-  /*if (stream_->footage()->decoder().isEmpty()) {
+  if (!decoder) {
     SetError(tr("Failed to find decoder to conform audio stream"));
     return false;
-  } else {
-    DecoderPtr decoder = Decoder::CreateFromID(stream_->footage()->decoder());
+  }
 
-    decoder->set_stream(stream_);
+  connect(decoder.get(), &Decoder::IndexProgress, this, &ConformTask::ProgressChanged);
 
-    connect(decoder.get(), &Decoder::IndexProgress, this, &ConformTask::ProgressChanged);
+  if (!decoder->Open(stream_)) {
+    SetError(tr("Failed to open media to conform audio stream"));
+    return false;
+  }
+
+  bool success = decoder->ConformAudio(params_, &IsCancelled());
+
+  decoder->Close();
 
-    if (!decoder->ConformAudio(&IsCancelled(), params_)) {
-      SetError(tr("Failed to conform audio"));
-      return false;
-    } else {
-      return true;
-    }
-  }*/
+  if (!success && !IsCancelled()) {
+    SetError(tr("Failed to conform audio"));
+  }
 
-  return true;
+  return success;
 }
 
 }
@@ -20,124 +20,243 @@
 
 #include "export.h"
 
+#include <OpenImageIO/imagebufalgo.h>
+
+#include "common/oiioutils.h"
 #include "common/timecodefunctions.h"
 #include "render/colormanager.h"
+#include "threading/workstealingexecutor.h"
 
 namespace olive {
 
 ExportTask::ExportTask(ViewerOutput* viewer_node,
                        ColorManager* color_manager,
                        const ExportParams& params) :
-  RenderTask(viewer_node, params.video_params(), params.audio_params()),
+  ExportTask(viewer_node, color_manager, QVector<ExportParams>({params}))
+{
+}
+
+ExportTask::ExportTask(ViewerOutput *viewer_node,
+                       ColorManager *color_manager,
+                       const QVector<ExportParams> &params) :
+  RenderTask(viewer_node, GetRenderVideoParams(viewer_node, params), GetRenderAudioParams(params)),
   color_manager_(color_manager),
-  params_(params)
+  master_render_(!AllOutputsRenderSame(params)),
+  ordered_frames_(true),
+  segment_audio_encoder_(nullptr),
+  write_failed_(0)
 {
+  foreach (const ExportParams& p, params) {
+    outputs_.append({p, p.filename(), QStringList(), QStringList(), nullptr, nullptr});
+  }
+
   SetTitle(tr("Exporting \"%1\"").arg(viewer_node->media_name()));
 }
 
+const int ExportTask::kMinimumSegmentLength = 48;
+
 bool ExportTask::Run()
 {
   TimeRange range;
 
-  // For safety, if we're overwriting, we save to a temporary filename and then only overwrite it
-  // at the end
-  QString real_filename = params_.filename();
-  if (QFileInfo::exists(params_.filename())) {
-    // Generate a filename that definitely doesn't exist
-    params_.SetFilename(FileFunctions::GetSafeTemporaryFilename(real_filename));
+  // Every output covers the same range, so we can take it from any of them
+  const ExportParams& params = outputs_.first().params;
+
+  if (params.has_custom_range()) {
+    // Render custom range only
+    range = params.custom_range();
+  } else {
+    // Render entire sequence
+    range = TimeRange(0, viewer()->GetLength());
   }
 
-  encoder_ = Encoder::CreateFromID(params_.encoder(), params_);
+  int64_t frame_count = Timecode::time_to_timestamp(range.length(), viewer()->video_params().time_base());
 
-  if (!encoder_) {
-    SetError(tr("Failed to create encoder"));
-    return false;
-  }
+  for (int i=0; i<outputs_.size(); i++) {
+    Output& o = outputs_[i];
+
+    // For safety, if we're overwriting, we save to a temporary filename and then only overwrite it
+    // at the end
+    if (QFileInfo::exists(o.real_filename)) {
+      // Generate a filename that definitely doesn't exist
+      o.params.SetFilename(FileFunctions::GetSafeTemporaryFilename(o.real_filename));
+    }
+
+    o.encoder = Encoder::CreateFromID(o.params.encoder(), o.params);
+
+    if (!o.encoder) {
+      SetError(tr("Failed to create encoder"));
+      CloseEncoders(true);
+      return false;
+    }
+
+    int segment_count = GetSegmentCount(frame_count);
+
+    if (segment_count > 1) {
+      // This encoder's file will be created by joining the segments, so we don't open it now
+      if (!OpenSegments(o, segment_count, frame_count)) {
+        SetError(tr("Failed to open file"));
+        FinishSegments(o, false);
+        CloseEncoders(true);
+        return false;
+      }
 
-  if (!encoder_->Open()) {
-    SetError(tr("Failed to open file"));
-    encoder_->deleteLater();
-    return false;
+      SetInterleavedSegments(segment_count);
+    } else if (!o.encoder->Open()) {
+      SetError(tr("Failed to open file"));
+      delete o.encoder;
+      o.encoder = nullptr;
+      CloseEncoders(true);
+      return false;
+    }
   }
 
-  if (params_.has_custom_range()) {
-    // Render custom range only
-    range = params_.custom_range();
-  } else {
-    // Render entire sequence
-    range = TimeRange(0, viewer()->GetLength());
+  bool video_enabled = false;
+  bool audio_enabled = false;
+  ordered_frames_ = false;
+
+  foreach (const Output& o, outputs_) {
+    video_enabled |= o.params.video_enabled();
+    audio_enabled |= o.params.audio_enabled();
+    ordered_frames_ |= o.encoder->RequiresOrderedFrames();
   }
 
   frame_time_ = 0;
+  write_failed_ = 0;
 
   QSize video_force_size;
   QMatrix4x4 video_force_matrix;
-
-  if (params_.video_enabled()) {
+  VideoParams::Format video_force_format = VideoParams::kFormatInvalid;
+
+  if (master_render_) {
+    // Render in the reference space at the sequence's resolution, each output converts it to its
+    // own color transform and size after
+    for (int i=0; i<outputs_.size(); i++) {
+      Output& o = outputs_[i];
+
+      if (o.params.video_enabled()) {
+        o.color_processor = ColorProcessor::Create(color_manager_,
+                                                   color_manager_->GetReferenceColorSpace(),
+                                                   o.params.color_transform());
+      }
+    }
+  } else if (video_enabled) {
 
     // If a transformation matrix is applied to this video, create it here
-    if (viewer()->video_params().width() != params_.video_params().width()
-        || params_.video_params().height() != params_.video_params().height()) {
-      video_force_size = QSize(params_.video_params().width(), params_.video_params().height());
+    if (viewer()->video_params().width() != params.video_params().width()
+        || params.video_params().height() != params.video_params().height()) {
+      video_force_size = QSize(params.video_params().width(), params.video_params().height());
 
-      if (params_.video_scaling_method() != ExportParams::kStretch) {
-        video_force_matrix = ExportParams::GenerateMatrix(params_.video_scaling_method(),
+      if (params.video_scaling_method() != ExportParams::kStretch) {
+        video_force_matrix = ExportParams::GenerateMatrix(params.video_scaling_method(),
                                                           viewer()->video_params().width(),
                                                           viewer()->video_params().height(),
-                                                          params_.video_params().width(),
-                                                          params_.video_params().height());
+                                                          params.video_params().width(),
+                                                          params.video_params().height());
       }
     } else {
       // Disables forcing size in the renderer
       video_force_size = QSize(0, 0);
     }
 
+    if (segments_.isEmpty()) {
+      video_force_format = outputs_.first().encoder->GetDesiredPixelFormat();
+    } else {
+      video_force_format = segments_.first()->encoder->GetDesiredPixelFormat();
+    }
+
     // Create color processor
     color_processor_ = ColorProcessor::Create(color_manager_,
                                               color_manager_->GetReferenceColorSpace(),
-                                              params_.color_transform());
+                                              params.color_transform());
   }
 
-  if (params_.audio_enabled()) {
+  if (audio_enabled) {
     audio_data_.SetParameters(audio_params());
   }
 
   // Start render process
   TimeRangeList video_range, audio_range;
 
-  if (params_.video_enabled()) {
+  if (video_enabled) {
     video_range = {range};
   }
 
-  if (params_.audio_enabled()) {
+  if (audio_enabled) {
     audio_range = {range};
     audio_data_.SetLength(range.length());
   }
 
   Render(color_manager_, video_range, audio_range, RenderMode::kOnline, nullptr,
-         video_force_size, video_force_matrix, encoder_->GetDesiredPixelFormat(),
+         video_force_size, video_force_matrix, video_force_format,
          color_processor_);
 
+  if (!segments_.isEmpty()) {
+    // Wait for segment encoders to finish any frames they're still working on
+    segment_group_.Wait();
+  }
+
   bool success = true;
 
-  if (params_.audio_enabled()) {
-    // Write audio data now
-    encoder_->WriteAudio(audio_params(), audio_data_.CreatePlaybackDevice(encoder_));
+  if (audio_enabled && !IsCancelled()) {
+    // Write audio data now, each encoder resamples it to its own format if necessary
+    TaskGroup audio_group;
+
+    foreach (const Output& o, outputs_) {
+      if (o.params.audio_enabled()) {
+        // When encoding in segments, audio is encoded to its own file that's added when joining
+        Encoder* encoder = segments_.isEmpty() ? o.encoder : segment_audio_encoder_;
+        QIODevice* device = audio_data_.CreatePlaybackDevice(encoder);
+        AudioParams pcm_params = audio_params();
+
+        audio_group.Run([encoder, device, pcm_params]{
+          encoder->WriteAudio(pcm_params, device);
+        });
+      }
+    }
+
+    audio_group.Wait();
   }
 
-  encoder_->Close();
+  if (!segments_.isEmpty()) {
+    // Nothing to join if the export was cancelled, the segments are just cleaned up
+    bool join = !IsCancelled();
 
-  delete encoder_;
+    if (!FinishSegments(outputs_.first(), join) && join) {
+      SetError(tr("Failed to join segments into \"%1\"").arg(outputs_.first().real_filename));
+      success = false;
+    }
+  }
 
-  // If cancelled, delete the file we made, which is always a file we created since we write to a
-  // temp file during the actual encoding process
-  if (IsCancelled()) {
-    QFile::remove(params_.filename());
-  } else if (params_.filename() != real_filename) {
-    // If we were writing to a temp file, overwrite now
-    if (!FileFunctions::RenameFileAllowOverwrite(params_.filename(), real_filename)) {
-      SetError(tr("Failed to overwrite \"%1\". Export has been saved as \"%2\" instead.")
-               .arg(real_filename, params_.filename()));
+  // If cancelled, delete the files we made, which are always files we created since we write to a
+  // temp file during the actual encoding process. Some encoders are still writing in the
+  // background until they're closed, so only then do we know if everything was written.
+  if (!CloseEncoders(IsCancelled() || !success) || write_failed_.load()) {
+    SetError(tr("Failed to write one or more frames"));
+    success = false;
+  }
+
+  if (success && !IsCancelled()) {
+    QStringList failed_renames;
+
+    foreach (const Output& o, outputs_) {
+      if (o.params.filename() == o.real_filename) {
+        continue;
+      }
+
+      // If we were writing to a temp file, overwrite now. Image sequences have one of these per
+      // frame, so only the first failure of each output is reported.
+      for (int i=0; i<o.written_filenames.size(); i++) {
+        if (!FileFunctions::RenameFileAllowOverwrite(o.written_filenames.at(i), o.real_filenames.at(i))) {
+          failed_renames.append(tr("Failed to overwrite \"%1\". Export has been saved as \"%2\" instead.")
+                                .arg(o.real_filenames.at(i), o.written_filenames.at(i)));
+          break;
+        }
+      }
+    }
+
+    if (!failed_renames.isEmpty()) {
+      SetError(failed_renames.join('\n'));
       success = false;
     }
   }
@@ -145,19 +264,402 @@ bool ExportTask::Run()
   return success;
 }
 
+int ExportTask::GetSegmentCount(int64_t frame_count) const
+{
+  // Segments are joined into one file, so only do this when exporting one
+  if (outputs_.size() != 1 || !outputs_.first().encoder->CanJoinSegments()) {
+    return 1;
+  }
+
+  return qBound(1, int(frame_count / kMinimumSegmentLength), QThread::idealThreadCount());
+}
+
+QString ExportTask::GetPartFilename(const QString &filename, const QString &part)
+{
+  QFileInfo info(filename);
+
+  QString suffix = info.suffix();
+  if (!suffix.isEmpty()) {
+    suffix.prepend('.');
+  }
+
+  QString part_filename;
+  int counter = 0;
+
+  do {
+    part_filename = info.dir().filePath(QStringLiteral("%1.%2%3%4").arg(info.completeBaseName(),
+                                                                         part,
+                                                                         QString::number(counter),
+                                                                         suffix));
+    counter++;
+  } while (QFileInfo::exists(part_filename));
+
+  return part_filename;
+}
+
+bool ExportTask::OpenSegments(const Output &output, int count, int64_t frame_count)
+{
+  for (int i=0; i<count; i++) {
+    EncodingParams segment_params = output.params;
+    segment_params.DisableAudio();
+    segment_params.SetFilename(GetPartFilename(output.real_filename, QStringLiteral("segment%1-").arg(i)));
+
+    Segment* s = new Segment();
+    s->encoder = Encoder::CreateFromID(output.params.encoder(), segment_params);
+    s->start = frame_count * i / count;
+    s->end = frame_count * (i + 1) / count;
+    s->next = s->start;
+    s->busy = false;
+    segments_.append(s);
+
+    if (!s->encoder || !s->encoder->Open()) {
+      return false;
+    }
+  }
+
+  if (output.params.audio_enabled()) {
+    EncodingParams audio_params = output.params;
+    audio_params.DisableVideo();
+    audio_params.SetFilename(GetPartFilename(output.real_filename, QStringLiteral("audio")));
+
+    segment_audio_encoder_ = Encoder::CreateFromID(output.params.encoder(), audio_params);
+
+    if (!segment_audio_encoder_ || !segment_audio_encoder_->Open()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ExportTask::QueueSegmentFrame(int64_t index, FramePtr frame)
+{
+  foreach (Segment* s, segments_) {
+    if (index >= s->start && index < s->end) {
+      s->lock.lock();
+
+      s->pending.insert(index, frame);
+
+      bool start_encoding = !s->busy;
+      s->busy = true;
+
+      s->lock.unlock();
+
+      if (start_encoding) {
+        segment_group_.Run([this, s]{
+          EncodeSegmentFrames(s);
+        });
+      }
+
+      break;
+    }
+  }
+}
+
+void ExportTask::EncodeSegmentFrames(Segment *segment)
+{
+  forever {
+    segment->lock.lock();
+
+    FramePtr frame = IsCancelled() ? nullptr : segment->pending.take(segment->next);
+
+    if (!frame) {
+      // Wait for the renderer to give us the next frame
+      segment->busy = false;
+      segment->lock.unlock();
+      break;
+    }
+
+    int64_t index = segment->next;
+    segment->next++;
+
+    segment->lock.unlock();
+
+    // Each segment file starts at 0, they're offset when joining
+    HandleWriteResult(segment->encoder->WriteFrame(frame, Timecode::timestamp_to_time(index - segment->start,
+                                                                                      viewer()->video_params().time_base())));
+  }
+}
+
+bool ExportTask::FinishSegments(Output &output, bool join)
+{
+  QStringList filenames;
+  QVector<int64_t> frame_counts;
+  bool all_frames_encoded = true;
+
+  foreach (Segment* s, segments_) {
+    if (s->encoder) {
+      s->encoder->Close();
+      all_frames_encoded &= !s->encoder->HasError();
+      filenames.append(s->encoder->params().filename());
+      delete s->encoder;
+    }
+
+    frame_counts.append(s->end - s->start);
+    all_frames_encoded &= (s->next == s->end);
+
+    delete s;
+  }
+  segments_.clear();
+
+  QString audio_filename;
+
+  if (segment_audio_encoder_) {
+    segment_audio_encoder_->Close();
+    all_frames_encoded &= !segment_audio_encoder_->HasError();
+    audio_filename = segment_audio_encoder_->params().filename();
+    delete segment_audio_encoder_;
+    segment_audio_encoder_ = nullptr;
+  }
+
+  bool success = false;
+
+  if (join && all_frames_encoded && filenames.size() == frame_counts.size()) {
+    success = output.encoder->JoinSegments(filenames, frame_counts, audio_filename);
+  }
+
+  foreach (const QString& f, filenames) {
+    QFile::remove(f);
+  }
+
+  if (!audio_filename.isEmpty()) {
+    QFile::remove(audio_filename);
+  }
+
+  return success;
+}
+
+VideoParams ExportTask::GetRenderVideoParams(ViewerOutput *viewer, const QVector<ExportParams> &params)
+{
+  foreach (const ExportParams& p, params) {
+    if (p.video_enabled()) {
+      VideoParams vp = p.video_params();
+
+      if (!AllOutputsRenderSame(params)) {
+        // Master render, use the sequence's resolution and enough precision for every output
+        vp.set_width(viewer->video_params().width());
+        vp.set_height(viewer->video_params().height());
+        vp.set_format(VideoParams::kFormatFloat16);
+      }
+
+      return vp;
+    }
+  }
+
+  return params.first().video_params();
+}
+
+AudioParams ExportTask::GetRenderAudioParams(const QVector<ExportParams> &params)
+{
+  // Encoders resample audio themselves, so any output's parameters will do
+  foreach (const ExportParams& p, params) {
+    if (p.audio_enabled()) {
+      return p.audio_params();
+    }
+  }
+
+  return params.first().audio_params();
+}
+
+bool ExportTask::AllOutputsRenderSame(const QVector<ExportParams> &params)
+{
+  for (int i=1; i<params.size(); i++) {
+    if (!params.at(i).RendersSameAs(params.first())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+FramePtr ExportTask::ScaleFrame(const Frame *frame, const VideoParams &dest, ExportParams::VideoScalingMethod method)
+{
+  VideoParams scaled_params = dest;
+  scaled_params.set_format(frame->format());
+  scaled_params.set_channel_count(frame->channel_count());
+
+  FramePtr scaled = Frame::Create();
+  scaled->set_video_params(scaled_params);
+  scaled->set_timestamp(frame->timestamp());
+  scaled->allocate();
+
+  OIIO::TypeDesc::BASETYPE type = OIIOUtils::GetOIIOBaseTypeFromFormat(frame->format());
+
+  OIIO::ImageBuf src(OIIO::ImageSpec(frame->width(), frame->height(), frame->channel_count(), type));
+  OIIOUtils::FrameToBuffer(frame, &src);
+
+  OIIO::ImageBuf dst(OIIO::ImageSpec(scaled->width(), scaled->height(), scaled->channel_count(), type));
+
+  if (frame->width() == scaled->width() && frame->height() == scaled->height()) {
+    dst.copy_pixels(src);
+  } else {
+    // Determine the size of the image inside the frame, this matches GenerateMatrix()
+    int image_width = scaled->width();
+    int image_height = scaled->height();
+
+    if (method != ExportParams::kStretch) {
+      double x_scale = double(scaled->width()) / double(frame->width());
+      double y_scale = double(scaled->height()) / double(frame->height());
+      double scale = (method == ExportParams::kFit) ? qMin(x_scale, y_scale) : qMax(x_scale, y_scale);
+
+      image_width = qMax(1, qRound(frame->width() * scale));
+      image_height = qMax(1, qRound(frame->height() * scale));
+    }
+
+    OIIO::ImageBuf resized(OIIO::ImageSpec(image_width, image_height, frame->channel_count(), type));
+    OIIO::ImageBufAlgo::resize(resized, src);
+
+    // Center it, either letterboxing (fit) or cropping (fill)
+    int x_offset = (scaled->width() - image_width) / 2;
+    int y_offset = (scaled->height() - image_height) / 2;
+
+    OIIO::ROI src_roi(qMax(0, -x_offset), qMax(0, -x_offset) + qMin(image_width, scaled->width()),
+                      qMax(0, -y_offset), qMax(0, -y_offset) + qMin(image_height, scaled->height()),
+                      0, 1,
+                      0, frame->channel_count());
+
+    OIIO::ImageBufAlgo::zero(dst);
+    OIIO::ImageBufAlgo::paste(dst, qMax(0, x_offset), qMax(0, y_offset), 0, 0, resized, src_roi);
+  }
+
+  OIIOUtils::BufferToFrame(&dst, scaled.get());
+
+  return scaled;
+}
+
+FramePtr ExportTask::ConvertFrameFormat(const Frame *frame, VideoParams::Format format)
+{
+  VideoParams converted_params = frame->video_params();
+  converted_params.set_format(format);
+
+  FramePtr converted = Frame::Create();
+  converted->set_video_params(converted_params);
+  converted->set_timestamp(frame->timestamp());
+  converted->allocate();
+
+  OIIO::ImageBuf src(OIIO::ImageSpec(frame->width(), frame->height(), frame->channel_count(),
+                                     OIIOUtils::GetOIIOBaseTypeFromFormat(frame->format())));
+  OIIOUtils::FrameToBuffer(frame, &src);
+
+  OIIO::ImageBuf dst(OIIO::ImageSpec(converted->width(), converted->height(), converted->channel_count(),
+                                     OIIOUtils::GetOIIOBaseTypeFromFormat(format)));
+  dst.copy_pixels(src);
+
+  OIIOUtils::BufferToFrame(&dst, converted.get());
+
+  return converted;
+}
+
+void ExportTask::ColorManageFrame(ColorProcessorPtr processor, Frame *frame)
+{
+  if (frame->channel_count() != VideoParams::kRGBAChannelCount) {
+    // No alpha to de-associate
+    processor->ConvertFrame(frame);
+    return;
+  }
+
+  OIIO::ImageBuf buf(OIIO::ImageSpec(frame->width(), frame->height(), frame->channel_count(),
+                                     OIIOUtils::GetOIIOBaseTypeFromFormat(frame->format())));
+  OIIOUtils::FrameToBuffer(frame, &buf);
+  OIIO::ImageBufAlgo::unpremult(buf, buf);
+  OIIOUtils::BufferToFrame(&buf, frame);
+
+  processor->ConvertFrame(frame);
+
+  OIIOUtils::FrameToBuffer(frame, &buf);
+  OIIO::ImageBufAlgo::premult(buf, buf);
+  OIIOUtils::BufferToFrame(&buf, frame);
+}
+
+bool ExportTask::WriteMasterFrame(const Output &output, FramePtr frame, const rational &time)
+{
+  // Get a copy of the frame at this output's size, since it's shared with the other outputs
+  frame = ScaleFrame(frame.get(), output.params.video_params(), output.params.video_scaling_method());
+
+  ColorManageFrame(output.color_processor, frame.get());
+
+  // The master render is always half float, which may not be what this encoder wants
+  VideoParams::Format desired_format = output.encoder->GetDesiredPixelFormat();
+  if (desired_format != VideoParams::kFormatInvalid && frame->format() != desired_format) {
+    frame = ConvertFrameFormat(frame.get(), desired_format);
+  }
+
+  return output.encoder->WriteFrame(frame, time);
+}
+
+void ExportTask::HandleWriteResult(bool success)
+{
+  if (!success && write_failed_.testAndSetOrdered(0, 1)) {
+    // No point rendering frames we can't write
+    Cancel();
+  }
+}
+
+bool ExportTask::CloseEncoders(bool remove_files)
+{
+  bool success = true;
+
+  // Close all of them first, so a failure in any of them removes every file
+  for (int i=0; i<outputs_.size(); i++) {
+    Output& o = outputs_[i];
+
+    if (o.encoder) {
+      o.encoder->Close();
+      success &= !o.encoder->HasError();
+    }
+  }
+
+  for (int i=0; i<outputs_.size(); i++) {
+    Output& o = outputs_[i];
+
+    if (o.encoder) {
+      o.written_filenames = o.encoder->GetWrittenFilenames(o.params.filename());
+      o.real_filenames = o.encoder->GetWrittenFilenames(o.real_filename);
+
+      delete o.encoder;
+      o.encoder = nullptr;
+
+      if (remove_files || !success) {
+        foreach (const QString& f, o.written_filenames) {
+          QFile::remove(f);
+        }
+      }
+    }
+  }
+
+  return success;
+}
+
 void ExportTask::FrameDownloaded(FramePtr f, const QByteArray &hash, const QVector<rational> &times, qint64 job_time)
 {
   Q_UNUSED(job_time)
   Q_UNUSED(hash)
 
+  if (IsCancelled()) {
+    // Includes failing to write an earlier frame, encoders may not take any more
+    return;
+  }
+
   foreach (const rational& t, times) {
     rational actual_time = t;
 
-    if (params_.has_custom_range()) {
-      actual_time -= params_.custom_range().in();
+    if (outputs_.first().params.has_custom_range()) {
+      actual_time -= outputs_.first().params.custom_range().in();
     }
 
-    time_map_.insert(actual_time, f);
+    if (!segments_.isEmpty()) {
+      // Segments don't need to wait for each other, so send it straight to its segment's encoder
+      QueueSegmentFrame(Timecode::time_to_timestamp(actual_time, viewer()->video_params().time_base()), f);
+    } else if (!ordered_frames_) {
+      // Encoders will take frames in any order, so no need to wait for the ones before this
+      WriteFrameToOutputs(f, actual_time);
+    } else {
+      time_map_.insert(actual_time, f);
+    }
+  }
+
+  if (!segments_.isEmpty() || !ordered_frames_) {
+    return;
   }
 
   forever {
@@ -170,20 +672,43 @@ void ExportTask::FrameDownloaded(FramePtr f, const QByteArray &hash, const QVect
 
     // Unfortunately this can't be done in another thread since the frames need to be sent
     // one after the other chronologically.
-    encoder_->WriteFrame(time_map_.take(real_time), real_time);
+    WriteFrameToOutputs(time_map_.take(real_time), real_time);
 
     frame_time_++;
   }
 }
 
+void ExportTask::WriteFrameToOutputs(FramePtr frame, const rational &time)
+{
+  if (master_render_) {
+    // Each output converts and encodes independently, so we can do them all at once
+    TaskGroup group;
+
+    foreach (const Output& o, outputs_) {
+      if (o.params.video_enabled()) {
+        const Output* output = &o;
+        group.Run([this, output, frame, time]{
+          HandleWriteResult(WriteMasterFrame(*output, frame, time));
+        });
+      }
+    }
+
+    group.Wait();
+  } else {
+    foreach (const Output& o, outputs_) {
+      HandleWriteResult(o.encoder->WriteFrame(frame, time));
+    }
+  }
+}
+
 void ExportTask::AudioDownloaded(const TimeRange &range, SampleBufferPtr samples, qint64 job_time)
 {
   Q_UNUSED(job_time)
 
   TimeRange adjusted_range = range;
 
-  if (params_.has_custom_range()) {
-    adjusted_range -= params_.custom_range().in();
+  if (outputs_.first().params.has_custom_range()) {
+    adjusted_range -= outputs_.first().params.custom_range().in();
   }
 
   audio_data_.WritePCM(adjusted_range, samples, QDateTime::currentMSecsSinceEpoch());
@@ -26,6 +26,7 @@
 #include "render/colorprocessor.h"
 #include "task/render/render.h"
 #include "task/task.h"
+#include "threading/workstealingexecutor.h"
 
 namespace olive {
 
@@ -35,6 +36,17 @@ class ExportTask : public RenderTask
 public:
   ExportTask(ViewerOutput *viewer_node, ColorManager *color_manager, const ExportParams &params);
 
+  /**
+   * @brief Export several files from one render
+   *
+   * Every set of parameters must be able to share a render (see
+   * ExportParams::CanShareRenderWith()). Each frame is rendered once and sent to every file's
+   * encoder. If the outputs don't all render the same way, the sequence is rendered at its own
+   * resolution in the reference color space and each output's scaling and color transform are
+   * applied separately.
+   */
+  ExportTask(ViewerOutput *viewer_node, ColorManager *color_manager, const QVector<ExportParams> &params);
+
 protected:
   virtual bool Run() override;
 
@@ -48,13 +60,147 @@ protected:
   }
 
 private:
+  struct Output {
+    ExportParams params;
+
+    /// Filename to move the finished file to, since we encode to a temporary file if it exists
+    QString real_filename;
+
+    /// Files the encoder wrote and the names to move each of them to, filled in by CloseEncoders()
+    QStringList written_filenames;
+    QStringList real_filenames;
+
+    Encoder* encoder;
+
+    /// Converts from the reference space to this output's color transform when using a master render
+    ColorProcessorPtr color_processor;
+  };
+
+  /**
+   * @brief Determine the parameters to render with
+   *
+   * This is the first output's parameters if they all render the same way, or a master at the
+   * sequence's resolution otherwise.
+   */
+  static VideoParams GetRenderVideoParams(ViewerOutput* viewer, const QVector<ExportParams>& params);
+  static AudioParams GetRenderAudioParams(const QVector<ExportParams>& params);
+
+  static bool AllOutputsRenderSame(const QVector<ExportParams>& params);
+
+  /**
+   * @brief Scale a frame to the size of `dest` using `method` to handle aspect ratio differences
+   *
+   * Always returns a new frame so the result can be modified without affecting `frame`.
+   */
+  static FramePtr ScaleFrame(const Frame* frame, const VideoParams& dest, ExportParams::VideoScalingMethod method);
+
+  /**
+   * @brief Return a copy of `frame` converted to pixel format `format`
+   */
+  static FramePtr ConvertFrameFormat(const Frame* frame, VideoParams::Format format);
+
+  /**
+   * @brief Color manage a premultiplied frame in place the same way Renderer::BlitColorManaged() does
+   *
+   * Alpha is de-associated before the transform and re-associated after it, so edges match what
+   * the same output would look like rendered on its own.
+   */
+  static void ColorManageFrame(ColorProcessorPtr processor, Frame* frame);
+
+  /**
+   * @brief Convert a frame from the master render for an output and encode it
+   */
+  bool WriteMasterFrame(const Output& output, FramePtr frame, const rational& time);
+
+  /**
+   * @brief Send a frame to every output's encoder
+   */
+  void WriteFrameToOutputs(FramePtr frame, const rational& time);
+
+  /**
+   * @brief Stop the export if an encoder failed to write a frame
+   *
+   * This function is thread safe.
+   */
+  void HandleWriteResult(bool success);
+
+  /**
+   * @brief Close every encoder, removing their files if `remove_files` is TRUE
+   *
+   * @return
+   *
+   * FALSE if any encoder reported an error while closing (e.g. from writing in the background),
+   * in which case the files are removed regardless.
+   */
+  bool CloseEncoders(bool remove_files);
+
+  /**
+   * @brief A part of the video encoded separately from the rest
+   *
+   * If the encoder can join files (e.g. intra-only codecs), the video is split into contiguous
+   * segments, one per thread, that are each encoded by their own encoder at the same time and
+   * then joined into the final file.
+   */
+  struct Segment {
+    Encoder* encoder;
+
+    /// Range of frames in this segment, end is exclusive
+    int64_t start;
+    int64_t end;
+
+    /// Next frame the encoder is waiting for
+    int64_t next;
+
+    /// Frames that have been rendered but not encoded yet
+    QMap<int64_t, FramePtr> pending;
+
+    /// Whether a thread is currently encoding this segment's pending frames
+    bool busy;
+
+    QMutex lock;
+  };
+
+  int GetSegmentCount(int64_t frame_count) const;
+
+  /**
+   * @brief Generate an unused filename next to `filename` to encode a part of it to
+   */
+  static QString GetPartFilename(const QString& filename, const QString& part);
+
+  bool OpenSegments(const Output& output, int count, int64_t frame_count);
+
+  void QueueSegmentFrame(int64_t index, FramePtr frame);
+
+  void EncodeSegmentFrames(Segment* segment);
+
+  /**
+   * @brief Close segment encoders and, if `join` is TRUE, join them into the output's file
+   *
+   * Segment files are always removed afterwards.
+   */
+  bool FinishSegments(Output& output, bool join);
+
+  static const int kMinimumSegmentLength;
+
   QHash<rational, FramePtr> time_map_;
 
   ColorManager* color_manager_;
 
-  ExportParams params_;
+  QVector<Output> outputs_;
+
+  bool master_render_;
+
+  /// Whether any encoder needs frames in chronological order
+  bool ordered_frames_;
+
+  QVector<Segment*> segments_;
+
+  Encoder* segment_audio_encoder_;
+
+  TaskGroup segment_group_;
 
-  Encoder* encoder_;
+  /// Set if any frame failed to be written, the export is cancelled when this happens
+  QAtomicInt write_failed_;
 
   ColorProcessorPtr color_processor_;
 
@@ -74,6 +74,52 @@ void ExportParams::set_color_transform(const ColorTransform &color_transform)
   color_transform_ = color_transform;
 }
 
+bool ExportParams::RendersSameAs(const ExportParams &other) const
+{
+  if (video_enabled() != other.video_enabled()
+      || audio_enabled() != other.audio_enabled()
+      || has_custom_range_ != other.has_custom_range_
+      || (has_custom_range_ && custom_range_ != other.custom_range_)) {
+    return false;
+  }
+
+  if (video_enabled()
+      && (video_params() != other.video_params()
+          || video_scaling_method_ != other.video_scaling_method_
+          || color_transform_.is_display() != other.color_transform_.is_display()
+          || color_transform_.output() != other.color_transform_.output()
+          || color_transform_.view() != other.color_transform_.view()
+          || color_transform_.look() != other.color_transform_.look()
+          // The codec and pixel format determine which format the encoder wants frames in
+          || video_codec() != other.video_codec()
+          || video_pix_fmt() != other.video_pix_fmt())) {
+    return false;
+  }
+
+  if (audio_enabled() && audio_params() != other.audio_params()) {
+    return false;
+  }
+
+  return true;
+}
+
+bool ExportParams::CanShareRenderWith(const ExportParams &other) const
+{
+  if (has_custom_range_ != other.has_custom_range_
+      || (has_custom_range_ && custom_range_ != other.custom_range_)) {
+    return false;
+  }
+
+  // Frames are rendered at one time base, so outputs at different frame rates need their own render
+  if (video_enabled() && other.video_enabled()
+      && (video_params().interlacing() != other.video_params().interlacing()
+          || video_params().time_base() != other.video_params().time_base())) {
+    return false;
+  }
+
+  return true;
+}
+
 QMatrix4x4 ExportParams::GenerateMatrix(ExportParams::VideoScalingMethod method,
                                         int source_width, int source_height,
                                         int dest_width, int dest_height)
@@ -52,6 +52,22 @@ public:
   const ColorTransform& color_transform() const;
   void set_color_transform(const ColorTransform& color_transform);
 
+  /**
+   * @brief Returns whether `other` needs exactly the same frames and audio rendered as this
+   *
+   * If so, both can be encoded from one render.
+   */
+  bool RendersSameAs(const ExportParams& other) const;
+
+  /**
+   * @brief Returns whether `other` can be encoded from the same render as this
+   *
+   * This is looser than RendersSameAs(), outputs only have to cover the same frames at the same
+   * frame rate. Anything else (size, scaling, color transform, pixel format, audio format) can be
+   * converted for each output from a master render.
+   */
+  bool CanShareRenderWith(const ExportParams& other) const;
+
   static QMatrix4x4 GenerateMatrix(ExportParams::VideoScalingMethod method,
                                    int source_width, int source_height,
                                    int dest_width, int dest_height);
@@ -0,0 +1,234 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "renderqueue.h"
+
+#include <QThread>
+
+#include "export.h"
+#include "task/taskmanager.h"
+
+namespace olive {
+
+RenderQueue* RenderQueue::instance_ = nullptr;
+
+RenderQueue::RenderQueue() :
+  next_id_(0),
+  max_running_jobs_(1),
+  max_frames_per_job_(QThread::idealThreadCount() * 2),
+  paused_(false)
+{
+  connect(TaskManager::instance(), &TaskManager::TaskRemoved, this, &RenderQueue::TaskRemoved);
+  connect(TaskManager::instance(), &TaskManager::TaskFailed, this, &RenderQueue::TaskFailed);
+}
+
+void RenderQueue::CreateInstance()
+{
+  instance_ = new RenderQueue();
+}
+
+void RenderQueue::DestroyInstance()
+{
+  delete instance_;
+  instance_ = nullptr;
+}
+
+RenderQueue *RenderQueue::instance()
+{
+  return instance_;
+}
+
+int RenderQueue::AddJob(ViewerOutput *viewer, ColorManager *color_manager, const ExportParams &params, int priority)
+{
+  int id = next_id_;
+  next_id_++;
+
+  jobs_.append({id, viewer, color_manager, params, priority, kJobQueued});
+
+  // Don't keep jobs around for sequences that no longer exist
+  connect(viewer, &QObject::destroyed, this, &RenderQueue::ViewerDestroyed, Qt::UniqueConnection);
+
+  emit JobsChanged();
+
+  StartNextJobs();
+
+  return id;
+}
+
+bool RenderQueue::RemoveJob(int id)
+{
+  int index = IndexOfJob(id);
+
+  if (index == -1 || jobs_.at(index).state == kJobRunning) {
+    return false;
+  }
+
+  jobs_.removeAt(index);
+
+  emit JobsChanged();
+
+  return true;
+}
+
+void RenderQueue::SetJobPriority(int id, int priority)
+{
+  int index = IndexOfJob(id);
+
+  if (index != -1) {
+    jobs_[index].priority = priority;
+
+    emit JobsChanged();
+  }
+}
+
+void RenderQueue::SetMaximumRunningJobs(int max)
+{
+  max_running_jobs_ = max;
+
+  StartNextJobs();
+}
+
+void RenderQueue::SetMaximumFramesPerJob(int max)
+{
+  max_frames_per_job_ = max;
+
+  for (auto it=running_.cbegin(); it!=running_.cend(); it++) {
+    static_cast<RenderTask*>(it.key())->SetMaximumRunningTickets(max_frames_per_job_);
+  }
+}
+
+void RenderQueue::SetPaused(bool paused)
+{
+  paused_ = paused;
+
+  for (auto it=running_.cbegin(); it!=running_.cend(); it++) {
+    static_cast<RenderTask*>(it.key())->SetPaused(paused_);
+  }
+
+  if (!paused_) {
+    StartNextJobs();
+  }
+}
+
+int RenderQueue::IndexOfJob(int id) const
+{
+  for (int i=0; i<jobs_.size(); i++) {
+    if (jobs_.at(i).id == id) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+void RenderQueue::StartNextJobs()
+{
+  bool changed = false;
+
+  while (!paused_ && running_.size() < max_running_jobs_) {
+    // Find the highest priority job, favoring whichever was queued first
+    int next = -1;
+
+    for (int i=0; i<jobs_.size(); i++) {
+      if (jobs_.at(i).state == kJobQueued
+          && (next == -1 || jobs_.at(i).priority > jobs_.at(next).priority)) {
+        next = i;
+      }
+    }
+
+    if (next == -1) {
+      break;
+    }
+
+    // Start any other queued jobs that would render the exact same frames alongside it
+    const Job& first = jobs_.at(next);
+    QVector<ExportParams> params;
+    QVector<int> ids;
+
+    for (int i=0; i<jobs_.size(); i++) {
+      Job& j = jobs_[i];
+
+      if (j.state == kJobQueued
+          && j.viewer == first.viewer
+          && j.color_manager == first.color_manager
+          && (i == next || j.params.CanShareRenderWith(first.params))) {
+        params.append(j.params);
+        ids.append(j.id);
+        j.state = kJobRunning;
+      }
+    }
+
+    ExportTask* task = new ExportTask(jobs_.at(next).viewer, jobs_.at(next).color_manager, params);
+    task->SetMaximumRunningTickets(max_frames_per_job_);
+    running_.insert(task, ids);
+
+    TaskManager::instance()->AddTask(task);
+
+    changed = true;
+  }
+
+  if (changed) {
+    emit JobsChanged();
+  }
+}
+
+void RenderQueue::SetTaskJobsState(Task *task, JobState state)
+{
+  QVector<int> ids = running_.take(task);
+
+  foreach (int id, ids) {
+    int index = IndexOfJob(id);
+
+    if (index != -1) {
+      jobs_[index].state = state;
+    }
+  }
+
+  emit JobsChanged();
+
+  StartNextJobs();
+}
+
+void RenderQueue::TaskRemoved(Task *task)
+{
+  if (running_.contains(task)) {
+    SetTaskJobsState(task, task->IsCancelled() ? kJobFailed : kJobFinished);
+  }
+}
+
+void RenderQueue::TaskFailed(Task *task)
+{
+  if (running_.contains(task)) {
+    SetTaskJobsState(task, kJobFailed);
+  }
+}
+
+void RenderQueue::ViewerDestroyed(QObject *viewer)
+{
+  for (int i=jobs_.size()-1; i>=0; i--) {
+    if (jobs_.at(i).viewer == viewer && jobs_.at(i).state != kJobRunning) {
+      jobs_.removeAt(i);
+    }
+  }
+
+  emit JobsChanged();
+}
+
+}
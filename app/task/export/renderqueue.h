@@ -0,0 +1,157 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <QObject>
+
+#include "exportparams.h"
+#include "node/output/viewer/viewer.h"
+#include "render/colormanager.h"
+#include "task/task.h"
+
+namespace olive {
+
+/**
+ * @brief A queue of exports that run in the background one after another
+ *
+ * Jobs are started in priority order (oldest first for equal priority), with no more than
+ * GetMaximumRunningJobs() running at once, and each job only keeps GetMaximumFramesPerJob()
+ * frames rendering at a time so that running jobs share the renderer rather than starving each
+ * other.
+ *
+ * When a job starts, any other queued jobs for the same sequence covering the same frames (e.g. a
+ * master, a web version and an audio-only file) are started with it as one ExportTask. Every
+ * unique frame is then rendered once and converted for each job's encoder, rather than being
+ * rendered again for each file.
+ */
+class RenderQueue : public QObject
+{
+  Q_OBJECT
+public:
+  enum JobState {
+    kJobQueued,
+    kJobRunning,
+    kJobFinished,
+    kJobFailed
+  };
+
+  struct Job {
+    int id;
+    ViewerOutput* viewer;
+    ColorManager* color_manager;
+    ExportParams params;
+    int priority;
+    JobState state;
+  };
+
+  RenderQueue();
+
+  static void CreateInstance();
+
+  static void DestroyInstance();
+
+  static RenderQueue* instance();
+
+  /**
+   * @brief Add an export to the queue
+   *
+   * @return
+   *
+   * An ID that can be used to refer to this job later.
+   */
+  int AddJob(ViewerOutput* viewer, ColorManager* color_manager, const ExportParams& params, int priority = 0);
+
+  /**
+   * @brief Remove a job from the queue
+   *
+   * Jobs that are already running can't be removed, they should be cancelled through TaskManager
+   * instead.
+   */
+  bool RemoveJob(int id);
+
+  void SetJobPriority(int id, int priority);
+
+  const QVector<Job>& GetJobs() const
+  {
+    return jobs_;
+  }
+
+  int GetMaximumRunningJobs() const
+  {
+    return max_running_jobs_;
+  }
+
+  void SetMaximumRunningJobs(int max);
+
+  int GetMaximumFramesPerJob() const
+  {
+    return max_frames_per_job_;
+  }
+
+  void SetMaximumFramesPerJob(int max);
+
+  bool IsPaused() const
+  {
+    return paused_;
+  }
+
+  /**
+   * @brief Stop starting new jobs and pause rendering in the running ones
+   */
+  void SetPaused(bool paused);
+
+signals:
+  void JobsChanged();
+
+private:
+  int IndexOfJob(int id) const;
+
+  void StartNextJobs();
+
+  void SetTaskJobsState(Task* task, JobState state);
+
+  static RenderQueue* instance_;
+
+  QVector<Job> jobs_;
+
+  QHash<Task*, QVector<int> > running_;
+
+  int next_id_;
+
+  int max_running_jobs_;
+
+  int max_frames_per_job_;
+
+  bool paused_;
+
+private slots:
+  void TaskRemoved(Task* task);
+
+  void TaskFailed(Task* task);
+
+  void ViewerDestroyed(QObject* viewer);
+
+};
+
+}
+
+#endif // RENDERQUEUE_H
@@ -36,6 +36,8 @@ PreCacheTask::PreCacheTask(VideoStream *footage, Sequence* sequence) :
 
   NodeParam::ConnectEdge(video_node_->output(), viewer()->texture_input());
 
+  SetRenderPriority(RenderTicket::kPriorityCache);
+
   SetTitle(tr("Pre-caching %1:%2").arg(footage->footage()->filename(),
                                        QString::number(footage->index())));
 }
@@ -0,0 +1,264 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "projectjournal.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSet>
+#include <QtConcurrent/QtConcurrent>
+
+#include "common/filefunctions.h"
+#include "core.h"
+
+namespace olive {
+
+const QByteArray ProjectJournal::kMagic = QByteArrayLiteral("OLVJ");
+const quint32 ProjectJournal::kFormatVersion = 1;
+
+// Compact once the journal is this many times larger than its live records
+const qint64 kCompactRatio = 4;
+
+// Don't bother compacting journals smaller than this
+const qint64 kCompactMinimumSize = 4194304;
+
+ProjectJournal::ProjectJournal(const QString &filename, const QString& project_url) :
+  filename_(filename),
+  project_url_(project_url),
+  saved_project_generation_(0),
+  has_snapshot_(false),
+  live_size_(0),
+  file_started_(false)
+{
+}
+
+ProjectJournal::~ProjectJournal()
+{
+  WaitForFinished();
+}
+
+bool ProjectJournal::Write(Project *project)
+{
+  if (pending_write_.isRunning()) {
+    return false;
+  }
+
+  if (pending_write_.resultCount() > 0 && !pending_write_.result()) {
+    // The last write's records never made it to disk and the journal may be incomplete, so forget
+    // what was saved and start the journal over with everything
+    saved_sequence_generations_.clear();
+    saved_project_generation_ = 0;
+    has_snapshot_ = false;
+  }
+
+  QVector<Record> records = Snapshot(project, !has_snapshot_);
+
+  if (records.isEmpty()) {
+    // The project was modified in a way that isn't tracked by dirty generations, so play it safe
+    // and write everything
+    records = Snapshot(project, true);
+  }
+
+  // The layout is small and isn't tracked, so it accompanies every write
+  records.append({ProjectSaveBinaryTask::kChunkLayout, 0, ProjectSaveBinaryTask::SerializeLayoutChunk()});
+
+  has_snapshot_ = true;
+
+  pending_write_ = QtConcurrent::run(this, &ProjectJournal::Append, records);
+
+  return true;
+}
+
+void ProjectJournal::WaitForFinished()
+{
+  pending_write_.waitForFinished();
+}
+
+void ProjectJournal::Remove()
+{
+  WaitForFinished();
+
+  QFile::remove(filename_);
+}
+
+QVector<ProjectJournal::Record> ProjectJournal::Snapshot(Project *project, bool everything)
+{
+  QVector<Record> records;
+  QSet<quint64> current_sequences;
+
+  foreach (Item* sequence, project->get_items_of_type(Item::kSequence)) {
+    quint64 key = reinterpret_cast<quintptr>(sequence);
+
+    // Take the generation before serializing so that nothing is missed
+    quint64 generation = sequence->dirty_generation();
+
+    current_sequences.insert(key);
+
+    if (everything
+        || !saved_sequence_generations_.contains(key)
+        || generation > saved_sequence_generations_.value(key)) {
+      records.append({ProjectSaveBinaryTask::kChunkSequence, key, ProjectSaveBinaryTask::SerializeSequenceChunk(sequence)});
+      saved_sequence_generations_.insert(key, generation);
+    }
+  }
+
+  // Record any sequences that have been deleted
+  QHash<quint64, quint64>::iterator it = saved_sequence_generations_.begin();
+  while (it != saved_sequence_generations_.end()) {
+    if (current_sequences.contains(it.key())) {
+      it++;
+    } else {
+      records.append({ProjectSaveBinaryTask::kChunkSequence, it.key(), QByteArray()});
+      it = saved_sequence_generations_.erase(it);
+    }
+  }
+
+  quint64 project_generation = GetProjectChunkGeneration(project);
+
+  if (everything || project_generation > saved_project_generation_) {
+    records.append({ProjectSaveBinaryTask::kChunkProject, 0, ProjectSaveBinaryTask::SerializeProjectChunk(project)});
+    saved_project_generation_ = project_generation;
+  }
+
+  return records;
+}
+
+bool ProjectJournal::Append(QVector<Record> records)
+{
+  for (int i=0;i<records.size();i++) {
+    if (!records.at(i).data.isEmpty()) {
+      records[i].data = ProjectSaveBinaryTask::CompressChunk(records.at(i).data);
+    }
+  }
+
+  QFile journal(filename_);
+
+  // Each session starts its journal from scratch, after that it's only ever appended to. If a
+  // write fails, the file is started over too, since it may end in a partial record.
+  bool start_file = !file_started_;
+  file_started_ = false;
+
+  if (!journal.open(start_file ? (QFile::WriteOnly | QFile::Truncate) : (QFile::WriteOnly | QFile::Append))) {
+    qWarning() << "Failed to open autorecovery journal" << filename_;
+    return false;
+  }
+
+  QDataStream ds(&journal);
+  ds.setVersion(QDataStream::Qt_5_6);
+
+  if (start_file) {
+    live_records_.clear();
+    live_size_ = 0;
+
+    WriteHeader(&ds);
+  }
+
+  foreach (const Record& record, records) {
+    WriteRecord(&ds, record);
+
+    RecordKey key(record.type, record.key);
+
+    live_size_ -= live_records_.value(key).size();
+
+    if (record.data.isEmpty()) {
+      live_records_.remove(key);
+    } else {
+      live_records_.insert(key, record.data);
+      live_size_ += record.data.size();
+    }
+  }
+
+  if (ds.status() != QDataStream::Ok || !journal.flush()) {
+    qWarning() << "Failed to write autorecovery journal" << filename_;
+    return false;
+  }
+
+  file_started_ = true;
+
+  qint64 journal_size = journal.size();
+
+  journal.close();
+
+  if (journal_size > kCompactMinimumSize && journal_size > live_size_ * kCompactRatio) {
+    Compact();
+  }
+
+  return true;
+}
+
+void ProjectJournal::Compact()
+{
+  QString temp_fn = FileFunctions::GetSafeTemporaryFilename(filename_);
+
+  QFile compacted(temp_fn);
+
+  if (!compacted.open(QFile::WriteOnly)) {
+    return;
+  }
+
+  QDataStream ds(&compacted);
+  ds.setVersion(QDataStream::Qt_5_6);
+
+  WriteHeader(&ds);
+
+  for (QMap<RecordKey, QByteArray>::const_iterator it=live_records_.constBegin(); it!=live_records_.constEnd(); it++) {
+    WriteRecord(&ds, {static_cast<ProjectSaveBinaryTask::ChunkType>(it.key().first), it.key().second, it.value()});
+  }
+
+  compacted.close();
+
+  if (ds.status() != QDataStream::Ok || !FileFunctions::RenameFileAllowOverwrite(temp_fn, filename_)) {
+    QFile::remove(temp_fn);
+  }
+}
+
+void ProjectJournal::WriteHeader(QDataStream *ds) const
+{
+  ds->writeRawData(kMagic.constData(), kMagic.size());
+
+  *ds << kFormatVersion;
+  *ds << quint32(Core::kProjectVersion);
+  *ds << project_url_;
+}
+
+void ProjectJournal::WriteRecord(QDataStream *ds, const ProjectJournal::Record &record)
+{
+  *ds << quint8(record.type);
+  *ds << record.key;
+  *ds << record.data;
+}
+
+quint64 ProjectJournal::GetProjectChunkGeneration(Project *project)
+{
+  // The project chunk holds every item that isn't a sequence
+  quint64 generation = project->root()->dirty_generation();
+
+  foreach (Item* item, project->get_items_of_type(Item::kFolder)) {
+    generation = qMax(generation, item->dirty_generation());
+  }
+
+  foreach (Item* item, project->get_items_of_type(Item::kFootage)) {
+    generation = qMax(generation, item->dirty_generation());
+  }
+
+  return generation;
+}
+
+}
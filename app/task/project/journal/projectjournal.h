@@ -0,0 +1,132 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef PROJECTJOURNAL_H
+#define PROJECTJOURNAL_H
+
+#include <QFuture>
+#include <QHash>
+#include <QMap>
+
+#include "project/project.h"
+#include "task/project/savebinary/savebinary.h"
+
+namespace olive {
+
+/**
+ * @brief Append-only autorecovery journal of a project
+ *
+ * Rather than re-saving the whole project, each Write() only serializes the parts of the project
+ * (as binary project chunks, \see ProjectSaveBinaryTask) whose dirty generation has changed since
+ * the last write. Serializing happens on the main thread, which produces an immutable snapshot
+ * of those chunks. Compressing and appending them to the journal happens in the background.
+ *
+ * Later records for the same chunk replace earlier ones when the journal is loaded by
+ * ProjectLoadBinaryTask. Once the journal is mostly stale records, it's compacted down to the
+ * latest record of each chunk.
+ */
+class ProjectJournal
+{
+public:
+  ProjectJournal(const QString& filename, const QString& project_url);
+
+  ~ProjectJournal();
+
+  DISABLE_COPY_MOVE(ProjectJournal)
+
+  /**
+   * @brief Bytes at the start of every journal
+   */
+  static const QByteArray kMagic;
+
+  static const quint32 kFormatVersion;
+
+  const QString& filename() const
+  {
+    return filename_;
+  }
+
+  /**
+   * @brief Snapshot the changed parts of `project` and append them to the journal in the background
+   *
+   * Must be called from the main thread.
+   *
+   * @return
+   *
+   * FALSE if the previous write is still running, in which case nothing is written and this
+   * should be tried again later. If the previous write failed, the journal is started over with
+   * everything rather than only what changed.
+   */
+  bool Write(Project* project);
+
+  /**
+   * @brief Block until any background writing has finished
+   */
+  void WaitForFinished();
+
+  /**
+   * @brief Delete the journal from disk
+   */
+  void Remove();
+
+private:
+  struct Record {
+    ProjectSaveBinaryTask::ChunkType type;
+    quint64 key;
+
+    // Empty if the chunk has been removed (i.e. a deleted sequence)
+    QByteArray data;
+  };
+
+  using RecordKey = QPair<quint8, quint64>;
+
+  QVector<Record> Snapshot(Project* project, bool everything);
+
+  bool Append(QVector<Record> records);
+
+  void Compact();
+
+  void WriteHeader(QDataStream* ds) const;
+
+  static void WriteRecord(QDataStream* ds, const Record& record);
+
+  static quint64 GetProjectChunkGeneration(Project* project);
+
+  QString filename_;
+
+  QString project_url_;
+
+  // Only accessed from the main thread
+  QHash<quint64, quint64> saved_sequence_generations_;
+  quint64 saved_project_generation_;
+  bool has_snapshot_;
+
+  QFuture<bool> pending_write_;
+
+  // Only accessed from the background write
+  QMap<RecordKey, QByteArray> live_records_;
+  qint64 live_size_;
+  bool file_started_;
+
+};
+
+}
+
+#endif // PROJECTJOURNAL_H
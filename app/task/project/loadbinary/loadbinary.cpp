@@ -0,0 +1,299 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "loadbinary.h"
+
+#include <QApplication>
+#include <QDataStream>
+#include <QFile>
+#include <QtConcurrent/QtConcurrent>
+#include <QXmlStreamReader>
+
+#include "core.h"
+#include "task/project/journal/projectjournal.h"
+#include "task/project/savebinary/savebinary.h"
+
+namespace olive {
+
+ProjectLoadBinaryTask::ProjectLoadBinaryTask(const QString &filename) :
+  ProjectLoadBaseTask(filename)
+{
+}
+
+bool ProjectLoadBinaryTask::Run()
+{
+  QFile project_file(GetFilename());
+
+  if (!project_file.open(QFile::ReadOnly)) {
+    SetError(tr("Failed to read file \"%1\" for reading.").arg(GetFilename()));
+    return false;
+  }
+
+  // Autorecovery journals share the binary project's chunks, \see ProjectJournal
+  QByteArray magic = project_file.read(ProjectSaveBinaryTask::kMagic.size());
+  bool is_journal = (magic == ProjectJournal::kMagic);
+
+  if (!is_journal && magic != ProjectSaveBinaryTask::kMagic) {
+    SetError(tr("This file is not an Olive binary project."));
+    return false;
+  }
+
+  QDataStream ds(&project_file);
+  ds.setVersion(QDataStream::Qt_5_6);
+
+  quint32 format_version, project_version;
+
+  ds >> format_version;
+
+  if (format_version > (is_journal ? ProjectJournal::kFormatVersion : ProjectSaveBinaryTask::kFormatVersion)) {
+    SetError(tr("This project is newer than this version of Olive and cannot be opened."));
+    return false;
+  }
+
+  ds >> project_version;
+
+  if (project_version > Core::kProjectVersion) {
+    // Project is newer than we support
+    SetError(tr("This project is newer than this version of Olive and cannot be opened."));
+    return false;
+  } else if (project_version < 201003) { // Change this if we drop support for a project version
+    // Project is older than we support
+    SetError(tr("This project is from a version of Olive that is no longer supported in this version."));
+    return false;
+  }
+
+  ds >> project_saved_url_;
+
+  QVector<ProjectSaveBinaryTask::ChunkType> chunk_types;
+  QList<QByteArray> compressed_data;
+
+  if (is_journal) {
+    ReadJournalChunks(&ds, &chunk_types, &compressed_data);
+  } else {
+    quint32 chunk_count;
+
+    ds >> chunk_count;
+
+    for (quint32 i=0;i<chunk_count && ds.status() == QDataStream::Ok;i++) {
+      quint8 type;
+      QByteArray data;
+
+      ds >> type;
+      ds >> data;
+
+      chunk_types.append(static_cast<ProjectSaveBinaryTask::ChunkType>(type));
+      compressed_data.append(data);
+    }
+  }
+
+  project_file.close();
+
+  if ((!is_journal && ds.status() != QDataStream::Ok) || compressed_data.isEmpty()) {
+    SetError(tr("Project file is corrupt or incomplete."));
+    return false;
+  }
+
+  QList<QByteArray> chunk_data = QtConcurrent::blockingMapped(compressed_data, &ProjectLoadBinaryTask::DecompressChunk);
+
+  // Sequences don't depend on anything else in the project, so they're loaded first and in
+  // parallel. The project chunk then picks them up by their pointers.
+  QVector<SequenceJob> sequence_jobs;
+  QByteArray project_chunk, layout_chunk;
+
+  for (int i=0;i<chunk_data.size();i++) {
+    if (chunk_data.at(i).isEmpty()) {
+      SetError(tr("Project file is corrupt or incomplete."));
+      return false;
+    }
+
+    switch (chunk_types.at(i)) {
+    case ProjectSaveBinaryTask::kChunkProject:
+      project_chunk = chunk_data.at(i);
+      break;
+    case ProjectSaveBinaryTask::kChunkSequence:
+      sequence_jobs.append({chunk_data.at(i), project_version, &IsCancelled(), QThread::currentThread()});
+      break;
+    case ProjectSaveBinaryTask::kChunkLayout:
+      layout_chunk = chunk_data.at(i);
+      break;
+    }
+  }
+
+  emit ProgressChanged(0.25);
+
+  QVector<LoadedSequence> loaded_sequences = QtConcurrent::blockingMapped(sequence_jobs, &ProjectLoadBinaryTask::LoadSequence);
+
+  XMLNodeData xml_node_data;
+  QString sequence_error;
+
+  foreach (const LoadedSequence& loaded, loaded_sequences) {
+    if (!loaded.error.isEmpty()) {
+      sequence_error = loaded.error;
+    }
+
+    xml_node_data.item_ptrs.unite(loaded.xml_node_data.item_ptrs);
+    xml_node_data.node_ptrs.unite(loaded.xml_node_data.node_ptrs);
+    xml_node_data.footage_connections.append(loaded.xml_node_data.footage_connections);
+  }
+
+  if (!sequence_error.isEmpty() || IsCancelled()) {
+    foreach (const LoadedSequence& loaded, loaded_sequences) {
+      delete loaded.sequence;
+    }
+
+    SetError(sequence_error);
+    return false;
+  }
+
+  emit ProgressChanged(0.75);
+
+  project_ = new Project();
+
+  if (is_journal) {
+    // A recovered project belongs wherever the original project was, and hasn't been saved there
+    project_->set_filename(project_saved_url_);
+    project_->set_modified(true);
+  } else {
+    project_->set_filename(GetFilename());
+  }
+
+  {
+    QXmlStreamReader reader(project_chunk);
+
+    while (XMLReadNextStartElement(&reader)) {
+      if (reader.name() == QStringLiteral("project")) {
+        project_->Load(&reader, xml_node_data, &layout_info_, project_version, &IsCancelled());
+      } else {
+        reader.skipCurrentElement();
+      }
+    }
+
+    if (reader.hasError()) {
+      // Sequences that were placed in a folder are deleted with the project, the rest are ours
+      foreach (const LoadedSequence& loaded, loaded_sequences) {
+        if (loaded.sequence && !loaded.sequence->item_parent()) {
+          delete loaded.sequence;
+        }
+      }
+
+      delete project_;
+      project_ = nullptr;
+
+      SetError(reader.errorString());
+      return false;
+    }
+  }
+
+  // Any sequence whose folder couldn't be found goes in the root
+  foreach (const LoadedSequence& loaded, loaded_sequences) {
+    if (loaded.sequence && !loaded.sequence->item_parent()) {
+      loaded.sequence->setParent(project_->root());
+    }
+  }
+
+  {
+    QXmlStreamReader reader(layout_chunk);
+
+    while (XMLReadNextStartElement(&reader)) {
+      if (reader.name() == QStringLiteral("layout")) {
+        layout_info_ = MainWindowLayoutInfo::fromXml(&reader, xml_node_data);
+      } else {
+        reader.skipCurrentElement();
+      }
+    }
+  }
+
+  // Ensure project is in main thread
+  project_->moveToThread(qApp->thread());
+
+  emit ProgressChanged(1);
+
+  return true;
+}
+
+void ProjectLoadBinaryTask::ReadJournalChunks(QDataStream *ds, QVector<ProjectSaveBinaryTask::ChunkType> *chunk_types, QList<QByteArray> *compressed_data)
+{
+  // Later records of the same chunk replace earlier ones, and empty records remove them
+  QMap<QPair<quint8, quint64>, QByteArray> latest_records;
+
+  while (!ds->atEnd()) {
+    quint8 type;
+    quint64 key;
+    QByteArray data;
+
+    *ds >> type;
+    *ds >> key;
+    *ds >> data;
+
+    if (ds->status() != QDataStream::Ok) {
+      // A write was interrupted, everything before it is still valid
+      break;
+    }
+
+    QPair<quint8, quint64> record_key(type, key);
+
+    if (data.isEmpty()) {
+      latest_records.remove(record_key);
+    } else {
+      latest_records.insert(record_key, data);
+    }
+  }
+
+  for (QMap<QPair<quint8, quint64>, QByteArray>::const_iterator it=latest_records.constBegin(); it!=latest_records.constEnd(); it++) {
+    chunk_types->append(static_cast<ProjectSaveBinaryTask::ChunkType>(it.key().first));
+    compressed_data->append(it.value());
+  }
+}
+
+QByteArray ProjectLoadBinaryTask::DecompressChunk(const QByteArray &data)
+{
+  return qUncompress(data);
+}
+
+ProjectLoadBinaryTask::LoadedSequence ProjectLoadBinaryTask::LoadSequence(const SequenceJob &job)
+{
+  LoadedSequence loaded;
+  loaded.sequence = nullptr;
+
+  QXmlStreamReader reader(job.data);
+
+  while (XMLReadNextStartElement(&reader)) {
+    if (reader.name() == QStringLiteral("sequence")) {
+      Sequence* sequence = new Sequence();
+
+      sequence->Load(&reader, loaded.xml_node_data, job.version, job.cancelled);
+
+      // Sequences are parented by the loading thread, so they need to belong to it
+      sequence->moveToThread(job.destination_thread);
+
+      loaded.sequence = sequence;
+    } else {
+      reader.skipCurrentElement();
+    }
+  }
+
+  if (reader.hasError()) {
+    loaded.error = reader.errorString();
+  }
+
+  return loaded;
+}
+
+}
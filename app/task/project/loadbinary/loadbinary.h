@@ -0,0 +1,73 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef PROJECTLOADBINARYTASK_H
+#define PROJECTLOADBINARYTASK_H
+
+#include <QDataStream>
+#include <QThread>
+
+#include "common/xmlutils.h"
+#include "project/item/sequence/sequence.h"
+#include "task/project/load/loadbasetask.h"
+#include "task/project/savebinary/savebinary.h"
+
+namespace olive {
+
+/**
+ * @brief Loads a project saved in Olive's binary project format or an autorecovery journal
+ *
+ * Chunks are decompressed in parallel and every sequence is loaded on its own thread before the
+ * rest of the project is pieced together. \see ProjectSaveBinaryTask
+ */
+class ProjectLoadBinaryTask : public ProjectLoadBaseTask
+{
+  Q_OBJECT
+public:
+  ProjectLoadBinaryTask(const QString& filename);
+
+protected:
+  virtual bool Run() override;
+
+private:
+  struct SequenceJob {
+    QByteArray data;
+    uint version;
+    const QAtomicInt* cancelled;
+    QThread* destination_thread;
+  };
+
+  struct LoadedSequence {
+    Sequence* sequence;
+    XMLNodeData xml_node_data;
+    QString error;
+  };
+
+  static void ReadJournalChunks(QDataStream* ds, QVector<ProjectSaveBinaryTask::ChunkType>* chunk_types, QList<QByteArray>* compressed_data);
+
+  static QByteArray DecompressChunk(const QByteArray& data);
+
+  static LoadedSequence LoadSequence(const SequenceJob& job);
+
+};
+
+}
+
+#endif // PROJECTLOADBINARYTASK_H
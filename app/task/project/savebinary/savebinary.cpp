@@ -0,0 +1,156 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "savebinary.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QtConcurrent/QtConcurrent>
+#include <QXmlStreamWriter>
+
+#include "common/filefunctions.h"
+#include "core.h"
+
+namespace olive {
+
+const QByteArray ProjectSaveBinaryTask::kMagic = QByteArrayLiteral("OLVB");
+const quint32 ProjectSaveBinaryTask::kFormatVersion = 1;
+
+ProjectSaveBinaryTask::ProjectSaveBinaryTask(Project *project) :
+  ProjectSaveTask(project)
+{
+}
+
+bool ProjectSaveBinaryTask::Run()
+{
+  Project* project = GetProject();
+
+  QList<QByteArray> chunk_data;
+  QVector<ChunkType> chunk_types;
+
+  // Each sequence gets its own chunk so they can be loaded independently. They don't depend on each
+  // other or on the project chunk, so they're all serialized at the same time.
+  QList<Item*> sequences = project->get_items_of_type(Item::kSequence).toList();
+
+  QFuture<QByteArray> project_chunk = QtConcurrent::run(&ProjectSaveBinaryTask::SerializeProjectChunk, project);
+  QList<QByteArray> sequence_chunks = QtConcurrent::blockingMapped(sequences, &ProjectSaveBinaryTask::SerializeSequenceChunk);
+
+  chunk_data.append(project_chunk.result());
+  chunk_types.append(kChunkProject);
+
+  foreach (const QByteArray& sequence_chunk, sequence_chunks) {
+    chunk_data.append(sequence_chunk);
+    chunk_types.append(kChunkSequence);
+  }
+
+  // Window layout, loaded last since it refers to items in all of the other chunks
+  chunk_data.append(SerializeLayoutChunk());
+  chunk_types.append(kChunkLayout);
+
+  emit ProgressChanged(0.5);
+
+  QList<QByteArray> compressed_data = QtConcurrent::blockingMapped(chunk_data, &ProjectSaveBinaryTask::CompressChunk);
+
+  // File to temporarily save to (ensures we can't half-write the user's main file and crash)
+  QString temp_save = FileFunctions::GetSafeTemporaryFilename(project->filename());
+
+  QFile project_file(temp_save);
+
+  if (!project_file.open(QFile::WriteOnly)) {
+    SetError(tr("Failed to open temporary file \"%1\" for writing.").arg(temp_save));
+    return false;
+  }
+
+  project_file.write(kMagic);
+
+  QDataStream ds(&project_file);
+  ds.setVersion(QDataStream::Qt_5_6);
+
+  ds << kFormatVersion;
+  ds << quint32(Core::kProjectVersion);
+  ds << project->filename();
+  ds << quint32(compressed_data.size());
+
+  for (int i=0;i<compressed_data.size();i++) {
+    ds << quint8(chunk_types.at(i));
+    ds << compressed_data.at(i);
+  }
+
+  bool write_ok = (ds.status() == QDataStream::Ok);
+
+  project_file.close();
+
+  if (!write_ok) {
+    SetError(tr("Failed to write project data"));
+    return false;
+  }
+
+  emit ProgressChanged(1.0);
+
+  // Save was successful, we can now rewrite the original file
+  if (FileFunctions::RenameFileAllowOverwrite(temp_save, project->filename())) {
+    return true;
+  } else {
+    SetError(tr("Failed to overwrite \"%1\". Project has been saved as \"%2\" instead.")
+             .arg(project->filename(), temp_save));
+    return false;
+  }
+}
+
+QByteArray ProjectSaveBinaryTask::SerializeProjectChunk(Project *project)
+{
+  QByteArray xml;
+  QXmlStreamWriter writer(&xml);
+
+  writer.writeStartElement(QStringLiteral("project"));
+  project->SaveWithoutSequences(&writer);
+  writer.writeEndElement(); // project
+
+  return xml;
+}
+
+QByteArray ProjectSaveBinaryTask::SerializeSequenceChunk(Item *sequence)
+{
+  QByteArray xml;
+  QXmlStreamWriter writer(&xml);
+
+  writer.writeStartElement(QStringLiteral("sequence"));
+  sequence->Save(&writer);
+  writer.writeEndElement(); // sequence
+
+  return xml;
+}
+
+QByteArray ProjectSaveBinaryTask::SerializeLayoutChunk()
+{
+  QByteArray xml;
+  QXmlStreamWriter writer(&xml);
+
+  Core::instance()->main_window()->SaveLayout().toXml(&writer);
+
+  return xml;
+}
+
+QByteArray ProjectSaveBinaryTask::CompressChunk(const QByteArray &data)
+{
+  return qCompress(data);
+}
+
+}
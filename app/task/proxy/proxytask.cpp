@@ -0,0 +1,68 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "proxytask.h"
+
+#include "codec/decoder.h"
+
+namespace olive {
+
+ProxyTask::ProxyTask(VideoStream *stream) :
+  stream_(stream),
+  divider_(GetAdaptiveDivider(stream))
+{
+  SetTitle(tr("Generating Proxy %1:%2").arg(stream_->footage()->filename(), QString::number(stream_->index())));
+}
+
+int ProxyTask::GetAdaptiveDivider(VideoStream *stream)
+{
+  // Use the same heuristic as the viewer's automatic resolution, but always at least half size
+  // since a full resolution proxy would be pointless
+  return qMax(2, VideoParams::generate_auto_divider(stream->width(), stream->height()));
+}
+
+bool ProxyTask::Run()
+{
+  DecoderPtr decoder = Decoder::CreateFromID(stream_->footage()->decoder());
+
+  if (!decoder) {
+    SetError(tr("Failed to find decoder to generate proxy"));
+    return false;
+  }
+
+  connect(decoder.get(), &Decoder::IndexProgress, this, &ProxyTask::ProgressChanged);
+
+  if (!decoder->Open(stream_)) {
+    SetError(tr("Failed to open media to generate proxy"));
+    return false;
+  }
+
+  bool success = decoder->GenerateProxy(divider_, &IsCancelled());
+
+  decoder->Close();
+
+  if (!success && !IsCancelled()) {
+    SetError(tr("Failed to generate proxy"));
+  }
+
+  return success;
+}
+
+}
@@ -0,0 +1,58 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef PROXYTASK_H
+#define PROXYTASK_H
+
+#include "project/item/footage/videostream.h"
+#include "task/task.h"
+
+namespace olive {
+
+/**
+ * @brief Transcodes a video stream into a lower resolution, intra-frame proxy
+ *
+ * The proxy is written to the project cache where decoders will pick it up automatically for any
+ * render that doesn't need the original resolution.
+ */
+class ProxyTask : public Task
+{
+  Q_OBJECT
+public:
+  ProxyTask(VideoStream* stream);
+
+  /**
+   * @brief Choose a proxy divider appropriate for a stream's resolution
+   */
+  static int GetAdaptiveDivider(VideoStream* stream);
+
+protected:
+  virtual bool Run() override;
+
+private:
+  VideoStream* stream_;
+
+  int divider_;
+
+};
+
+}
+
+#endif // PROXYTASK_H
@@ -29,10 +29,30 @@ RenderTask::RenderTask(ViewerOutput* viewer, const VideoParams &vparams, const A
   viewer_(viewer),
   video_params_(vparams),
   audio_params_(aparams),
+  priority_(RenderTicket::kPriorityExport),
+  max_running_tickets_(0),
+  paused_(false),
+  interleaved_segments_(1),
   running_tickets_(0)
 {
 }
 
+void RenderTask::SetMaximumRunningTickets(int max)
+{
+  finished_watcher_mutex_.lock();
+  max_running_tickets_ = max;
+  finished_watcher_wait_cond_.wakeAll();
+  finished_watcher_mutex_.unlock();
+}
+
+void RenderTask::SetPaused(bool paused)
+{
+  finished_watcher_mutex_.lock();
+  paused_ = paused;
+  finished_watcher_wait_cond_.wakeAll();
+  finished_watcher_mutex_.unlock();
+}
+
 RenderTask::~RenderTask()
 {
 }
@@ -67,12 +87,16 @@ bool RenderTask::Render(ColorManager* manager,
     RenderTicketWatcher* watcher = new RenderTicketWatcher();
     watcher->setProperty("range", QVariant::fromValue(r));
     PrepareWatcher(watcher, &watcher_thread);
-    watcher->SetTicket(RenderManager::instance()->RenderAudio(viewer_, r, audio_params_, false));
+    watcher->SetTicket(RenderManager::instance()->RenderAudio(viewer_, r, audio_params_, false, priority_));
   }
 
   // Look up hashes
   QMap<QByteArray, QVector<rational> > time_map;
 
+  // First time of each unique hash, these are what we actually render
+  QVector<rational> frames_to_render;
+  QVector<QByteArray> frame_hashes_to_render;
+
   if (!video_range.isEmpty()) {
     // Get list of discrete frames from range
     QVector<rational> times = viewer()->video_frame_cache()->GetFrameListFromTimeRange(video_range);
@@ -98,18 +122,9 @@ bool RenderTask::Render(ColorManager* manager,
       time_map[hash].append(times.at(i));
 
       if (time_map[hash].size() == 1) {
-        // This is the first frame with this hash, so we signal a render
-        RenderTicketWatcher* watcher = new RenderTicketWatcher();
-        watcher->setProperty("hash", hash);
-        PrepareWatcher(watcher, &watcher_thread);
-
-        IncrementRunningTickets();
-
-        watcher->SetTicket(RenderManager::instance()->RenderFrame(viewer_, manager, times.at(i),
-                                                                  mode, video_params_, audio_params_,
-                                                                  force_size, force_matrix,
-                                                                  force_format, force_color_output,
-                                                                  cache));
+        // This is the first frame with this hash, so we'll render it
+        frames_to_render.append(times.at(i));
+        frame_hashes_to_render.append(hash);
       }
     }
 
@@ -117,9 +132,56 @@ bool RenderTask::Render(ColorManager* manager,
     total_length += video_frame_sz * time_map.size();
   }
 
+  if (interleaved_segments_ > 1 && frames_to_render.size() > interleaved_segments_) {
+    // Take one frame from each segment in turn so they're all rendered at the same time
+    int segment_length = (frames_to_render.size() + interleaved_segments_ - 1) / interleaved_segments_;
+
+    QVector<rational> interleaved_frames;
+    QVector<QByteArray> interleaved_hashes;
+    interleaved_frames.reserve(frames_to_render.size());
+    interleaved_hashes.reserve(frames_to_render.size());
+
+    for (int i=0; i<segment_length; i++) {
+      for (int j=i; j<frames_to_render.size(); j+=segment_length) {
+        interleaved_frames.append(frames_to_render.at(j));
+        interleaved_hashes.append(frame_hashes_to_render.at(j));
+      }
+    }
+
+    frames_to_render = interleaved_frames;
+    frame_hashes_to_render = interleaved_hashes;
+  }
+
+  int next_frame = 0;
+
   finished_watcher_mutex_.lock();
 
   while (!IsCancelled()) {
+    // Signal frame renders as long as we're below our limit, this keeps the amount of frames in
+    // memory (and the amount we'd have to throw away if cancelled) bounded
+    while (next_frame < frames_to_render.size()
+           && (!max_running_tickets_ || running_tickets_ < max_running_tickets_)
+           && !paused_
+           && !IsCancelled()) {
+      finished_watcher_mutex_.unlock();
+
+      RenderTicketWatcher* watcher = new RenderTicketWatcher();
+      watcher->setProperty("hash", frame_hashes_to_render.at(next_frame));
+      PrepareWatcher(watcher, &watcher_thread);
+
+      IncrementRunningTickets();
+
+      watcher->SetTicket(RenderManager::instance()->RenderFrame(viewer_, manager, frames_to_render.at(next_frame),
+                                                                mode, video_params_, audio_params_,
+                                                                force_size, force_matrix,
+                                                                force_format, force_color_output,
+                                                                cache, priority_));
+
+      next_frame++;
+
+      finished_watcher_mutex_.lock();
+    }
+
     while (!finished_watchers_.empty() && !IsCancelled()) {
       RenderTicketWatcher* watcher = finished_watchers_.front();
       finished_watchers_.pop_front();
@@ -177,9 +239,13 @@ bool RenderTask::Render(ColorManager* manager,
       break;
     }
 
-    // Run out of finished watchers. If we still have running tickets, wait for the next one to finish.
-    if (running_tickets_ > 0) {
+    // Run out of finished watchers. If we still have running tickets, wait for the next one to
+    // finish. If we're paused, wait to be resumed.
+    if (running_tickets_ > 0 || (paused_ && next_frame < frames_to_render.size())) {
       finished_watcher_wait_cond_.wait(&finished_watcher_mutex_);
+    } else if (next_frame < frames_to_render.size()) {
+      // Room for more frames
+      continue;
     } else {
       // No more running tickets or finished tickets, wem ust be
       break;
@@ -212,7 +278,8 @@ void RenderTask::DownloadFrame(QThread *thread, FramePtr frame, const QByteArray
 
   watcher->SetTicket(RenderManager::instance()->SaveFrameToCache(viewer_->video_frame_cache(),
                                                                  frame,
-                                                                 hash));
+                                                                 hash,
+                                                                 priority_));
 }
 
 void RenderTask::PrepareWatcher(RenderTicketWatcher *watcher, QThread *thread)
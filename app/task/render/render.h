@@ -39,6 +39,20 @@ public:
 
   virtual ~RenderTask() override;
 
+  /**
+   * @brief Limit how many frames this task has rendering at once, or 0 for no limit
+   *
+   * This function is thread-safe.
+   */
+  void SetMaximumRunningTickets(int max);
+
+  /**
+   * @brief Stop signalling new frame renders until unpaused
+   *
+   * Frames already rendering will still finish. This function is thread-safe.
+   */
+  void SetPaused(bool paused);
+
 protected:
   bool Render(ColorManager *manager, const TimeRangeList &video_range,
               const TimeRangeList &audio_range, RenderMode::Mode mode,
@@ -80,6 +94,25 @@ protected:
     return true;
   }
 
+  /**
+   * @brief Set which class of work this task's tickets compete in (defaults to export)
+   */
+  void SetRenderPriority(RenderTicket::Priority priority)
+  {
+    priority_ = priority;
+  }
+
+  /**
+   * @brief Render frames from this many equal parts of the range in turn, rather than in order
+   *
+   * Useful if each part of the range is processed separately after rendering, so that they all
+   * receive frames at the same time. Defaults to 1.
+   */
+  void SetInterleavedSegments(int segments)
+  {
+    interleaved_segments_ = segments;
+  }
+
 private:
   void PrepareWatcher(RenderTicketWatcher* watcher, QThread *thread);
 
@@ -91,6 +124,14 @@ private:
 
   AudioParams audio_params_;
 
+  RenderTicket::Priority priority_;
+
+  int max_running_tickets_;
+
+  bool paused_;
+
+  int interleaved_segments_;
+
   QVector<RenderTicketWatcher*> running_watchers_;
   std::list<RenderTicketWatcher*> finished_watchers_;
   int running_tickets_;
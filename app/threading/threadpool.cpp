@@ -22,9 +22,24 @@
 
 namespace olive {
 
+// Relative share of threads each class gets while others are also waiting. Interactive tickets
+// don't share, they always run first.
+const double kPriorityWeights[RenderTicket::kPriorityCount] = {
+  0,  // kPriorityInteractive
+  8,  // kPriorityPlayback
+  4,  // kPriorityExport
+  1   // kPriorityCache
+};
+
 ThreadPool::ThreadPool(QThread::Priority priority, int threads, QObject *parent) :
-  QObject(parent)
+  QObject(parent),
+  current_virtual_time_(0),
+  shutting_down_(false)
 {
+  for (int i=0; i<RenderTicket::kPriorityCount; i++) {
+    virtual_time_[i] = 0;
+  }
+
   all_threads_.resize(threads ? threads : QThread::idealThreadCount());
 
   // Create threads
@@ -34,12 +49,6 @@ ThreadPool::ThreadPool(QThread::Priority priority, int threads, QObject *parent)
     // Add to vector of all threads
     all_threads_[i] = t;
 
-    // Append to list of available threads
-    available_threads_.push_back(t);
-
-    // Connect done signal
-    connect(t, &ThreadPoolThread::Done, this, &ThreadPool::ThreadDone);
-
     // Start the thread at the given priority
     t->start(priority);
   }
@@ -47,99 +56,111 @@ ThreadPool::ThreadPool(QThread::Priority priority, int threads, QObject *parent)
 
 ThreadPool::~ThreadPool()
 {
+  queue_lock_.lock();
+  shutting_down_ = true;
+  queue_wait_.wakeAll();
+  queue_lock_.unlock();
+
   foreach (ThreadPoolThread* thread, all_threads_) {
-    thread->Cancel();
     thread->wait();
     delete thread;
   }
 }
 
-void ThreadPool::AddTicket(RenderTicketPtr ticket, bool prioritize)
+void ThreadPool::AddTicket(RenderTicketPtr ticket)
 {
-  if (prioritize) {
-    ticket_queue_.push_front(ticket);
-  } else {
-    ticket_queue_.push_back(ticket);
-  }
+  // Release the ticket from its thread so whichever thread runs it can take it
+  ticket->moveToThread(nullptr);
 
-  RunNext();
-}
+  QMutexLocker locker(&queue_lock_);
 
-void ThreadPool::RunNext()
-{
-  while (!ticket_queue_.empty() && !available_threads_.empty()) {
-    // Run function
-    RenderTicketPtr ticket = ticket_queue_.front();
-    ticket_queue_.pop_front();
+  RenderTicket::Priority priority = ticket->GetPriority();
+  std::list<RenderTicketPtr>& queue = queues_[priority];
 
-    if (!ticket->WasCancelled()) {
-      ThreadPoolThread* thread = available_threads_.front();
-      available_threads_.pop_front();
+  if (queue.empty()) {
+    // Don't let a class that was idle claim all the time it "missed"
+    virtual_time_[priority] = qMax(virtual_time_[priority], current_virtual_time_);
+  }
 
-      // Move ticket to other thread so event processing can occur there
-      ticket->moveToThread(thread);
+  if (priority == RenderTicket::kPriorityPlayback) {
+    // Sorted by deadline, earliest first
+    auto it = queue.begin();
 
-      // Run the ticket in the thread, which actually just calls our virtual function RunTicket
-      thread->RunTicket(ticket);
+    while (it != queue.end() && (*it)->GetDeadline() <= ticket->GetDeadline()) {
+      it++;
     }
+
+    queue.insert(it, ticket);
+  } else {
+    queue.push_back(ticket);
   }
+
+  queue_wait_.wakeOne();
 }
 
-void ThreadPool::ThreadDone()
+RenderTicketPtr ThreadPool::TakeTicket()
 {
-  ThreadPoolThread* thread = static_cast<ThreadPoolThread*>(sender());
+  QMutexLocker locker(&queue_lock_);
 
-  available_threads_.push_back(thread);
+  while (!shutting_down_) {
+    int index = ChooseQueue();
 
-  RunNext();
-}
+    if (index == -1) {
+      queue_wait_.wait(&queue_lock_);
+      continue;
+    }
 
-ThreadPoolThread::ThreadPoolThread(ThreadPool *parent)
-{
-  pool_ = parent;
+    RenderTicketPtr ticket = queues_[index].front();
+    queues_[index].pop_front();
 
-  // Ensures mutex is definitely locked by the time the thread is running
-  mutex_.lock();
+    if (index != RenderTicket::kPriorityInteractive) {
+      current_virtual_time_ = virtual_time_[index];
+      virtual_time_[index] += 1.0 / kPriorityWeights[index];
+    }
+
+    if (!ticket->WasCancelled()) {
+      return ticket;
+    }
+  }
+
+  return nullptr;
 }
 
-ThreadPoolThread::~ThreadPoolThread()
+int ThreadPool::ChooseQueue() const
 {
-  mutex_.unlock();
+  if (!queues_[RenderTicket::kPriorityInteractive].empty()) {
+    return RenderTicket::kPriorityInteractive;
+  }
+
+  int chosen = -1;
+
+  for (int i=RenderTicket::kPriorityInteractive+1; i<RenderTicket::kPriorityCount; i++) {
+    if (!queues_[i].empty() && (chosen == -1 || virtual_time_[i] < virtual_time_[chosen])) {
+      chosen = i;
+    }
+  }
+
+  return chosen;
 }
 
-void ThreadPoolThread::RunTicket(RenderTicketPtr ticket)
+ThreadPoolThread::ThreadPoolThread(ThreadPool *parent) :
+  pool_(parent)
 {
-  mutex_.lock();
-  ticket_ = ticket;
-  wait_cond_.wakeAll();
-  mutex_.unlock();
 }
 
 void ThreadPoolThread::run()
 {
-  while (true) {
-    wait_cond_.wait(&mutex_);
+  RenderTicketPtr ticket;
 
-    if (ticket_) {
-      pool_->RunTicket(ticket_);
+  while ((ticket = pool_->TakeTicket())) {
+    // Pull the ticket into this thread so event processing can occur here
+    ticket->moveToThread(this);
 
-      // Move back to calling thread (hacky?)
-      ticket_->moveToThread(this->thread());
-
-      ticket_ = nullptr;
-    }
+    pool_->RunTicket(ticket);
 
-    if (IsCancelled()) {
-      break;
-    } else {
-      emit Done();
-    }
+    // Hand it back to the pool's thread (we can only push from here)
+    ticket->moveToThread(pool_->thread());
   }
 }
 
-void ThreadPoolThread::CancelEvent()
-{
-  wait_cond_.wakeAll();
-}
-
 }
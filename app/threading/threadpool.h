@@ -21,15 +21,24 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
+#include <QMutex>
 #include <QThread>
+#include <QWaitCondition>
 
-#include "common/cancelableobject.h"
 #include "threading/threadticket.h"
 
 namespace olive {
 
 class ThreadPoolThread;
 
+/**
+ * @brief A fixed set of threads that run RenderTickets by priority
+ *
+ * Interactive tickets always run first. The other priority classes share threads in proportion
+ * to their weights, so background caching keeps making progress during playback and exports
+ * without holding them up. Playback tickets run in order of their deadlines, the rest in the
+ * order they were added.
+ */
 class ThreadPool : public QObject
 {
   Q_OBJECT
@@ -38,54 +47,63 @@ public:
 
   virtual ~ThreadPool() override;
 
-  RenderTicketPtr Queue();
-
   virtual void RunTicket(RenderTicketPtr ticket) const = 0;
 
-public slots:
-  void AddTicket(olive::RenderTicketPtr ticket, bool prioritize = false);
+  /**
+   * @brief Queue a ticket according to its priority
+   *
+   * This function is thread safe, but must be called from the thread `ticket` belongs to.
+   */
+  void AddTicket(olive::RenderTicketPtr ticket);
 
 private:
-  void RunNext();
+  friend class ThreadPoolThread;
+
+  /**
+   * @brief Block until a ticket is available and take it
+   *
+   * @return
+   *
+   * The next ticket to run, or nullptr if the pool is shutting down.
+   */
+  RenderTicketPtr TakeTicket();
+
+  int ChooseQueue() const;
 
   QVector<ThreadPoolThread*> all_threads_;
 
-  std::list<ThreadPoolThread*> available_threads_;
+  std::list<RenderTicketPtr> queues_[RenderTicket::kPriorityCount];
+
+  /**
+   * @brief Virtual time of each class for weighted fair sharing
+   *
+   * Each ticket taken advances its class's virtual time by the inverse of its weight, and the
+   * class furthest behind runs next.
+   */
+  double virtual_time_[RenderTicket::kPriorityCount];
 
-  std::list<RenderTicketPtr> ticket_queue_;
+  double current_virtual_time_;
 
-private slots:
-  void ThreadDone();
+  bool shutting_down_;
+
+  QMutex queue_lock_;
+
+  QWaitCondition queue_wait_;
 
 };
 
-class ThreadPoolThread : public QThread, public CancelableObject
+class ThreadPoolThread : public QThread
 {
   Q_OBJECT
 public:
   ThreadPoolThread(ThreadPool* parent);
 
-  virtual ~ThreadPoolThread() override;
-
-  void RunTicket(RenderTicketPtr ticket);
-
 protected:
   virtual void run() override;
 
-  virtual void CancelEvent() override;
-
-signals:
-  void Done();
-
 private:
   ThreadPool* pool_;
 
-  RenderTicketPtr ticket_;
-
-  QMutex mutex_;
-
-  QWaitCondition wait_cond_;
-
 };
 
 }
@@ -25,7 +25,9 @@ namespace olive {
 RenderTicket::RenderTicket() :
   started_(false),
   finished_(false),
-  cancelled_(false)
+  cancelled_(false),
+  priority_(kPriorityCache),
+  deadline_(0)
 {
   SetJobTime();
 }
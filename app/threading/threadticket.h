@@ -38,6 +38,44 @@ class RenderTicket : public QObject
 public:
   RenderTicket();
 
+  /**
+   * @brief Classes of work competing for render threads, from most to least urgent
+   */
+  enum Priority {
+    /// Something the user is waiting on right now (e.g. a frame while scrubbing)
+    kPriorityInteractive,
+
+    /// Frames for the playback queue, ordered by when they'll be shown
+    kPriorityPlayback,
+
+    /// Exports and other renders the user started explicitly
+    kPriorityExport,
+
+    /// Background caching (e.g. the auto-cache and waveforms)
+    kPriorityCache,
+
+    kPriorityCount
+  };
+
+  Priority GetPriority() const
+  {
+    return priority_;
+  }
+
+  /**
+   * @brief Time (in msecs since epoch) this ticket is needed by, or 0 if it has no deadline
+   */
+  qint64 GetDeadline() const
+  {
+    return deadline_;
+  }
+
+  void SetPriority(Priority priority, qint64 deadline = 0)
+  {
+    priority_ = priority;
+    deadline_ = deadline;
+  }
+
   qint64 GetJobTime() const
   {
     return job_time_;
@@ -85,6 +123,10 @@ private:
 
   qint64 job_time_;
 
+  Priority priority_;
+
+  qint64 deadline_;
+
 };
 
 using RenderTicketPtr = std::shared_ptr<RenderTicket>;
@@ -0,0 +1,222 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "workstealingexecutor.h"
+
+namespace olive {
+
+WorkStealingExecutor* WorkStealingExecutor::instance_ = nullptr;
+
+// Index of the calling thread's queue, 0 (the shared queue) for threads outside the pool
+static thread_local int current_queue = 0;
+
+TaskGroup::TaskGroup() :
+  executor_(WorkStealingExecutor::instance()),
+  pending_(0)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+  // Tasks hold a pointer to us, so we can't go away until they've finished
+  Wait();
+}
+
+void TaskGroup::Run(const std::function<void()> &task)
+{
+  if (!executor_) {
+    task();
+    return;
+  }
+
+  finished_lock_.lock();
+  pending_++;
+  finished_lock_.unlock();
+
+  executor_->Submit({task, this});
+}
+
+void TaskGroup::Wait()
+{
+  if (!executor_) {
+    return;
+  }
+
+  while (true) {
+    finished_lock_.lock();
+    bool done = (pending_ == 0);
+    finished_lock_.unlock();
+
+    if (done) {
+      return;
+    }
+
+    // Help instead of sleeping, this is what lets tasks wait on groups of their own
+    if (!executor_->RunOne()) {
+      // Nothing left to take, our tasks are running elsewhere. Re-check regularly in case more
+      // tasks become available to help with.
+      QMutexLocker locker(&finished_lock_);
+
+      if (pending_ > 0) {
+        finished_wait_.wait(&finished_lock_, 1);
+      }
+    }
+  }
+}
+
+void TaskGroup::TaskFinished()
+{
+  // The count is only read under the lock, so Wait() can't see it reach zero (and let the group
+  // be destroyed) until we've released it and are done with the group entirely
+  QMutexLocker locker(&finished_lock_);
+
+  pending_--;
+
+  if (pending_ == 0) {
+    finished_wait_.wakeAll();
+  }
+}
+
+WorkStealingExecutor::WorkStealingExecutor(int threads) :
+  queued_count_(0),
+  quit_(false)
+{
+  threads_.resize(threads ? threads : QThread::idealThreadCount());
+
+  // One queue per worker plus the shared queue at index 0
+  queues_.resize(threads_.size() + 1);
+  for (int i=0; i<queues_.size(); i++) {
+    queues_[i] = new Queue();
+  }
+
+  for (int i=0; i<threads_.size(); i++) {
+    threads_[i] = new WorkerThread(this, i + 1);
+    threads_[i]->start();
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+  sleep_lock_.lock();
+  quit_ = true;
+  sleep_wait_.wakeAll();
+  sleep_lock_.unlock();
+
+  foreach (WorkerThread* t, threads_) {
+    t->wait();
+    delete t;
+  }
+
+  qDeleteAll(queues_);
+}
+
+void WorkStealingExecutor::Submit(const Task &task)
+{
+  Queue* q = queues_.at(current_queue);
+
+  q->lock.lock();
+  q->tasks.push_back(task);
+  q->lock.unlock();
+
+  queued_count_.fetchAndAddOrdered(1);
+
+  QMutexLocker locker(&sleep_lock_);
+  sleep_wait_.wakeOne();
+}
+
+bool WorkStealingExecutor::RunOne()
+{
+  Task task;
+
+  // Our own newest task first, since it's the most likely to be in cache
+  bool found = TakeTask(current_queue, true, &task);
+
+  // Otherwise, steal the oldest task from someone else, starting after ourselves so threads
+  // don't all pick on the same victim
+  for (int i=1; !found && i<queues_.size(); i++) {
+    found = TakeTask((current_queue + i) % queues_.size(), false, &task);
+  }
+
+  if (!found) {
+    return false;
+  }
+
+  task.function();
+
+  // Release whatever the task captured before its group can finish
+  TaskGroup* group = task.group;
+  task.function = nullptr;
+
+  group->TaskFinished();
+
+  return true;
+}
+
+bool WorkStealingExecutor::TakeTask(int queue, bool newest, Task *task)
+{
+  Queue* q = queues_.at(queue);
+
+  QMutexLocker locker(&q->lock);
+
+  if (q->tasks.empty()) {
+    return false;
+  }
+
+  if (newest) {
+    *task = q->tasks.back();
+    q->tasks.pop_back();
+  } else {
+    *task = q->tasks.front();
+    q->tasks.pop_front();
+  }
+
+  queued_count_.fetchAndAddOrdered(-1);
+
+  return true;
+}
+
+WorkStealingExecutor::WorkerThread::WorkerThread(WorkStealingExecutor *executor, int index) :
+  executor_(executor),
+  index_(index)
+{
+}
+
+void WorkStealingExecutor::WorkerThread::run()
+{
+  current_queue = index_;
+
+  while (true) {
+    if (executor_->RunOne()) {
+      continue;
+    }
+
+    QMutexLocker locker(&executor_->sleep_lock_);
+
+    if (executor_->quit_) {
+      break;
+    }
+
+    if (executor_->queued_count_.load() == 0) {
+      executor_->sleep_wait_.wait(&executor_->sleep_lock_);
+    }
+  }
+}
+
+}
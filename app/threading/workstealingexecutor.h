@@ -0,0 +1,161 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef WORKSTEALINGEXECUTOR_H
+#define WORKSTEALINGEXECUTOR_H
+
+#include <deque>
+#include <functional>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "common/define.h"
+
+namespace olive {
+
+class WorkStealingExecutor;
+
+/**
+ * @brief A set of tasks that can be waited on together
+ *
+ * Tasks are run on the WorkStealingExecutor, or inline if there isn't one. Wait() runs queued
+ * tasks on the calling thread rather than sleeping, so tasks can safely wait on their own groups.
+ */
+class TaskGroup
+{
+public:
+  TaskGroup();
+
+  ~TaskGroup();
+
+  DISABLE_COPY_MOVE(TaskGroup)
+
+  void Run(const std::function<void()>& task);
+
+  void Wait();
+
+private:
+  friend class WorkStealingExecutor;
+
+  void TaskFinished();
+
+  WorkStealingExecutor* executor_;
+
+  /// Tasks still queued or running, guarded by `finished_lock_`
+  int pending_;
+
+  QMutex finished_lock_;
+
+  QWaitCondition finished_wait_;
+
+};
+
+/**
+ * @brief Thread pool for short CPU tasks that fork more tasks
+ *
+ * Each worker has its own queue. It runs its newest task first and, when it runs out, steals the
+ * oldest task from another queue, so forked subtrees stay on one core while idle cores take the
+ * larger, older pieces. Threads outside the pool submit to a shared queue.
+ */
+class WorkStealingExecutor
+{
+public:
+  static void CreateInstance()
+  {
+    instance_ = new WorkStealingExecutor();
+  }
+
+  static void DestroyInstance()
+  {
+    delete instance_;
+    instance_ = nullptr;
+  }
+
+  static WorkStealingExecutor* instance()
+  {
+    return instance_;
+  }
+
+private:
+  WorkStealingExecutor(int threads = 0);
+
+  ~WorkStealingExecutor();
+
+  friend class TaskGroup;
+
+  class WorkerThread : public QThread
+  {
+  public:
+    WorkerThread(WorkStealingExecutor* executor, int index);
+
+  protected:
+    virtual void run() override;
+
+  private:
+    WorkStealingExecutor* executor_;
+
+    int index_;
+
+  };
+
+  struct Task {
+    std::function<void()> function;
+    TaskGroup* group;
+  };
+
+  struct Queue {
+    QMutex lock;
+    std::deque<Task> tasks;
+  };
+
+  void Submit(const Task& task);
+
+  /**
+   * @brief Run one queued task on the calling thread if there is one
+   *
+   * Tries the calling worker's own queue first, then steals from the shared queue and the
+   * other workers.
+   */
+  bool RunOne();
+
+  bool TakeTask(int queue, bool newest, Task* task);
+
+  static WorkStealingExecutor* instance_;
+
+  QVector<Queue*> queues_;
+
+  QVector<WorkerThread*> threads_;
+
+  QAtomicInt queued_count_;
+
+  bool quit_;
+
+  QMutex sleep_lock_;
+
+  QWaitCondition sleep_wait_;
+
+};
+
+}
+
+#endif // WORKSTEALINGEXECUTOR_H
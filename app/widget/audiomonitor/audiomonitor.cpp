@@ -35,7 +35,8 @@ const int kMaximumSmoothness = 8;
 
 AudioMonitor::AudioMonitor(QWidget *parent) :
   QOpenGLWidget(parent),
-  file_(nullptr),
+  playing_(false),
+  meter_read_pos_(0),
   cached_channels_(0)
 {
   values_.resize(kMaximumSmoothness);
@@ -61,29 +62,22 @@ void AudioMonitor::SetParams(const AudioParams &params)
 
 void AudioMonitor::OutputDeviceSet(AudioPlaybackCache *cache, qint64 offset, int playback_speed)
 {
-  Stop();
+  Q_UNUSED(cache)
+  Q_UNUSED(offset)
+  Q_UNUSED(playback_speed)
 
-  file_ = cache->CreatePlaybackDevice(this);
+  // The output shares everything it plays through the meter buffer (already speed adjusted and
+  // reversed if necessary), so all we need to do is start reading from where it is now
+  meter_read_pos_ = AudioManager::instance()->GetMeterBuffer()->GetWritePosition();
 
-  if (!file_->open(QFile::ReadOnly)) {
-    qWarning() << "Failed to open IO device for AudioMonitor display";
-    Stop();
-    return;
-  }
-
-  file_->seek(offset);
-
-  playback_speed_ = playback_speed;
-
-  last_time_ = QDateTime::currentMSecsSinceEpoch();
+  playing_ = true;
 
   SetUpdateLoop(true);
 }
 
 void AudioMonitor::Stop()
 {
-  delete file_;
-  file_ = nullptr;
+  playing_ = false;
 }
 
 void AudioMonitor::OutputPushed(const QByteArray &d)
@@ -211,8 +205,8 @@ void AudioMonitor::paintGL()
 
   QVector<double> v(params_.channel_count(), 0);
 
-  if (file_) {
-    UpdateValuesFromFile(v);
+  if (playing_) {
+    UpdateValuesFromMeterBuffer(v);
   }
 
   PushValue(v);
@@ -254,7 +248,7 @@ void AudioMonitor::paintGL()
     }
   }
 
-  if (all_zeroes && !file_) {
+  if (all_zeroes && !playing_) {
     // Optimize by disabling the update loop
     SetUpdateLoop(false);
   }
@@ -266,56 +260,18 @@ void AudioMonitor::mousePressEvent(QMouseEvent *)
   update();
 }
 
-void AudioMonitor::UpdateValuesFromFile(QVector<double>& v)
+void AudioMonitor::UpdateValuesFromMeterBuffer(QVector<double>& v)
 {
-  // Determines how many milliseconds have passed since last update
-  qint64 current_time = QDateTime::currentMSecsSinceEpoch();
-  qint64 time_passed = current_time - last_time_;
-  int abs_speed = qAbs(playback_speed_);
-
-  // Multiply by speed if the speed is not 1
-  if (abs_speed != 1) {
-    time_passed *= abs_speed;
-  }
-
-  // Convert ms to float seconds and determine how many bytes that is
-  qint64 bytes_to_read = params_.time_to_bytes(static_cast<double>(time_passed) * 0.001);
-
-  if (playback_speed_ < 0) {
-    // If reversing, jump back by the amount of bytes we're going to read
-    bytes_to_read = qMin(bytes_to_read, file_->pos());
-
-    file_->seek(file_->pos() - bytes_to_read);
-  }
-
-  // Read bytes in from file
-  QByteArray b = file_->read(bytes_to_read);
+  // Read whatever the output has played since the last update
+  QByteArray b = AudioManager::instance()->GetMeterBuffer()->Read(&meter_read_pos_, params_.samples_to_bytes(1));
 
-  if (playback_speed_ < 0) {
-    // If reversing, head back to where we were before the read so that the next read starts
-    // from where we left off
-    file_->seek(file_->pos() - bytes_to_read);
-  }
-
-  // If speed is not 1, transform it here
-  if (abs_speed != 1) {
-    int sample_sz = params_.samples_to_bytes(1);
-    int in_nb_samples = params_.bytes_to_samples(b.size());
-    int out_nb_samples = in_nb_samples / abs_speed;
-    QByteArray speed_adjusted(out_nb_samples * sample_sz, Qt::Uninitialized);
-
-    for (int i=0;i<out_nb_samples;i++) {
-      memcpy(speed_adjusted.data() + i * sample_sz,
-             b.constData() + i * abs_speed * sample_sz,
-             sample_sz);
-    }
-
-    b = speed_adjusted;
+  if (b.isEmpty()) {
+    // The output pulls in chunks, so we may repaint before the next one. Hold the last value rather
+    // than letting the meter flicker.
+    v = values_.last();
+  } else {
+    BytesToSampleSummary(b, v);
   }
-
-  BytesToSampleSummary(b, v);
-
-  last_time_ = current_time;
 }
 
 void AudioMonitor::PushValue(const QVector<double> &v)
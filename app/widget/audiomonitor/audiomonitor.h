@@ -55,7 +55,7 @@ protected:
 private:
   void SetUpdateLoop(bool e);
 
-  void UpdateValuesFromFile(QVector<double> &v);
+  void UpdateValuesFromMeterBuffer(QVector<double> &v);
 
   void PushValue(const QVector<double>& v);
 
@@ -65,10 +65,8 @@ private:
 
   AudioParams params_;
 
-  QIODevice* file_;
-  qint64 last_time_;
-
-  int playback_speed_;
+  bool playing_;
+  qint64 meter_read_pos_;
 
   QVector< QVector<double> > values_;
   QVector<bool> peaked_;
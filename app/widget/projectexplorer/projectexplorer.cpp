@@ -34,6 +34,7 @@
 #include "dialog/sequence/sequence.h"
 #include "projectexplorerundo.h"
 #include "task/precache/precachetask.h"
+#include "task/proxy/proxytask.h"
 #include "task/taskmanager.h"
 #include "widget/menu/menu.h"
 #include "widget/menu/menushared.h"
@@ -337,6 +338,9 @@ void ProjectExplorer::ShowContextMenu()
 
         connect(proxy_menu, &Menu::triggered, this, &ProjectExplorer::ContextMenuStartProxy);
       }
+
+      QAction* generate_proxy_action = menu.addAction(tr("Generate Proxy"));
+      connect(generate_proxy_action, &QAction::triggered, this, &ProjectExplorer::ContextMenuGenerateProxy);
     }
 
     Q_UNUSED(all_items_are_footage_or_sequence)
@@ -437,6 +441,21 @@ void ProjectExplorer::ContextMenuStartProxy(QAction *a)
   }
 }
 
+void ProjectExplorer::ContextMenuGenerateProxy()
+{
+  // To get here, the `context_menu_items_` must be all kFootage
+  foreach (Item* i, context_menu_items_) {
+    Footage* f = static_cast<Footage*>(i);
+    VideoStream* s = static_cast<VideoStream*>(f->get_first_enabled_stream_of_type(Stream::kVideo));
+
+    // Stills and image sequences are already intra-frame, there's nothing to gain from proxying them
+    if (s && s->video_type() == VideoStream::kVideoTypeVideo) {
+      ProxyTask* proxy_task = new ProxyTask(s);
+      TaskManager::instance()->AddTask(proxy_task);
+    }
+  }
+}
+
 Project *ProjectExplorer::project() const
 {
   return model_.project();
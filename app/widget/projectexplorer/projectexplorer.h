@@ -184,6 +184,8 @@ private slots:
 
   void ContextMenuStartProxy(QAction* a);
 
+  void ContextMenuGenerateProxy();
+
 };
 
 }
@@ -20,7 +20,6 @@
 
 #include "audiowaveformview.h"
 
-#include <QFile>
 #include <QPainter>
 #include <QtMath>
 
@@ -107,7 +106,7 @@ void AudioWaveformView::paintEvent(QPaintEvent *event)
       connect(cache.watcher, &QFutureWatcher<QPixmap>::finished, this, &AudioWaveformView::BackgroundCacheFinished);
       cache.watcher->setFuture(QtConcurrent::run(this,
                                                  &AudioWaveformView::DrawWaveform,
-                                                 playback_->CreatePlaybackDevice(),
+                                                 playback_->visual_waveform(),
                                                  wanted_info,
                                                  slice_start,
                                                  slice_end));
@@ -122,49 +121,24 @@ void AudioWaveformView::paintEvent(QPaintEvent *event)
   p.drawLine(playhead_x, 0, playhead_x, height());
 }
 
-QPixmap AudioWaveformView::DrawWaveform(QIODevice* fs, CachedWaveformInfo info, int slice_start, int slice_end) const
+QPixmap AudioWaveformView::DrawWaveform(AudioVisualWaveform waveform, CachedWaveformInfo info, int slice_start, int slice_end) const
 {
   QPixmap pixmap(slice_end - slice_start, info.size.height());
   pixmap.fill(Qt::transparent);
 
-  if (fs->open(QFile::ReadOnly)) {
+  QPainter wave_painter(&pixmap);
 
-    QPainter wave_painter(&pixmap);
+  // FIXME: Hardcoded color
+  wave_painter.setPen(QColor(64, 255, 160));
 
-    // FIXME: Hardcoded color
-    wave_painter.setPen(QColor(64, 255, 160));
+  // The waveform picks an appropriate level for our zoom, so we never have to touch the PCM
+  rational slice_start_time = rational::fromDouble(static_cast<double>(slice_start + info.scroll) / info.scale);
 
-    int drew = 0;
-
-    fs->seek(info.params.samples_to_bytes(ScreenToUnitRounded(slice_start)));
-
-    for (int x=slice_start; x<slice_end && !fs->atEnd(); x++) {
-      int samples_len = ScreenToUnitRounded(x+1) - ScreenToUnitRounded(x);
-      int max_read_size = info.params.samples_to_bytes(samples_len);
-
-      QByteArray read_buffer = fs->read(max_read_size);
-
-      // Detect whether we've reached EOF and recalculate sample count if so
-      if (read_buffer.size() < max_read_size) {
-        samples_len = info.params.bytes_to_samples(read_buffer.size());
-      }
-
-      QVector<AudioVisualWaveform::SamplePerChannel> samples = AudioVisualWaveform::SumSamples(reinterpret_cast<const float*>(read_buffer.constData()),
-                                                                                               samples_len,
-                                                                                               info.params.channel_count());
-
-      for (int i=0;i<info.params.channel_count();i++) {
-        AudioVisualWaveform::DrawSample(&wave_painter, samples, x - slice_start, 0, info.size.height());
-
-        drew++;
-      }
-    }
-
-    fs->close();
-
-  }
-
-  delete fs;
+  AudioVisualWaveform::DrawWaveform(&wave_painter,
+                                    QRect(0, 0, pixmap.width(), pixmap.height()),
+                                    info.scale,
+                                    waveform,
+                                    slice_start_time);
 
   return pixmap;
 }
@@ -72,7 +72,7 @@ private:
     QFutureWatcher<QPixmap>* watcher = nullptr;
   };
 
-  QPixmap DrawWaveform(QIODevice *fs, CachedWaveformInfo info, int slice_start, int slice_end) const;
+  QPixmap DrawWaveform(AudioVisualWaveform waveform, CachedWaveformInfo info, int slice_start, int slice_end) const;
 
   AudioPlaybackCache *playback_;
 
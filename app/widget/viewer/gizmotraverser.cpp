@@ -41,9 +41,10 @@ QVariant GizmoTraverser::ProcessShader(const Node *node, const TimeRange &range,
   return GenerateResolution();
 }
 
-QVariant GizmoTraverser::ProcessFrameGeneration(const Node *node, const GenerateJob &job)
+QVariant GizmoTraverser::ProcessFrameGeneration(const Node *node, const TimeRange &range, const GenerateJob &job)
 {
   Q_UNUSED(node)
+  Q_UNUSED(range)
   Q_UNUSED(job)
 
   return GenerateResolution();
@@ -43,7 +43,7 @@ protected:
     return size_;
   }
 
-  virtual QVariant ProcessFrameGeneration(const Node *node, const GenerateJob& job) override;
+  virtual QVariant ProcessFrameGeneration(const Node *node, const TimeRange &range, const GenerateJob& job) override;
 
   // FIXME: Do something about audio?
 
@@ -610,14 +610,20 @@ void ViewerWidget::RequestNextFrameForQueue()
   rational next_time = Timecode::timestamp_to_time(playback_queue_next_frame_,
                                                    timebase());
 
+  // Estimate when this frame will be shown so earlier frames get rendered first
+  qint64 frames_ahead = qAbs((playback_queue_next_frame_ - ruler()->GetTime()) / playback_speed_);
+  qint64 deadline = QDateTime::currentMSecsSinceEpoch()
+      + qRound64(frames_ahead * timebase().toDouble() * 1000.0);
+
   playback_queue_next_frame_ += playback_speed_;
 
   RenderTicketWatcher* watcher = new RenderTicketWatcher();
   connect(watcher, &RenderTicketWatcher::Finished, this, &ViewerWidget::RendererGeneratedFrameForQueue);
-  watcher->SetTicket(GetFrame(next_time, false));
+  watcher->SetTicket(GetFrame(next_time, false, RenderTicket::kPriorityPlayback, deadline));
 }
 
-RenderTicketPtr ViewerWidget::GetFrame(const rational &t, bool clear_render_queue)
+RenderTicketPtr ViewerWidget::GetFrame(const rational &t, bool clear_render_queue,
+                                       RenderTicket::Priority priority, qint64 deadline)
 {
   QByteArray cached_hash = GetConnectedNode()->video_frame_cache()->GetHash(t);
 
@@ -629,7 +635,7 @@ RenderTicketPtr ViewerWidget::GetFrame(const rational &t, bool clear_render_queu
       auto_cacher_.ClearVideoQueue();
     }
 
-    return auto_cacher_.GetSingleFrame(t);
+    return auto_cacher_.GetSingleFrame(t, priority, deadline);
   } else {
     // Frame has been cached, grab the frame
     RenderTicketPtr ticket = std::make_shared<RenderTicket>();
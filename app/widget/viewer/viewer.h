@@ -191,7 +191,9 @@ private:
 
   void RequestNextFrameForQueue();
 
-  RenderTicketPtr GetFrame(const rational& t, bool clear_render_queue);
+  RenderTicketPtr GetFrame(const rational& t, bool clear_render_queue,
+                           RenderTicket::Priority priority = RenderTicket::kPriorityInteractive,
+                           qint64 deadline = 0);
 
   void FinishPlayPreprocess();
 
@@ -83,6 +83,7 @@ MainWindow::MainWindow(QWidget *parent) :
   AppendProjectPanel();
   tool_panel_ = PanelManager::instance()->CreatePanel<ToolPanel>(this);
   task_man_panel_ = PanelManager::instance()->CreatePanel<TaskManagerPanel>(this);
+  render_queue_panel_ = PanelManager::instance()->CreatePanel<RenderQueuePanel>(this);
   AppendTimelinePanel();
   audio_monitor_panel_ = PanelManager::instance()->CreatePanel<AudioMonitorPanel>(this);
 
@@ -619,6 +620,10 @@ void MainWindow::SetDefaultLayout()
   task_man_panel_->setFloating(true);
   addDockWidget(Qt::BottomDockWidgetArea, task_man_panel_);
 
+  render_queue_panel_->hide();
+  render_queue_panel_->setFloating(true);
+  addDockWidget(Qt::BottomDockWidgetArea, render_queue_panel_);
+
   audio_monitor_panel_->show();
   addDockWidget(Qt::BottomDockWidgetArea, audio_monitor_panel_);
 
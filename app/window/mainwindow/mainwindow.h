@@ -32,6 +32,7 @@
 #include "panel/project/project.h"
 #include "panel/scope/scope.h"
 #include "panel/table/table.h"
+#include "panel/renderqueue/renderqueuepanel.h"
 #include "panel/taskmanager/taskmanager.h"
 #include "panel/timeline/timeline.h"
 #include "panel/tool/tool.h"
@@ -146,6 +147,7 @@ private:
   QList<TimelinePanel*> timeline_panels_;
   AudioMonitorPanel* audio_monitor_panel_;
   TaskManagerPanel* task_man_panel_;
+  RenderQueuePanel* render_queue_panel_;
   PixelSamplerPanel* pixel_sampler_panel_;
   QList<ScopePanel*> scope_panels_;
   NodeTablePanel* table_panel_;
@@ -0,0 +1,162 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "ticktest.h"
+
+#include <QMap>
+#include <QtTest>
+
+#include "common/tick.h"
+
+namespace olive {
+
+namespace {
+
+// Length of time checked in each timebase, in seconds
+const int kRoundTripLength = 3600;
+
+// Step between the units checked, prime so a wide spread of remainders is covered
+const int kRoundTripStep = 997;
+
+// Frames in the benchmarked maps, about an hour at 29.97
+const int kMapSize = 108000;
+
+}
+
+void TickTest::RoundTrip_data()
+{
+  QTest::addColumn<rational>("timebase");
+
+  QTest::newRow("23.976") << rational(1001, 24000);
+  QTest::newRow("29.97") << rational(1001, 30000);
+  QTest::newRow("25") << rational(1, 25);
+  QTest::newRow("44100") << rational(1, 44100);
+  QTest::newRow("48000") << rational(1, 48000);
+}
+
+void TickTest::RoundTrip()
+{
+  QFETCH(rational, timebase);
+
+  QVERIFY(Tick::is_exact(timebase));
+
+  int64_t ticks_per_unit = Tick::per_timebase(timebase);
+  QVERIFY(ticks_per_unit > 0);
+
+  int64_t count = qRound64(kRoundTripLength / timebase.toDouble());
+
+  for (int64_t i=-count; i<=count; i+=kRoundTripStep) {
+    rational time = timebase * rational(i);
+    int64_t ticks = Tick::from_time(time);
+
+    QCOMPARE(ticks, ticks_per_unit * i);
+    QVERIFY(Tick::to_time(ticks) == time);
+  }
+}
+
+void TickTest::RoundsInexactTimebases()
+{
+  // 705600000/11 = 64145454.55, rounds up
+  QVERIFY(!Tick::is_exact(rational(1, 11)));
+  QCOMPARE(Tick::from_time(rational(1, 11)), int64_t(64145455));
+  QCOMPARE(Tick::from_time(rational(-1, 11)), int64_t(-64145455));
+
+  // 705600000/13 = 54276923.08, rounds down
+  QCOMPARE(Tick::from_time(rational(1, 13)), int64_t(54276923));
+  QCOMPARE(Tick::from_time(rational(-1, 13)), int64_t(-54276923));
+
+  // Exactly half a tick rounds away from zero
+  QCOMPARE(Tick::from_time(rational(1, Tick::kPerSecond * 2)), int64_t(1));
+  QCOMPARE(Tick::from_time(rational(-1, Tick::kPerSecond * 2)), int64_t(-1));
+
+  // Whole seconds are still exact
+  QCOMPARE(Tick::from_time(rational(12, 11) - rational(1, 11)), Tick::kPerSecond);
+
+  // Timebases that aren't a whole number of ticks can't be stepped through in ticks
+  QCOMPARE(Tick::per_timebase(rational(1, 11)), int64_t(0));
+}
+
+void TickTest::ClampsToInt64()
+{
+  QCOMPARE(Tick::from_time(RATIONAL_MAX), int64_t(INT64_MAX));
+  QCOMPARE(Tick::from_time(RATIONAL_MIN), int64_t(INT64_MIN));
+
+  QVERIFY(Tick::to_time(INT64_MAX) == RATIONAL_MAX);
+  QVERIFY(Tick::to_time(INT64_MIN) == RATIONAL_MIN);
+
+  // Largest amount of seconds that isn't clamped
+  int64_t largest = (INT64_MAX - Tick::kPerSecond) / Tick::kPerSecond;
+
+  QCOMPARE(Tick::from_time(rational(largest)), largest * Tick::kPerSecond);
+  QCOMPARE(Tick::from_time(rational(-largest)), -largest * Tick::kPerSecond);
+
+  QCOMPARE(Tick::from_time(rational(largest + 1)), int64_t(INT64_MAX));
+  QCOMPARE(Tick::from_time(rational(-largest - 1)), int64_t(INT64_MIN));
+}
+
+void TickTest::BenchmarkMapLookup_data()
+{
+  QTest::addColumn<bool>("ticks");
+
+  QTest::newRow("rational") << false;
+  QTest::newRow("ticks") << true;
+}
+
+void TickTest::BenchmarkMapLookup()
+{
+  QFETCH(bool, ticks);
+
+  // Same shape as FrameHashCache's map, looked up by the times frames are rendered at
+  QVector<rational> times(kMapSize);
+  QMap<rational, int> rational_map;
+  QMap<int64_t, int> tick_map;
+
+  for (int i=0; i<kMapSize; i++) {
+    times[i] = rational(int64_t(i) * 1001, 30000);
+
+    if (ticks) {
+      tick_map.insert(Tick::from_time(times.at(i)), i);
+    } else {
+      rational_map.insert(times.at(i), i);
+    }
+  }
+
+  int index = 0;
+  int64_t sum = 0;
+
+  if (ticks) {
+    QBENCHMARK {
+      // Converting is part of every lookup, FrameHashCache is given rational times
+      sum += tick_map.value(Tick::from_time(times.at(index)));
+      index = (index + 7919) % kMapSize;
+    }
+  } else {
+    QBENCHMARK {
+      sum += rational_map.value(times.at(index));
+      index = (index + 7919) % kMapSize;
+    }
+  }
+
+  Q_UNUSED(sum)
+}
+
+}
+
+QTEST_APPLESS_MAIN(olive::TickTest)
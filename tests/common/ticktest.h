@@ -0,0 +1,54 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef TICKTEST_H
+#define TICKTEST_H
+
+#include <QObject>
+
+namespace olive {
+
+/**
+ * @brief Checks that Tick converts common timebases losslessly and benchmarks tick-keyed maps
+ */
+class TickTest : public QObject
+{
+  Q_OBJECT
+public:
+  TickTest() = default;
+
+private slots:
+  void RoundTrip_data();
+
+  void RoundTrip();
+
+  void RoundsInexactTimebases();
+
+  void ClampsToInt64();
+
+  void BenchmarkMapLookup_data();
+
+  void BenchmarkMapLookup();
+
+};
+
+}
+
+#endif // TICKTEST_H
@@ -0,0 +1,309 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "timerangetest.h"
+
+#include <QtTest>
+
+namespace olive {
+
+namespace {
+
+// Frames covered by the randomized tests
+const int kReferenceLength = 512;
+
+// Operations applied in the randomized tests
+const int kOperationCount = 2000;
+
+// Longest range the randomized tests insert or remove, in frames
+const int kMaxRangeLength = 12;
+
+// Ranges in the benchmark lists, each separated by a gap
+const int kFragmentCount = 10000;
+
+// Frames the Intersects() benchmark queries at a time, about what a zoomed out timeline shows
+const int kQueryLength = 2000;
+
+// Every time is on an NTSC timebase, so the arithmetic is the same GCD-heavy kind caches do
+rational Frame(int64_t index)
+{
+  return rational(index * 1001, 30000);
+}
+
+// Small deterministic generator so failures are reproducible
+quint32 Random(quint32* state)
+{
+  *state = *state * 1664525u + 1013904223u;
+  return *state >> 8;
+}
+
+}
+
+void TimeRangeListTest::InsertKeepsListCoalesced()
+{
+  TimeRangeList list;
+  QVector<bool> frames(kReferenceLength, false);
+  quint32 seed = 1;
+
+  for (int i=0; i<kOperationCount; i++) {
+    int in = Random(&seed) % kReferenceLength;
+    int out = qMin(kReferenceLength, in + 1 + int(Random(&seed) % kMaxRangeLength));
+
+    list.insert(TimeRange(Frame(in), Frame(out)));
+
+    for (int j=in; j<out; j++) {
+      frames[j] = true;
+    }
+
+    VerifyCoalesced(list);
+    if (QTest::currentTestFailed()) {
+      return;
+    }
+  }
+
+  VerifyMatches(list, frames);
+}
+
+void TimeRangeListTest::RemoveKeepsListCoalesced()
+{
+  TimeRangeList list;
+  QVector<bool> frames(kReferenceLength, false);
+  quint32 seed = 2;
+
+  for (int i=0; i<kOperationCount; i++) {
+    int in = Random(&seed) % kReferenceLength;
+    int out = qMin(kReferenceLength, in + 1 + int(Random(&seed) % kMaxRangeLength));
+
+    // Insert a little more often than removing so the list doesn't stay empty
+    bool insert = (Random(&seed) % 5 < 3);
+
+    if (insert) {
+      list.insert(TimeRange(Frame(in), Frame(out)));
+    } else {
+      list.remove(TimeRange(Frame(in), Frame(out)));
+    }
+
+    for (int j=in; j<out; j++) {
+      frames[j] = insert;
+    }
+
+    VerifyCoalesced(list);
+    if (QTest::currentTestFailed()) {
+      return;
+    }
+
+    VerifyMatches(list, frames);
+    if (QTest::currentTestFailed()) {
+      return;
+    }
+  }
+}
+
+void TimeRangeListTest::RemoveIgnoresZeroLength()
+{
+  TimeRangeList list = {TimeRange(0, 10)};
+
+  list.remove(TimeRange(5, 5));
+
+  QCOMPARE(list.size(), 1);
+  QVERIFY(list.first() == TimeRange(0, 10));
+
+  // Zero-length ranges at either end don't do anything either
+  list.remove(TimeRange(0, 0));
+  list.remove(TimeRange(10, 10));
+
+  QCOMPARE(list.size(), 1);
+  QVERIFY(list.first() == TimeRange(0, 10));
+}
+
+void TimeRangeListTest::InsertList_data()
+{
+  QTest::addColumn<QVector<TimeRange> >("a");
+  QTest::addColumn<QVector<TimeRange> >("b");
+  QTest::addColumn<QVector<TimeRange> >("expected");
+
+  QTest::newRow("disjoint")
+      << QVector<TimeRange>({TimeRange(0, 1), TimeRange(4, 5)})
+      << QVector<TimeRange>({TimeRange(2, 3), TimeRange(6, 7)})
+      << QVector<TimeRange>({TimeRange(0, 1), TimeRange(2, 3), TimeRange(4, 5), TimeRange(6, 7)});
+
+  QTest::newRow("touching")
+      << QVector<TimeRange>({TimeRange(0, 2)})
+      << QVector<TimeRange>({TimeRange(2, 4)})
+      << QVector<TimeRange>({TimeRange(0, 4)});
+
+  QTest::newRow("overlapping")
+      << QVector<TimeRange>({TimeRange(0, 3), TimeRange(6, 9)})
+      << QVector<TimeRange>({TimeRange(2, 7)})
+      << QVector<TimeRange>({TimeRange(0, 9)});
+
+  QTest::newRow("contained")
+      << QVector<TimeRange>({TimeRange(0, 10)})
+      << QVector<TimeRange>({TimeRange(2, 3), TimeRange(5, 6)})
+      << QVector<TimeRange>({TimeRange(0, 10)});
+
+  QTest::newRow("bridging")
+      << QVector<TimeRange>({TimeRange(0, 1), TimeRange(2, 3), TimeRange(4, 5)})
+      << QVector<TimeRange>({TimeRange(1, 2), TimeRange(3, 4)})
+      << QVector<TimeRange>({TimeRange(0, 5)});
+
+  QTest::newRow("into empty")
+      << QVector<TimeRange>()
+      << QVector<TimeRange>({TimeRange(1, 2), TimeRange(3, 4)})
+      << QVector<TimeRange>({TimeRange(1, 2), TimeRange(3, 4)});
+
+  QTest::newRow("from empty")
+      << QVector<TimeRange>({TimeRange(1, 2)})
+      << QVector<TimeRange>()
+      << QVector<TimeRange>({TimeRange(1, 2)});
+}
+
+void TimeRangeListTest::InsertList()
+{
+  QFETCH(QVector<TimeRange>, a);
+  QFETCH(QVector<TimeRange>, b);
+  QFETCH(QVector<TimeRange>, expected);
+
+  TimeRangeList list;
+  TimeRangeList other;
+  TimeRangeList one_at_a_time;
+
+  foreach (const TimeRange& r, a) {
+    list.insert(r);
+    one_at_a_time.insert(r);
+  }
+
+  foreach (const TimeRange& r, b) {
+    other.insert(r);
+    one_at_a_time.insert(r);
+  }
+
+  list.insert(other);
+
+  VerifyCoalesced(list);
+  QVERIFY(list.internal_array() == expected);
+
+  // Merging lists must give the same result as inserting each range
+  QVERIFY(list.internal_array() == one_at_a_time.internal_array());
+}
+
+void TimeRangeListTest::Intersects()
+{
+  TimeRangeList list = {TimeRange(0, 2), TimeRange(4, 6), TimeRange(8, 10)};
+
+  TimeRangeList cropped = list.Intersects(TimeRange(1, 9));
+
+  QVERIFY(cropped.internal_array() == QVector<TimeRange>({TimeRange(1, 2), TimeRange(4, 6), TimeRange(8, 9)}));
+
+  // Ranges that only touch the query aren't included
+  QVERIFY(list.Intersects(TimeRange(2, 4)).isEmpty());
+}
+
+void TimeRangeListTest::BenchmarkInsertRemove()
+{
+  TimeRangeList list = CreateFragmentedList(kFragmentCount);
+  int gap = 0;
+
+  QBENCHMARK {
+    // Fill a gap, which merges two ranges, and open it again, so the list keeps the same shape
+    TimeRange r(Frame(gap * 2 + 1), Frame(gap * 2 + 2));
+
+    list.insert(r);
+    list.remove(r);
+
+    gap = (gap + 7919) % (kFragmentCount - 1);
+  }
+
+  QCOMPARE(list.size(), kFragmentCount);
+}
+
+void TimeRangeListTest::BenchmarkIntersects()
+{
+  TimeRangeList list = CreateFragmentedList(kFragmentCount);
+  int start = 0;
+
+  QBENCHMARK {
+    TimeRangeList visible = list.Intersects(TimeRange(Frame(start), Frame(start + kQueryLength)));
+    Q_UNUSED(visible)
+
+    start = (start + 7919) % (kFragmentCount * 2 - kQueryLength);
+  }
+}
+
+void TimeRangeListTest::BenchmarkContains()
+{
+  TimeRangeList list = CreateFragmentedList(kFragmentCount);
+  int frame = 0;
+  int found = 0;
+
+  QBENCHMARK {
+    if (list.contains(TimeRange(Frame(frame), Frame(frame + 1)))) {
+      found++;
+    }
+
+    frame = (frame + 7919) % (kFragmentCount * 2);
+  }
+
+  Q_UNUSED(found)
+}
+
+void TimeRangeListTest::VerifyCoalesced(const TimeRangeList &list)
+{
+  for (int i=0; i<list.size(); i++) {
+    const TimeRange& r = list.internal_array().at(i);
+
+    QVERIFY2(r.in() < r.out(), "list contains an empty range");
+
+    if (i > 0) {
+      QVERIFY2(list.internal_array().at(i - 1).out() < r.in(), "ranges overlap, touch, or are out of order");
+    }
+  }
+}
+
+void TimeRangeListTest::VerifyMatches(const TimeRangeList &list, const QVector<bool> &frames)
+{
+  int runs = 0;
+
+  for (int i=0; i<frames.size(); i++) {
+    QCOMPARE(list.contains(TimeRange(Frame(i), Frame(i + 1))), frames.at(i));
+
+    if (frames.at(i) && (i == 0 || !frames.at(i - 1))) {
+      runs++;
+    }
+  }
+
+  // Coalesced, so there's exactly one range per run of frames
+  QCOMPARE(list.size(), runs);
+}
+
+TimeRangeList TimeRangeListTest::CreateFragmentedList(int count)
+{
+  TimeRangeList list;
+
+  for (int i=0; i<count; i++) {
+    list.insert(TimeRange(Frame(i * 2), Frame(i * 2 + 1)));
+  }
+
+  return list;
+}
+
+}
+
+QTEST_APPLESS_MAIN(olive::TimeRangeListTest)
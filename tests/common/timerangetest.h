@@ -0,0 +1,74 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef TIMERANGETEST_H
+#define TIMERANGETEST_H
+
+#include <QObject>
+#include <QVector>
+
+#include "common/timerange.h"
+
+namespace olive {
+
+/**
+ * @brief Checks that TimeRangeList stays sorted and coalesced, and benchmarks how caches use it
+ *
+ * PlaybackCache and PreviewAutoCacher keep long, fragmented lists of invalidated ranges that are
+ * constantly added to, removed from, and queried around the playhead, so the benchmarks run those
+ * operations on a list of many small ranges.
+ */
+class TimeRangeListTest : public QObject
+{
+  Q_OBJECT
+public:
+  TimeRangeListTest() = default;
+
+private slots:
+  void InsertKeepsListCoalesced();
+
+  void RemoveKeepsListCoalesced();
+
+  void RemoveIgnoresZeroLength();
+
+  void InsertList_data();
+
+  void InsertList();
+
+  void Intersects();
+
+  void BenchmarkInsertRemove();
+
+  void BenchmarkIntersects();
+
+  void BenchmarkContains();
+
+private:
+  static void VerifyCoalesced(const TimeRangeList& list);
+
+  static void VerifyMatches(const TimeRangeList& list, const QVector<bool>& frames);
+
+  static TimeRangeList CreateFragmentedList(int count);
+
+};
+
+}
+
+#endif // TIMERANGETEST_H
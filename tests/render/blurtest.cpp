@@ -0,0 +1,333 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "blurtest.h"
+
+#include <QFile>
+#include <QMatrix4x4>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QtTest>
+#include <QVector2D>
+
+namespace olive {
+
+namespace {
+
+const int kSize = 256;
+
+// Matches METHOD_BOX_BLUR and METHOD_GAUSSIAN_BLUR in blur.frag
+const int kMethodBox = 0;
+const int kMethodGaussian = 1;
+
+const GLfloat kBlitVertices[] = {
+  -1.0f, -1.0f, 0.0f,
+  1.0f, -1.0f, 0.0f,
+  1.0f, 1.0f, 0.0f,
+
+  -1.0f, -1.0f, 0.0f,
+  -1.0f, 1.0f, 0.0f,
+  1.0f, 1.0f, 0.0f
+};
+
+const GLfloat kBlitTexCoords[] = {
+  0.0f, 0.0f,
+  1.0f, 0.0f,
+  1.0f, 1.0f,
+
+  0.0f, 0.0f,
+  0.0f, 1.0f,
+  1.0f, 1.0f
+};
+
+QString ReadFile(const QString& filename)
+{
+  QFile file(filename);
+
+  if (!file.open(QFile::ReadOnly)) {
+    return QString();
+  }
+
+  return QString::fromUtf8(file.readAll());
+}
+
+// Whether pixel (x, y) is inside the square from `start` to `end`
+bool InSquare(int x, int y, int start, int end)
+{
+  return x >= start && x < end && y >= start && y < end;
+}
+
+}
+
+BlurTest::BlurTest() :
+  vert_vbo_(QOpenGLBuffer::VertexBuffer),
+  frag_vbo_(QOpenGLBuffer::VertexBuffer),
+  reference_program_(nullptr),
+  program_(nullptr),
+  input_texture_(0)
+{
+}
+
+void BlurTest::initTestCase()
+{
+  // Match the version OpenGLRenderer asks for
+  QSurfaceFormat format;
+  format.setVersion(3, 2);
+  format.setProfile(QSurfaceFormat::CoreProfile);
+
+  context_.setFormat(format);
+  surface_.setFormat(format);
+  surface_.create();
+
+  if (!context_.create() || !context_.makeCurrent(&surface_)) {
+    QSKIP("No OpenGL context available");
+  }
+
+  QOpenGLExtraFunctions* f = context_.extraFunctions();
+
+  // A large white square with a small red one beside it, so both broad edges and fine detail are
+  // blurred, on an opaque black background
+  QVector<uchar> image(kSize * kSize * 4, 0);
+
+  for (int y=0; y<kSize; y++) {
+    for (int x=0; x<kSize; x++) {
+      uchar* pixel = image.data() + (y * kSize + x) * 4;
+
+      if (InSquare(x, y, 64, 160)) {
+        pixel[0] = pixel[1] = pixel[2] = 255;
+      } else if (InSquare(x, y, 184, 200)) {
+        pixel[0] = 255;
+      }
+
+      pixel[3] = 255;
+    }
+  }
+
+  // Blur uses mipmapped interpolation by default, like OpenGLRenderer::PrepareInputTexture() sets up
+  f->glGenTextures(1, &input_texture_);
+  f->glBindTexture(GL_TEXTURE_2D, input_texture_);
+  f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kSize, kSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.constData());
+  f->glGenerateMipmap(GL_TEXTURE_2D);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  f->glBindTexture(GL_TEXTURE_2D, 0);
+
+  vao_.create();
+  vao_.bind();
+
+  vert_vbo_.create();
+  vert_vbo_.bind();
+  vert_vbo_.allocate(kBlitVertices, sizeof(kBlitVertices));
+  vert_vbo_.release();
+
+  frag_vbo_.create();
+  frag_vbo_.bind();
+  frag_vbo_.allocate(kBlitTexCoords, sizeof(kBlitTexCoords));
+  frag_vbo_.release();
+
+  reference_program_ = CreateProgram(QStringLiteral(OLIVE_TEST_DIR "/render/blur_reference.frag"));
+  program_ = CreateProgram(QStringLiteral(OLIVE_SHADER_DIR "/blur.frag"));
+
+  QVERIFY(reference_program_);
+  QVERIFY(program_);
+}
+
+void BlurTest::cleanupTestCase()
+{
+  if (!QOpenGLContext::currentContext()) {
+    return;
+  }
+
+  delete reference_program_;
+  delete program_;
+
+  frag_vbo_.destroy();
+  vert_vbo_.destroy();
+  vao_.destroy();
+
+  context_.functions()->glDeleteTextures(1, &input_texture_);
+
+  context_.doneCurrent();
+}
+
+void BlurTest::CompareToReference_data()
+{
+  QTest::addColumn<int>("method");
+  QTest::addColumn<float>("radius");
+  QTest::addColumn<bool>("repeat_edges");
+
+  // Largest difference in any channel allowed, out of 255
+  QTest::addColumn<int>("tolerance");
+
+  // Few enough samples that no mipmap is used, these should only differ by rounding
+  QTest::newRow("box 4") << kMethodBox << 4.0f << false << 2;
+  QTest::newRow("box 40") << kMethodBox << 40.0f << false << 2;
+  QTest::newRow("gaussian 4") << kMethodGaussian << 4.0f << false << 2;
+  QTest::newRow("gaussian 16") << kMethodGaussian << 16.0f << false << 2;
+
+  // Sampled from mipmap levels 1 and 2
+  QTest::newRow("box 80") << kMethodBox << 80.0f << false << 8;
+  QTest::newRow("box 120") << kMethodBox << 120.0f << false << 8;
+  QTest::newRow("box 120 repeat edges") << kMethodBox << 120.0f << true << 8;
+  QTest::newRow("gaussian 24") << kMethodGaussian << 24.0f << false << 8;
+  QTest::newRow("gaussian 40") << kMethodGaussian << 40.0f << false << 8;
+  QTest::newRow("gaussian 40 repeat edges") << kMethodGaussian << 40.0f << true << 8;
+}
+
+void BlurTest::CompareToReference()
+{
+  QFETCH(int, method);
+  QFETCH(float, radius);
+  QFETCH(bool, repeat_edges);
+  QFETCH(int, tolerance);
+
+  QVector<uchar> reference = Render(reference_program_, method, radius, repeat_edges);
+  QVector<uchar> result = Render(program_, method, radius, repeat_edges);
+
+  int max_difference = 0;
+  int max_x = 0;
+  int max_y = 0;
+
+  for (int y=0; y<kSize; y++) {
+    for (int x=0; x<kSize; x++) {
+      for (int c=0; c<4; c++) {
+        int i = (y * kSize + x) * 4 + c;
+        int difference = qAbs(int(reference.at(i)) - int(result.at(i)));
+
+        if (difference > max_difference) {
+          max_difference = difference;
+          max_x = x;
+          max_y = y;
+        }
+      }
+    }
+  }
+
+  QVERIFY2(max_difference <= tolerance,
+           qPrintable(QStringLiteral("Pixel %1, %2 differs by %3")
+                      .arg(QString::number(max_x), QString::number(max_y), QString::number(max_difference))));
+}
+
+QOpenGLShaderProgram *BlurTest::CreateProgram(const QString &frag_filename)
+{
+  // Same preamble as OpenGLRenderer::CreateNativeShader()
+  QString preamble = QStringLiteral("#version 150\n\n");
+
+  QOpenGLShaderProgram* program = new QOpenGLShaderProgram();
+
+  if (!program->addShaderFromSourceCode(QOpenGLShader::Vertex, preamble + ReadFile(QStringLiteral(OLIVE_SHADER_DIR "/default.vert")))
+      || !program->addShaderFromSourceCode(QOpenGLShader::Fragment, preamble + ReadFile(frag_filename))
+      || !program->link()) {
+    delete program;
+    return nullptr;
+  }
+
+  return program;
+}
+
+QVector<uchar> BlurTest::Render(QOpenGLShaderProgram *program, int method, float radius, bool repeat_edges)
+{
+  QOpenGLExtraFunctions* f = context_.extraFunctions();
+
+  program->bind();
+
+  program->setUniformValue("ove_mvpmat", QMatrix4x4());
+  program->setUniformValue("tex_in", 0);
+  program->setUniformValue("method_in", method);
+  program->setUniformValue("radius_in", radius);
+  program->setUniformValue("horiz_in", 1);
+  program->setUniformValue("vert_in", 1);
+  program->setUniformValue("repeat_edge_pixels_in", int(repeat_edges));
+  program->setUniformValue("resolution_in", QVector2D(kSize, kSize));
+
+  // Horizontal pass into a half float texture, like OpenGLRenderer::Blit() iterates
+  QOpenGLFramebufferObject horizontal(kSize, kSize, QOpenGLFramebufferObject::NoAttachment, GL_TEXTURE_2D, GL_RGBA16F);
+  QOpenGLFramebufferObject destination(kSize, kSize);
+
+  f->glActiveTexture(GL_TEXTURE0);
+
+  program->setUniformValue("ove_iteration", 0);
+
+  horizontal.bind();
+  f->glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+  f->glClear(GL_COLOR_BUFFER_BIT);
+  f->glBindTexture(GL_TEXTURE_2D, input_texture_);
+  Draw(program);
+
+  // Vertical pass from the horizontal pass, which is mipmapped again as the iterative input
+  program->setUniformValue("ove_iteration", 1);
+
+  destination.bind();
+  f->glClear(GL_COLOR_BUFFER_BIT);
+  f->glBindTexture(GL_TEXTURE_2D, horizontal.texture());
+  f->glGenerateMipmap(GL_TEXTURE_2D);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  Draw(program);
+
+  QVector<uchar> pixels = ReadPixels();
+
+  destination.release();
+  program->release();
+
+  f->glBindTexture(GL_TEXTURE_2D, 0);
+
+  return pixels;
+}
+
+QVector<uchar> BlurTest::ReadPixels()
+{
+  QVector<uchar> pixels(kSize * kSize * 4);
+
+  context_.functions()->glReadPixels(0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+  return pixels;
+}
+
+void BlurTest::Draw(QOpenGLShaderProgram *program)
+{
+  QOpenGLExtraFunctions* f = context_.extraFunctions();
+
+  f->glViewport(0, 0, kSize, kSize);
+
+  vao_.bind();
+
+  vert_vbo_.bind();
+  program->enableAttributeArray("a_position");
+  program->setAttributeBuffer("a_position", GL_FLOAT, 0, 3);
+  vert_vbo_.release();
+
+  frag_vbo_.bind();
+  program->enableAttributeArray("a_texcoord");
+  program->setAttributeBuffer("a_texcoord", GL_FLOAT, 0, 2);
+  frag_vbo_.release();
+
+  f->glDrawArrays(GL_TRIANGLES, 0, 6);
+
+  vao_.release();
+}
+
+}
+
+QTEST_MAIN(olive::BlurTest)
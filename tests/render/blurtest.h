@@ -0,0 +1,83 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef BLURTEST_H
+#define BLURTEST_H
+
+#include <QOffscreenSurface>
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QObject>
+
+namespace olive {
+
+/**
+ * @brief Checks that blur.frag still matches the per-texel blur it replaced
+ *
+ * Small radii sample the same texels as before and should match to rounding. Large radii sample a
+ * mipmap instead, which softens the kernel slightly, so they're allowed a little more difference.
+ */
+class BlurTest : public QObject
+{
+  Q_OBJECT
+public:
+  BlurTest();
+
+private slots:
+  void initTestCase();
+
+  void cleanupTestCase();
+
+  void CompareToReference_data();
+
+  void CompareToReference();
+
+private:
+  QOpenGLShaderProgram* CreateProgram(const QString& frag_filename);
+
+  QVector<uchar> Render(QOpenGLShaderProgram* program, int method, float radius, bool repeat_edges);
+
+  QVector<uchar> ReadPixels();
+
+  void Draw(QOpenGLShaderProgram* program);
+
+  QOffscreenSurface surface_;
+
+  QOpenGLContext context_;
+
+  QOpenGLVertexArrayObject vao_;
+
+  QOpenGLBuffer vert_vbo_;
+
+  QOpenGLBuffer frag_vbo_;
+
+  QOpenGLShaderProgram* reference_program_;
+
+  QOpenGLShaderProgram* program_;
+
+  GLuint input_texture_;
+
+};
+
+}
+
+#endif // BLURTEST_H
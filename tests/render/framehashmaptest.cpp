@@ -0,0 +1,163 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "framehashmaptest.h"
+
+#include <QtTest>
+
+namespace olive {
+
+namespace {
+
+// Frames in each map tested
+const int kFrameCount = 10;
+
+}
+
+void FrameHashMapTest::ShiftForward_data()
+{
+  AddTimebases();
+}
+
+void FrameHashMapTest::ShiftForward()
+{
+  QFETCH(rational, timebase);
+
+  FrameHashMap map = CreateMap(timebase, kFrameCount);
+
+  map.Shift(timebase * rational(5), timebase * rational(7));
+
+  QCOMPARE(map.Count(), kFrameCount);
+
+  // Frames before the shift are untouched
+  for (int i=0; i<5; i++) {
+    QCOMPARE(map.GetHash(timebase * rational(i)), HashOf(i));
+  }
+
+  // The gap that was opened up is empty
+  QVERIFY(map.GetHash(timebase * rational(5)).isEmpty());
+  QVERIFY(map.GetHash(timebase * rational(6)).isEmpty());
+
+  for (int i=5; i<kFrameCount; i++) {
+    QCOMPARE(map.GetHash(timebase * rational(i + 2)), HashOf(i));
+  }
+}
+
+void FrameHashMapTest::ShiftBackward_data()
+{
+  AddTimebases();
+}
+
+void FrameHashMapTest::ShiftBackward()
+{
+  QFETCH(rational, timebase);
+
+  FrameHashMap map = CreateMap(timebase, kFrameCount);
+
+  map.Shift(timebase * rational(5), timebase * rational(3));
+
+  // Frames 3 and 4 were overwritten
+  QCOMPARE(map.Count(), kFrameCount - 2);
+
+  for (int i=0; i<3; i++) {
+    QCOMPARE(map.GetHash(timebase * rational(i)), HashOf(i));
+  }
+
+  for (int i=5; i<kFrameCount; i++) {
+    QCOMPARE(map.GetHash(timebase * rational(i - 2)), HashOf(i));
+  }
+
+  QVERIFY(map.GetHash(timebase * rational(kFrameCount - 2)).isEmpty());
+  QVERIFY(map.GetHash(timebase * rational(kFrameCount - 1)).isEmpty());
+}
+
+void FrameHashMapTest::Truncate_data()
+{
+  AddTimebases();
+}
+
+void FrameHashMapTest::Truncate()
+{
+  QFETCH(rational, timebase);
+
+  FrameHashMap map = CreateMap(timebase, kFrameCount);
+
+  // Lengthening doesn't remove anything
+  map.Truncate(timebase * rational(kFrameCount));
+  QCOMPARE(map.Count(), kFrameCount);
+
+  map.Truncate(timebase * rational(6));
+  QCOMPARE(map.Count(), 6);
+
+  for (int i=0; i<6; i++) {
+    QCOMPARE(map.GetHash(timebase * rational(i)), HashOf(i));
+  }
+
+  QVERIFY(map.GetHash(timebase * rational(6)).isEmpty());
+}
+
+void FrameHashMapTest::TakeFramesWithHash()
+{
+  rational timebase(1001, 30000);
+
+  FrameHashMap map = CreateMap(timebase, kFrameCount);
+
+  map.SetHash(timebase * rational(7), HashOf(2));
+
+  QList<rational> taken = map.TakeFramesWithHash(HashOf(2));
+
+  QCOMPARE(taken.size(), 2);
+  QVERIFY(taken.at(0) == timebase * rational(2));
+  QVERIFY(taken.at(1) == timebase * rational(7));
+
+  QCOMPARE(map.Count(), kFrameCount - 2);
+  QVERIFY(map.GetFramesWithHash(HashOf(2)).isEmpty());
+}
+
+void FrameHashMapTest::AddTimebases()
+{
+  QTest::addColumn<rational>("timebase");
+
+  QTest::newRow("29.97") << rational(1001, 30000);
+  QTest::newRow("25") << rational(1, 25);
+
+  // Doesn't convert to ticks exactly, but frames are still far more than a tick apart
+  QTest::newRow("inexact") << rational(1, 11);
+}
+
+FrameHashMap FrameHashMapTest::CreateMap(const rational &timebase, int count)
+{
+  FrameHashMap map;
+
+  for (int i=0; i<count; i++) {
+    map.SetHash(timebase * rational(i), HashOf(i));
+  }
+
+  return map;
+}
+
+QByteArray FrameHashMapTest::HashOf(int frame)
+{
+  return QByteArray::number(frame);
+}
+
+}
+
+QTEST_APPLESS_MAIN(olive::FrameHashMapTest)
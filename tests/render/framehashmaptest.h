@@ -0,0 +1,65 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef FRAMEHASHMAPTEST_H
+#define FRAMEHASHMAPTEST_H
+
+#include <QObject>
+
+#include "render/framehashmap.h"
+
+namespace olive {
+
+/**
+ * @brief Checks the FrameHashMap operations that search the map by ticks rather than scan it
+ */
+class FrameHashMapTest : public QObject
+{
+  Q_OBJECT
+public:
+  FrameHashMapTest() = default;
+
+private slots:
+  void ShiftForward_data();
+
+  void ShiftForward();
+
+  void ShiftBackward_data();
+
+  void ShiftBackward();
+
+  void Truncate_data();
+
+  void Truncate();
+
+  void TakeFramesWithHash();
+
+private:
+  static void AddTimebases();
+
+  static FrameHashMap CreateMap(const rational& timebase, int count);
+
+  static QByteArray HashOf(int frame);
+
+};
+
+}
+
+#endif // FRAMEHASHMAPTEST_H
@@ -0,0 +1,369 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "stroketest.h"
+
+#include <cstring>
+#include <QFile>
+#include <QMatrix4x4>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QtMath>
+#include <QtTest>
+#include <QVector2D>
+
+namespace olive {
+
+namespace {
+
+const int kSize = 256;
+
+// Circle that's stroked, in pixels
+const float kShapeRadius = 64.0f;
+const float kShapeCenter = kSize / 2;
+
+// How far from the ideal stroke edge the two shaders may disagree, in pixels
+const float kEdgeTolerance = 2.5f;
+
+// Largest difference in any channel allowed everywhere else, out of 255, to allow for rounding
+const int kMaximumDifference = 2;
+
+const GLfloat kBlitVertices[] = {
+  -1.0f, -1.0f, 0.0f,
+  1.0f, -1.0f, 0.0f,
+  1.0f, 1.0f, 0.0f,
+
+  -1.0f, -1.0f, 0.0f,
+  -1.0f, 1.0f, 0.0f,
+  1.0f, 1.0f, 0.0f
+};
+
+const GLfloat kBlitTexCoords[] = {
+  0.0f, 0.0f,
+  1.0f, 0.0f,
+  1.0f, 1.0f,
+
+  0.0f, 0.0f,
+  0.0f, 1.0f,
+  1.0f, 1.0f
+};
+
+QString ReadFile(const QString& filename)
+{
+  QFile file(filename);
+
+  if (!file.open(QFile::ReadOnly)) {
+    return QString();
+  }
+
+  return QString::fromUtf8(file.readAll());
+}
+
+// Distance from the center of pixel (x, y) to the circle's edge, positive on the side being stroked
+float DistanceFromShape(int x, int y, bool inner)
+{
+  float from_center = QVector2D(x + 0.5f - kShapeCenter, y + 0.5f - kShapeCenter).length();
+
+  return inner ? (kShapeRadius - from_center) : (from_center - kShapeRadius);
+}
+
+}
+
+StrokeTest::StrokeTest() :
+  vert_vbo_(QOpenGLBuffer::VertexBuffer),
+  frag_vbo_(QOpenGLBuffer::VertexBuffer),
+  reference_program_(nullptr),
+  program_(nullptr),
+  input_texture_(0)
+{
+}
+
+void StrokeTest::initTestCase()
+{
+  // Match the version OpenGLRenderer asks for
+  QSurfaceFormat format;
+  format.setVersion(3, 2);
+  format.setProfile(QSurfaceFormat::CoreProfile);
+
+  context_.setFormat(format);
+  surface_.setFormat(format);
+  surface_.create();
+
+  if (!context_.create() || !context_.makeCurrent(&surface_)) {
+    QSKIP("No OpenGL context available");
+  }
+
+  QOpenGLExtraFunctions* f = context_.extraFunctions();
+
+  // Opaque white circle on a transparent background
+  QVector<uchar> shape(kSize * kSize * 4, 0);
+
+  for (int y=0; y<kSize; y++) {
+    for (int x=0; x<kSize; x++) {
+      if (DistanceFromShape(x, y, true) >= 0.0f) {
+        memset(shape.data() + (y * kSize + x) * 4, 255, 4);
+      }
+    }
+  }
+
+  f->glGenTextures(1, &input_texture_);
+  f->glBindTexture(GL_TEXTURE_2D, input_texture_);
+  f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kSize, kSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, shape.constData());
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  f->glBindTexture(GL_TEXTURE_2D, 0);
+
+  vao_.create();
+  vao_.bind();
+
+  vert_vbo_.create();
+  vert_vbo_.bind();
+  vert_vbo_.allocate(kBlitVertices, sizeof(kBlitVertices));
+  vert_vbo_.release();
+
+  frag_vbo_.create();
+  frag_vbo_.bind();
+  frag_vbo_.allocate(kBlitTexCoords, sizeof(kBlitTexCoords));
+  frag_vbo_.release();
+
+  reference_program_ = CreateProgram(QStringLiteral(OLIVE_TEST_DIR "/render/stroke_reference.frag"));
+  program_ = CreateProgram(QStringLiteral(OLIVE_SHADER_DIR "/stroke.frag"));
+
+  QVERIFY(reference_program_);
+  QVERIFY(program_);
+}
+
+void StrokeTest::cleanupTestCase()
+{
+  if (!QOpenGLContext::currentContext()) {
+    return;
+  }
+
+  delete reference_program_;
+  delete program_;
+
+  frag_vbo_.destroy();
+  vert_vbo_.destroy();
+  vao_.destroy();
+
+  context_.functions()->glDeleteTextures(1, &input_texture_);
+
+  context_.doneCurrent();
+}
+
+void StrokeTest::CompareToReference_data()
+{
+  QTest::addColumn<float>("radius");
+  QTest::addColumn<bool>("inner");
+
+  QTest::newRow("outer 4") << 4.0f << false;
+  QTest::newRow("outer 12") << 12.0f << false;
+  QTest::newRow("outer 30") << 30.0f << false;
+  QTest::newRow("outer 50") << 50.0f << false;
+  QTest::newRow("inner 4") << 4.0f << true;
+  QTest::newRow("inner 12") << 12.0f << true;
+  QTest::newRow("inner 30") << 30.0f << true;
+}
+
+void StrokeTest::CompareToReference()
+{
+  QFETCH(float, radius);
+  QFETCH(bool, inner);
+
+  QVector<uchar> reference = RenderReference(radius, inner);
+  QVector<uchar> result = RenderDistanceField(radius, inner);
+
+  int edge_pixels = 0;
+
+  for (int y=0; y<kSize; y++) {
+    for (int x=0; x<kSize; x++) {
+      float from_edge = qAbs(DistanceFromShape(x, y, inner) - radius);
+
+      if (from_edge <= kEdgeTolerance) {
+        // The edge is allowed to move a little
+        edge_pixels++;
+        continue;
+      }
+
+      for (int c=0; c<4; c++) {
+        int i = (y * kSize + x) * 4 + c;
+        int difference = qAbs(int(reference.at(i)) - int(result.at(i)));
+
+        if (difference > kMaximumDifference) {
+          QFAIL(qPrintable(QStringLiteral("Pixel %1, %2 is %3 px from the stroke's edge and differs by %4")
+                           .arg(QString::number(x), QString::number(y),
+                                QString::number(from_edge), QString::number(difference))));
+        }
+      }
+    }
+  }
+
+  // Make sure the edge band didn't swallow the whole image
+  QVERIFY(edge_pixels < kSize * kSize / 4);
+}
+
+QOpenGLShaderProgram *StrokeTest::CreateProgram(const QString &frag_filename)
+{
+  // Same preamble as OpenGLRenderer::CreateNativeShader()
+  QString preamble = QStringLiteral("#version 150\n\n");
+
+  QOpenGLShaderProgram* program = new QOpenGLShaderProgram();
+
+  if (!program->addShaderFromSourceCode(QOpenGLShader::Vertex, preamble + ReadFile(QStringLiteral(OLIVE_SHADER_DIR "/default.vert")))
+      || !program->addShaderFromSourceCode(QOpenGLShader::Fragment, preamble + ReadFile(frag_filename))
+      || !program->link()) {
+    delete program;
+    return nullptr;
+  }
+
+  return program;
+}
+
+void StrokeTest::SetUniforms(QOpenGLShaderProgram *program, float radius, bool inner)
+{
+  program->bind();
+
+  program->setUniformValue("ove_mvpmat", QMatrix4x4());
+  program->setUniformValue("tex_in", 0);
+  program->setUniformValue("seed_in", 1);
+  program->setUniformValue("color_in", 1.0f, 0.0f, 0.0f, 1.0f);
+  program->setUniformValue("radius_in", radius);
+  program->setUniformValue("opacity_in", 1.0f);
+  program->setUniformValue("inner_in", int(inner));
+  program->setUniformValue("resolution_in", QVector2D(kSize, kSize));
+
+  // As StrokeFilterNode::Value() calculates it
+  program->setUniformValue("jump_steps_in", qMax(1, qCeil(std::log2(2.0 * (qCeil(radius) + 1)))));
+}
+
+QVector<uchar> StrokeTest::RenderReference(float radius, bool inner)
+{
+  QOpenGLExtraFunctions* f = context_.extraFunctions();
+
+  SetUniforms(reference_program_, radius, inner);
+  reference_program_->setUniformValue("ove_iteration", 0);
+
+  QOpenGLFramebufferObject destination(kSize, kSize);
+  destination.bind();
+
+  f->glActiveTexture(GL_TEXTURE0);
+  f->glBindTexture(GL_TEXTURE_2D, input_texture_);
+
+  Draw(reference_program_);
+
+  QVector<uchar> pixels = ReadPixels();
+
+  destination.release();
+  reference_program_->release();
+
+  return pixels;
+}
+
+QVector<uchar> StrokeTest::RenderDistanceField(float radius, bool inner)
+{
+  QOpenGLExtraFunctions* f = context_.extraFunctions();
+
+  SetUniforms(program_, radius, inner);
+
+  int jump_steps = qMax(1, qCeil(std::log2(2.0 * (qCeil(radius) + 1))));
+  int iterations = jump_steps + 3;
+
+  // Ping-pong between half float textures like OpenGLRenderer::Blit() does for the real node
+  QOpenGLFramebufferObject ping(kSize, kSize, QOpenGLFramebufferObject::NoAttachment, GL_TEXTURE_2D, GL_RGBA16F);
+  QOpenGLFramebufferObject pong(kSize, kSize, QOpenGLFramebufferObject::NoAttachment, GL_TEXTURE_2D, GL_RGBA16F);
+  QOpenGLFramebufferObject destination(kSize, kSize);
+
+  QOpenGLFramebufferObject* output = &ping;
+  QOpenGLFramebufferObject* input = &pong;
+
+  f->glActiveTexture(GL_TEXTURE0);
+  f->glBindTexture(GL_TEXTURE_2D, input_texture_);
+
+  for (int i=0; i<iterations; i++) {
+    program_->setUniformValue("ove_iteration", i);
+
+    QOpenGLFramebufferObject* target = (i == iterations - 1) ? &destination : output;
+    target->bind();
+
+    f->glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    f->glClear(GL_COLOR_BUFFER_BIT);
+
+    // The seeds are read from the last iteration, without any filtering
+    f->glActiveTexture(GL_TEXTURE1);
+    f->glBindTexture(GL_TEXTURE_2D, (i == 0) ? input_texture_ : input->texture());
+    if (i > 0) {
+      f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+
+    Draw(program_);
+
+    std::swap(output, input);
+  }
+
+  QVector<uchar> pixels = ReadPixels();
+
+  destination.release();
+  program_->release();
+
+  f->glActiveTexture(GL_TEXTURE1);
+  f->glBindTexture(GL_TEXTURE_2D, 0);
+  f->glActiveTexture(GL_TEXTURE0);
+
+  return pixels;
+}
+
+QVector<uchar> StrokeTest::ReadPixels()
+{
+  QVector<uchar> pixels(kSize * kSize * 4);
+
+  context_.functions()->glReadPixels(0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+  return pixels;
+}
+
+void StrokeTest::Draw(QOpenGLShaderProgram *program)
+{
+  QOpenGLExtraFunctions* f = context_.extraFunctions();
+
+  f->glViewport(0, 0, kSize, kSize);
+
+  vao_.bind();
+
+  vert_vbo_.bind();
+  program->enableAttributeArray("a_position");
+  program->setAttributeBuffer("a_position", GL_FLOAT, 0, 3);
+  vert_vbo_.release();
+
+  frag_vbo_.bind();
+  program->enableAttributeArray("a_texcoord");
+  program->setAttributeBuffer("a_texcoord", GL_FLOAT, 0, 2);
+  frag_vbo_.release();
+
+  f->glDrawArrays(GL_TRIANGLES, 0, 6);
+
+  vao_.release();
+}
+
+}
+
+QTEST_MAIN(olive::StrokeTest)
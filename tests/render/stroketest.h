@@ -0,0 +1,88 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2020 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef STROKETEST_H
+#define STROKETEST_H
+
+#include <QOffscreenSurface>
+#include <QOpenGLBuffer>
+#include <QOpenGLContext>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QObject>
+
+namespace olive {
+
+/**
+ * @brief Checks that stroke.frag still looks like the box-sampled stroke it replaced
+ *
+ * Both shaders stroke the same circle and are expected to agree everywhere except within a couple
+ * of pixels of the stroke's edge, where the old shader's sparse sampling and the new shader's
+ * anti-aliasing place it slightly differently.
+ */
+class StrokeTest : public QObject
+{
+  Q_OBJECT
+public:
+  StrokeTest();
+
+private slots:
+  void initTestCase();
+
+  void cleanupTestCase();
+
+  void CompareToReference_data();
+
+  void CompareToReference();
+
+private:
+  QOpenGLShaderProgram* CreateProgram(const QString& frag_filename);
+
+  void SetUniforms(QOpenGLShaderProgram* program, float radius, bool inner);
+
+  QVector<uchar> RenderReference(float radius, bool inner);
+
+  QVector<uchar> RenderDistanceField(float radius, bool inner);
+
+  QVector<uchar> ReadPixels();
+
+  void Draw(QOpenGLShaderProgram* program);
+
+  QOffscreenSurface surface_;
+
+  QOpenGLContext context_;
+
+  QOpenGLVertexArrayObject vao_;
+
+  QOpenGLBuffer vert_vbo_;
+
+  QOpenGLBuffer frag_vbo_;
+
+  QOpenGLShaderProgram* reference_program_;
+
+  QOpenGLShaderProgram* program_;
+
+  unsigned int input_texture_;
+
+};
+
+}
+
+#endif // STROKETEST_H